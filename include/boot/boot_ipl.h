@@ -1,26 +1,38 @@
-#ifndef BOOT_IPL_H
-#define BOOT_IPL_H
-
-#include "mm/paging.h"
-#include "multiboot.h"
-#include "types.h"
-
-/**
- * @brief Initialize paging and enable it.
- * @param mb_info   Multiboot information structure.
- * @param mb_magic  Multiboot magic value.
- */
-void boot_ipl (multiboot_info_t* multiboot_info_structure, uint32_t multiboot_magic) 
-    __attribute__ ((section(".boot.text")));
-
-/**
- * @brief Map a single 4KB page.
- * @param pd     Page directory.
- * @param vaddr  Virtual address.
- * @param paddr  Physical address.
- * @param flags  Page flags.
- */
-uint8_t boot_map_page(page_directory_t* d, void* vaddr, void* paddr, uint32_t page_flags) 
-    __attribute__ ((section(".boot.text")));
-
+#ifndef BOOT_IPL_H
+#define BOOT_IPL_H
+
+#include "mm/paging.h"
+#include "multiboot.h"
+#include "types.h"
+
+#define BOOT_PAGE_TABLES_COUNT 8  /* enough for the identity map, the higher half kernel and the screen */
+
+/**
+ * @brief Initialize paging and enable it.
+ * @param mb_info   Multiboot information structure.
+ * @param mb_magic  Multiboot magic value.
+ */
+void boot_ipl (multiboot_info_t* multiboot_info_structure, uint32_t multiboot_magic) 
+    __attribute__ ((section(".boot.text")));
+
+/**
+ * @brief Map a single 4KB page.
+ * @param pd     Page directory.
+ * @param vaddr  Virtual address.
+ * @param paddr  Physical address.
+ * @param flags  Page flags.
+ */
+uint8_t boot_map_page(page_directory_t* d, void* vaddr, void* paddr, uint32_t page_flags) 
+    __attribute__ ((section(".boot.text")));
+
+/**
+ * @brief Map a single 4MB page (CR4.PSE must be set before paging is enabled).
+ * @param pd     Page directory.
+ * @param vaddr  Virtual address, 4MB aligned.
+ * @param paddr  Physical address, 4MB aligned.
+ * @param flags  Page flags.
+ */
+uint8_t boot_map_large_page(page_directory_t* d, void* vaddr, void* paddr, uint32_t page_flags) 
+    __attribute__ ((section(".boot.text")));
+
 #endif // BOOT_IPL_H
\ No newline at end of file
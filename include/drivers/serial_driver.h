@@ -0,0 +1,16 @@
+#ifndef SERIAL_DRIVER_H
+#define SERIAL_DRIVER_H
+
+#include "types.h"
+
+#define SERIAL_COM1_PORT     0x3F8
+#define SERIAL_BAUD_DIVISOR  1      /* 115200 / divisor baud */
+#define SERIAL_MAX_STRING_PRINT 256
+
+void serial_init();  // initialize COM1 (8N1, polled, no interrupts)
+uint8_t serial_is_ready();  // 1 if COM1 was found and initialized
+void serial_write_char(char c);  // write a character, blocks until the transmitter is free
+void serial_write_string(const char * string);  // write a string, '\n' is sent as "\r\n"
+void serial_printf(const char * format, ...);  // printf to COM1
+
+#endif // SERIAL_DRIVER_H
\ No newline at end of file
@@ -1,7 +1,7 @@
-#ifndef EARLY_PRINT_H
-#define EARLY_PRINT_H
-
-void early_print_init();
-void early_printf(const char* format, ...);
-
-#endif // EARLY_PRINT_H
+#ifndef EARLY_PRINT_H
+#define EARLY_PRINT_H
+
+void early_print_init();
+void early_printf(const char* format, ...);
+
+#endif // EARLY_PRINT_H
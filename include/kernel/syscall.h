@@ -1,21 +1,26 @@
-#ifndef SYSCALL_H
-#define SYSCALL_H
-
-#include "kernel/description_tables.h"
-#include "types.h"
-
-#define PPROT_READ     0x1
-#define PPROT_WRITE    0x2
-#define PPROT_EXEC     0x4
-#define PPROT_USER     0x8
-#define PPROT_KER      0x10
-
-#define SYSC_MMAP     0x5a
-#define SYSC_MUNMAP   0x5b
-
-void syscall_init();
-uint32_t syscall_handler(cpu_status_t * regs);
-void * mmap(void *addr, size_t length, uint32_t flags);
-void * sys_mmap(void *addr, size_t length, uint32_t flags);
-
-#endif // SYSCALL_H
+#ifndef SYSCALL_H
+#define SYSCALL_H
+
+#include "kernel/description_tables.h"
+#include "types.h"
+
+#define PPROT_READ     0x1
+#define PPROT_WRITE    0x2
+#define PPROT_EXEC     0x4
+#define PPROT_USER     0x8
+#define PPROT_KER      0x10
+
+#define SYSC_MMAP     0x5a
+#define SYSC_MUNMAP   0x5b
+#define SYSC_MSYNC    0x5c
+
+void syscall_init();
+uint32_t syscall_handler(cpu_status_t * regs);
+void * mmap(void *addr, size_t length, uint32_t flags);  // reserve a zero filled range, addr NULL - pick one, NULL on failure
+uint32_t munmap(void *addr, size_t length);  // release a range reserved by mmap, 0 on success
+uint32_t msync(void *addr, size_t length);  // write the dirty pages of the mapped files in a range back, 0 on success
+void * sys_mmap(void *addr, size_t length, uint32_t flags);
+uint32_t sys_munmap(void *addr, size_t length);
+uint32_t sys_msync(void *addr, size_t length);
+
+#endif // SYSCALL_H
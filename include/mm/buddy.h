@@ -0,0 +1,43 @@
+#ifndef BUDDY_H
+#define BUDDY_H
+
+#include "multiboot.h"
+#include "types.h"
+
+#define BUDDY_MAX_ORDER    10   /* largest block is 2^10 frames (4 MiB) */
+#define BUDDY_ORDERS       (BUDDY_MAX_ORDER + 1)
+#define BUDDY_POOL_FRAMES  4096 /* frames the buddy allocator takes from the pmm at boot (16 MiB) */
+
+#define BUDDY_BLOCK_FREE  1  /* the frame starts a free block */
+#define BUDDY_BLOCK_USED  2  /* the frame starts an allocated block */
+
+/*
+ * The buddy allocator owns one physically contiguous pool, aligned to the
+ * largest block size. Its frames are marked used in the pmm, so
+ * pmm_alloc_frame never hands them out. Frames of the pool that are not
+ * available RAM are never seeded and act as permanently allocated.
+ * The blocks are described by a side array (the frames are not mapped).
+ */
+typedef struct buddy_block_struct {
+    struct buddy_block_struct * previous;  // previous free block of the same order
+    struct buddy_block_struct * next;      // next free block of the same order
+    uint8_t order;   // order of the block starting at this frame
+    uint8_t flags;   // BUDDY_BLOCK_FREE | BUDDY_BLOCK_USED, 0 if the frame is inside a block
+} buddy_block_t;
+
+typedef struct buddy_stats_struct {
+    uint32_t total_frames;               // frames seeded into the allocator
+    uint32_t free_frames;
+    uint32_t free_blocks[BUDDY_ORDERS];  // free blocks of each order
+    int32_t largest_free_order;          // -1 if nothing is free
+} buddy_stats_t;
+
+void buddy_init(multiboot_info_t * mbi);  // seed the pool from the multiboot map, must be called before paging_init (mbi is a lower half address)
+void * buddy_alloc(uint32_t order);  // physical address of a 2^order frames block aligned to its size, NULL if none
+void buddy_free(void * paddr, uint32_t order);  // free a block returned by buddy_alloc with the same order
+uint32_t buddy_order_for_size(size_t size);  // smallest order whose block holds size bytes
+void buddy_get_stats(buddy_stats_t * stats);
+uint32_t buddy_unusable_index(uint32_t order);  // percent of free memory that can not serve a block of this order
+void print_buddy_status();
+
+#endif // BUDDY_H
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef HIGHMEM_H
+#define HIGHMEM_H
+
+#include "multiboot.h"
+#include "types.h"
+
+#define HIGHMEM_FIRST_BLOCK  0x400   /* 4 MiB block number of the 4 GiB line */
+#define HIGHMEM_END_BLOCK    0x4000  /* 64 GiB, the reach of PSE-36 on every cpu that has it */
+#define HIGHMEM_MAX_BLOCKS   (HIGHMEM_END_BLOCK - HIGHMEM_FIRST_BLOCK)
+#define HIGHMEM_WINDOW       0xFF000000  /* the 4 MiB kernel window high blocks are mapped through */
+
+/*
+ * RAM above 4 GiB can not be reached by the 32 bit page tables, but a PG_4MB
+ * directory entry carries physical address bits 32-35 in bits 13-16 on cpus
+ * with PSE-36. High memory is handed out in whole 4 MiB blocks, identified by
+ * their block number (physical address >> 22), and is only ever touched
+ * through the single kernel window.
+ *
+ * The PMM does not manage these frames: there is no page_t for them and they
+ * can not be mapped by a 4 KiB entry, so they never back the page cache or the
+ * memory of a process. Their only user is swap, as the RAM tier of the swap
+ * area (pages are copied in and out through the window).
+ *
+ * This is a stopgap, not PAE. A PAE mode (64 bit entries, a third level, a
+ * PMM with frames above 4 GiB) would let that RAM back anything; it is not
+ * implemented yet.
+ */
+
+void highmem_init(multiboot_info_t * mbi);  // collect the 4 MiB blocks of RAM above 4 GiB, must be called before paging_init (mbi is a lower half address)
+uint32_t highmem_total_blocks();
+uint32_t highmem_free_blocks();
+uint32_t highmem_alloc_block();  // a free block number, 0 if there is none
+void highmem_free_block(uint32_t block);
+void * highmem_map_block(uint32_t block);  // map block at HIGHMEM_WINDOW, interrupts must stay off while the window is used
+
+#endif // HIGHMEM_H
\ No newline at end of file
@@ -1,29 +1,108 @@
-#ifndef KHEAP_H
-#define KHEAP_H
-
-#include "types.h"
-
-#define KHEAP_INITIAL_SIZE  (0x1000000) /* Note: must be the same as the difference defined in the linker */
-
-#define CHUNK_NOT_IN_US 0
-#define CHUNK_IN_US 1
-
-typedef struct heap_node_struct {
-    uint8_t is_used; // 0 - not used, 1 - used
-    size_t size; // the size of the user data (not including the header)
-    struct heap_node_struct * previous;
-    struct heap_node_struct * next;
-} heap_chunk_t;
-
-typedef struct heap_struct {
-    heap_chunk_t * heap_first;
-} heap_t;
-
-uint32_t alloc_unfreable_phys(size_t size, uint8_t align); // allocate a non freable type of memory, 0 - not align, 1 - align
-
-void print_heap_status(); // pring the heap status
-void heap_init();  // initiate the heap maneger 
-void* kalloc(size_t size); // allocate memory
-void kfree(void * chunk); // free a chunk
-
+#ifndef KHEAP_H
+#define KHEAP_H
+
+#include "types.h"
+
+#define KHEAP_MAX_SIZE        (0x1000000) /* Note: must be the same as the difference defined in the linker */
+#define KHEAP_INITIAL_COMMIT  (0x10000)   /* memory backed by frames at boot, the rest of the range is only reserved */
+#define KHEAP_EXPAND_MIN      (0x10000)   /* the heap grows by at least this much at a time */
+#define KHEAP_TRIM_THRESHOLD  (0x40000)   /* a free tail bigger than this is given back to the pmm */
+#define KHEAP_VMALLOC_THRESHOLD (0x10000) /* kalloc requests of this size or more are served by vmalloc */
+#define KHEAP_MAX_ALIGN       (0x400000)  /* the biggest alignment kalloc_aligned accepts */
+
+#define HEAP_ALIGNMENT       8   /* every user pointer returned by kalloc is aligned to this */
+#define HEAP_MIN_CHUNK_SIZE  16  /* smallest user data size, big enough for the free list links and the footer */
+#define HEAP_BINS_COUNT      32  /* bin i holds free chunks of size [2^i, 2^(i+1)) */
+
+#define CHUNK_NOT_IN_US  0
+#define CHUNK_IN_US      1
+#define CHUNK_PREV_IN_US 2  /* the chunk right before this one (in address order) is used */
+#define CHUNK_CALLSITE_SHIFT 8
+#define CHUNK_CALLSITE_MASK  (0xFF << CHUNK_CALLSITE_SHIFT)  /* callsite table index + 1 of a used chunk, 0 - untracked */
+
+#define KHEAP_CALLSITES_MAX  255  /* a callsite index must fit in CHUNK_CALLSITE_MASK */
+
+#define KHEAP_MAGAZINE_MAX_SIZE  256  /* requests up to this size are rounded to a power of two so their chunks can be cached */
+#define KHEAP_MAGAZINE_CLASSES   5    /* chunk sizes 16, 32, 64, 128 and 256 */
+#define KHEAP_MAGAZINE_ROUNDS    8    /* chunks cached per size class */
+
+/*
+ * Layout of a chunk in memory:
+ *   | size | flags | user data ...................................... |
+ * While the chunk is free, the start of the user data holds the bin links and
+ * its last 4 bytes hold a copy of the size (boundary tag), so the next chunk can
+ * find it in O(1) when coalescing. Used chunks carry no footer.
+ */
+typedef struct heap_node_struct {
+    size_t size;      // the size of the user data (not including the header)
+    uint32_t flags;   // CHUNK_IN_US | CHUNK_PREV_IN_US | callsite index
+    /* valid only while the chunk is free (overlaps the user data) */
+    struct heap_node_struct * previous;  // previous free chunk in the same bin
+    struct heap_node_struct * next;      // next free chunk in the same bin
+} heap_chunk_t;
+
+#define HEAP_CHUNK_HEADER_SIZE (sizeof(size_t) + sizeof(uint32_t))
+
+typedef struct heap_struct {
+    heap_chunk_t * heap_first;              // first chunk in address order
+    heap_chunk_t * heap_end;                // the end fence (a zero sized used chunk)
+    heap_chunk_t * bins[HEAP_BINS_COUNT];   // segregated free lists
+    uint32_t bins_bitmap;                   // bit i is set <=> bins[i] is not empty
+} heap_t;
+
+/*
+ * A magazine is a small per-thread stack of chunks its owner freed, one per
+ * size class. kalloc and kfree try the current thread's magazine first with
+ * interrupts off, the heap lock is only taken when it is empty or full.
+ * Cached chunks stay used as far as the heap is concerned, but the counters
+ * see them as released (they are in no bin either), and a chunk taken from a
+ * magazine is counted as a new allocation of its new caller.
+ */
+typedef struct kheap_magazine_struct {
+    void * rounds[KHEAP_MAGAZINE_CLASSES][KHEAP_MAGAZINE_ROUNDS];
+    uint8_t counts[KHEAP_MAGAZINE_CLASSES];
+    uint32_t hits;    // allocations served from the magazine
+    uint32_t misses;  // small allocations that had to take the heap lock
+} kheap_magazine_t;
+
+/* counters of the heap itself, kalloc requests served by vmalloc are not included */
+typedef struct kheap_stats_struct {
+    size_t bytes_in_use;        // user data of the used chunks
+    size_t peak_bytes_in_use;   // highest bytes_in_use seen since boot
+    uint32_t chunks_in_use;
+    uint32_t total_allocs;      // since boot
+    uint32_t total_frees;       // since boot
+    uint32_t free_chunks;
+    size_t free_bytes;          // user data of the free chunks
+    size_t largest_free;        // the biggest free chunk, the largest request served without growing the heap
+    uint32_t fragmentation;     // percent of the free bytes not in the largest free chunk
+    uint32_t used_histogram[HEAP_BINS_COUNT];  // used chunks of size [2^i, 2^(i+1))
+    uint32_t free_histogram[HEAP_BINS_COUNT];  // free chunks of size [2^i, 2^(i+1))
+} kheap_stats_t;
+
+typedef struct kheap_callsite_struct {
+    void * caller;          // return address of the kalloc call
+    uint32_t allocs;        // allocations made since tracking was enabled
+    uint32_t live_chunks;   // allocations not freed yet
+    size_t live_bytes;
+} kheap_callsite_t;
+
+void print_heap_status(); // pring the heap status
+void heap_init();  // initiate the heap maneger
+uint8_t kheap_expand(size_t size); // commit at least size more bytes at the heap end, 0 - success, 1 - out of memory or heap range
+size_t kheap_committed_size(); // the amount of heap memory currently backed by frames
+void* kalloc(size_t size); // allocate memory, large sizes go to vmalloc (the memory is not physically contiguous)
+void* kalloc_heap(size_t size); // allocate from the heap itself, never routed to vmalloc
+void* kalloc_aligned(size_t size, size_t align); // like kalloc, the memory is aligned to align (a power of two up to KHEAP_MAX_ALIGN)
+void* kalloc_phys(size_t size, size_t align, uint32_t * phys); // physically contiguous memory of up to PAGE_SIZE, its physical address is stored in phys
+void kfree(void * chunk); // free a chunk from kalloc, kalloc_heap, kalloc_aligned or kalloc_phys
+
+void kheap_magazine_flush(kheap_magazine_t * magazine); // give every cached chunk back to the heap bins (dying threads, exact free counters), NULL is ignored
+kheap_magazine_t * kheap_current_magazine(); // the magazine of the running thread, NULL before the scheduler exists
+
+void kheap_get_stats(kheap_stats_t * stats); // snapshot the heap counters
+void kheap_set_callsite_tracking(uint8_t enable); // attribute heap allocations to their caller, 1 - on, 0 - off
+uint32_t kheap_get_callsites(kheap_callsite_t * callsites, uint32_t max); // copy up to max tracked callsites, returns how many were copied
+void kheap_dump_stats(); // write the counters and the tracked callsites to the serial port
+
 #endif // KHEAP_H
\ No newline at end of file
@@ -0,0 +1,47 @@
+#ifndef PAGE_H
+#define PAGE_H
+
+#include "types.h"
+
+/* the descriptors live in their own kernel window, 16 bytes for each of up to 2^20 frames */
+#define PAGE_DB_VIRT_START  0xC8000000
+#define PAGE_DB_VIRT_SIZE   0x01000000  /* 16 MiB */
+
+#define PAGE_DIRTY   (1 << 0)  /* written through a mapping since it was last clean */
+#define PAGE_PINNED  (1 << 1)  /* never moved or reclaimed (kernel image, low memory) */
+#define PAGE_ZEROED  (1 << 2)  /* the frame is known to hold only zeros */
+#define PAGE_SWAPPABLE (1 << 3)  /* an anonymous page on the swap LRU (see swap.c) */
+#define PAGE_FILE    (1 << 4)  /* caches a page of a mapped file (see flatfs_mmap.c), shared rather than copied on write */
+
+/*
+ * Descriptor of a physical frame, indexed by frame number.
+ * The pmm sets refcount to 1 on allocation and pmm_free_frame drops one
+ * reference, the frame goes back to the free bitmap when it reaches 0.
+ */
+typedef struct page_struct {
+    uint16_t refcount;                  // users of the frame, 0 - free
+    uint16_t flags;                     // PAGE_DIRTY | PAGE_PINNED | PAGE_ZEROED
+    struct page_struct * lru_previous;  // links for a page_list_t (LRU, zeroed pool, ...)
+    struct page_struct * lru_next;
+    void * owner;                       // the address space (or object) the frame belongs to, NULL if none
+} page_t;
+
+typedef struct page_list_struct {
+    page_t * head;
+    page_t * tail;
+    uint32_t count;
+} page_list_t;
+
+void page_db_init(uint32_t frames_count);  // build the descriptors of frames [0, frames_count), must be called after paging_init
+uint32_t page_db_frames_count();  // 0 until page_db_init
+page_t * page_from_frame(uint32_t paddr);  // NULL if the frame has no descriptor
+uint32_t page_to_frame(page_t * page);
+
+void page_get(uint32_t paddr);  // take another reference to an allocated frame
+uint16_t page_put(uint32_t paddr);  // drop a reference, returns the references left (0 for frames without a descriptor)
+
+void page_list_add_tail(page_list_t * list, page_t * page);
+void page_list_remove(page_list_t * list, page_t * page);
+page_t * page_list_pop_head(page_list_t * list);  // NULL if the list is empty
+
+#endif // PAGE_H
\ No newline at end of file
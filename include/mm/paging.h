@@ -1,71 +1,125 @@
-#ifndef PAGING_H
-#define PAGING_H
-
-#include "kernel/description_tables.h"
-#include "types.h"
-
-//
-// Page directory/table entry flags (x86 32-bit)
-//
-#define PG_PRESENT      (1 << 0)
-#define PG_WRITABLE     (1 << 1)
-#define PG_USER         (1 << 2)
-#define PG_WRITE_THRU   (1 << 3)
-#define PG_NO_CACHE     (1 << 4)
-#define PG_ACCESSED     (1 << 5)
-#define PG_DIRTY        (1 << 6)
-#define PG_4MB          (1 << 7)   // huge page
-#define PG_GLOBAL       (1 << 8)
-
-#define PAGE_SIZE 0x1000
-
-#define PAGING_ENTRIES_SIZE 1024
-
-typedef struct page_entry_struct {
-    uint32_t present    : 1;  // Page present in memory
-    uint32_t rw         : 1;  // Read-only if clear, readwrite if set
-    uint32_t user       : 1;  // Supervisor level only if clear
-    uint32_t accessed   : 1;  // Has the page been accessed since last refresh?
-    uint32_t dirty      : 1;  // Has the page been written to since last refresh?
-    uint32_t unused     : 7;  // Amalgamation of unused and reserved bits
-    uint32_t frame      : 20; // Frame address (shifted right 12 bits)
-} page_entry_t;
-
-typedef struct __attribute__ ((aligned (0x1000))) page_table_struct {
-    page_entry_t entries[PAGING_ENTRIES_SIZE];
-} page_table_t;
-
-typedef struct __attribute__ ((aligned (0x1000))) page_directory_struct {
-    /**
-       Array of pointers to page-tables.
-    **/
-    page_table_t *tables[PAGING_ENTRIES_SIZE];
-    /**
-       Array of pointers to the pagetables above, but gives their *physical*
-       location, for loading into the CR3 register.
-    **/
-    uint32_t tables_physical[PAGING_ENTRIES_SIZE];
-
-    /**
-       The physical address of physical_addr. This comes into play
-       when we get our kernel heap allocated and the directory
-       may be in a different location in virtual memory.
-    **/
-    uint32_t physical_addr;
-} page_directory_t;
-
-//
-// Initialization
-//
-void paging_init();
-void switch_page_directory(page_directory_t * dir);  // switch to the new page directory
-uint32_t page_fault_handler(cpu_status_t* regs);  // the page fault handler
-uint32_t general_protection_fault_handler(cpu_status_t* regs); // the general protection fault handler
-
-void paging_map_page(void* vaddr, void* paddr, uint32_t page_flags);
-void paging_unmap_page(void* vaddr);
-void* paging_get_mapping(void* vaddr);
-
-page_directory_t * paging_get_current_directory();
-
+#ifndef PAGING_H
+#define PAGING_H
+
+#include "kernel/description_tables.h"
+#include "types.h"
+
+//
+// Page directory/table entry flags (x86 32-bit)
+//
+#define PG_PRESENT      (1 << 0)
+#define PG_WRITABLE     (1 << 1)
+#define PG_USER         (1 << 2)
+#define PG_WRITE_THRU   (1 << 3)
+#define PG_NO_CACHE     (1 << 4)
+#define PG_ACCESSED     (1 << 5)
+#define PG_DIRTY        (1 << 6)
+#define PG_4MB          (1 << 7)   // huge page
+#define PG_GLOBAL       (1 << 8)
+#define PG_COW          (1 << 9)   // available bit, a read only page shared by paging_clone_directory
+#define PG_SWAPPED      (1 << 10)  // available bit of a not present entry, the frame field holds a swap slot
+
+#define PAGE_SIZE 0x1000
+#define LARGE_PAGE_SIZE 0x400000  /* a PG_4MB directory entry maps this much, needs CR4.PSE */
+
+#define CR0_WP  (1 << 16) /* write protect, read only pages fault in ring 0 too */
+#define CR4_PSE (1 << 4)  /* 4 MiB pages */
+
+#define PAGING_ENTRIES_SIZE 1024
+
+/*
+ * The directory maps itself at this slot, so the tables of the current
+ * directory show up as pages in a 4 MiB window: table i is at
+ * PAGING_TABLES_WINDOW + i * PAGE_SIZE. Page tables are plain pmm frames.
+ */
+#define PAGING_RECURSIVE_SLOT  1022
+#define PAGING_TABLES_WINDOW   0xFF800000  /* PAGING_RECURSIVE_SLOT << 22 */
+
+/* a kernel page for short lived views of frames that are not mapped (tables of other directories, COW copies) */
+#define PAGING_TEMP_PAGE       0xFF7FF000
+
+typedef struct page_entry_struct {
+    uint32_t present    : 1;  // Page present in memory
+    uint32_t rw         : 1;  // Read-only if clear, readwrite if set
+    uint32_t user       : 1;  // Supervisor level only if clear
+    uint32_t write_thru : 1;  // Write through caching
+    uint32_t no_cache   : 1;  // Caching disabled
+    uint32_t accessed   : 1;  // Has the page been accessed since last refresh?
+    uint32_t dirty      : 1;  // Has the page been written to since last refresh?
+    uint32_t pat        : 1;  // Page attribute table index
+    uint32_t global     : 1;  // Kept in the TLB across cr3 reloads (needs CR4.PGE)
+    uint32_t available  : 3;  // Free for the kernel to use
+    uint32_t frame      : 20; // Frame address (shifted right 12 bits)
+} page_entry_t;
+
+typedef struct __attribute__ ((aligned (0x1000))) page_table_struct {
+    page_entry_t entries[PAGING_ENTRIES_SIZE];
+} page_table_t;
+
+typedef struct __attribute__ ((aligned (0x1000))) page_directory_struct {
+    /**
+       Array of pointers to page-tables.
+    **/
+    page_table_t *tables[PAGING_ENTRIES_SIZE];
+    /**
+       Array of pointers to the pagetables above, but gives their *physical*
+       location, for loading into the CR3 register.
+    **/
+    uint32_t tables_physical[PAGING_ENTRIES_SIZE];
+
+    /**
+       The physical address of physical_addr. This comes into play
+       when we get our kernel heap allocated and the directory
+       may be in a different location in virtual memory.
+    **/
+    uint32_t physical_addr;
+
+    /* number of present entries in every table, a table is given back to the pmm when it drops to 0 */
+    uint16_t tables_entries[PAGING_ENTRIES_SIZE];
+
+    struct vm_region_struct * regions;  // ranges reserved by mmap, sorted by address
+
+    struct page_directory_struct * next;  // list of every address space, kernel half changes are copied through it
+} page_directory_t;
+
+//
+// Initialization
+//
+void paging_init();
+void switch_page_directory(page_directory_t * dir);  // switch to the new page directory
+void paging_init_directory(page_directory_t * dir);  // make dir an empty address space sharing the kernel half, dir must be page aligned
+void paging_unlink_directory(page_directory_t * dir);  // stop copying kernel half changes into dir, for directories that are dropped without paging_destroy_directory
+page_directory_t * paging_clone_directory();  // copy the current address space, user pages are shared copy-on-write, NULL if no memory
+void paging_destroy_directory(page_directory_t * dir);  // release a directory made by paging_clone_directory, it must not be the current one
+uint32_t page_fault_handler(cpu_status_t* regs);  // the page fault handler
+uint32_t general_protection_fault_handler(cpu_status_t* regs); // the general protection fault handler
+void paging_fault_io_begin();  // inside a fault handler: turn interrupts on for drive I/O, if the faulting code had them on
+void paging_fault_io_end();  // back to interrupts off, re-check anything the I/O may have raced with
+
+void paging_map_page(void* vaddr, void* paddr, uint32_t page_flags);
+uint8_t paging_map_large_page(void* vaddr, void* paddr, uint32_t page_flags);  // map 4 MiB (both addresses 4 MiB aligned), 0 - success, 1 - no PSE or the slot has a table
+uint8_t paging_map_large_page_high(void* vaddr, uint32_t block, uint32_t page_flags);  // map the 4 MiB block number block (physical >> 22, may be above 4 GiB through PSE-36), 0 - success
+void paging_unmap_large_page(void* vaddr);
+uint8_t paging_is_large_page(void* vaddr);  // 1 if vaddr is inside a 4 MiB page
+uint8_t paging_large_pages_enabled();  // 1 if CR4.PSE is on
+void paging_unmap_page(void* vaddr);
+void paging_unmap_range(void* vaddr, size_t size);  // unmap every page of [vaddr, vaddr + size) with a single TLB range flush
+void* paging_get_mapping(void* vaddr);
+void paging_zero_frame(uint32_t paddr);  // fill a frame with zeros through PAGING_TEMP_PAGE, it does not need to be mapped
+void paging_read_frame(uint32_t paddr, void * dst);  // copy a frame out through PAGING_TEMP_PAGE
+void paging_write_frame(uint32_t paddr, const void * src);  // copy PAGE_SIZE bytes into a frame through PAGING_TEMP_PAGE
+
+//
+// Swap support, dir may be any directory (its tables are reached through PAGING_TEMP_PAGE)
+//
+uint8_t paging_test_and_clear_accessed(page_directory_t * dir, void * vaddr);  // 1 if the page was accessed since the last call
+uint8_t paging_test_and_clear_dirty(page_directory_t * dir, void * vaddr);  // 1 if the page was written since the last call
+uint8_t paging_swap_out_entry(page_directory_t * dir, void * vaddr, uint32_t slot);  // replace a present entry by a swap entry, 0 - success, 1 - not present
+void paging_swap_in_entry(page_directory_t * dir, void * vaddr, uint32_t paddr);  // replace a swap entry by a present mapping of paddr
+uint8_t paging_get_swap_slot(page_directory_t * dir, void * vaddr, uint32_t * slot);  // 1 if the entry of vaddr is swapped out
+uint8_t paging_maps_frame(page_directory_t * dir, void * vaddr, uint32_t paddr);  // 1 if vaddr is present and mapped to the frame of paddr
+
+page_directory_t * paging_get_current_directory();
+page_directory_t * paging_get_kernel_directory();
+
 #endif // PAGING_H
\ No newline at end of file
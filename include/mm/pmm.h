@@ -1,16 +1,58 @@
-#ifndef PMEM_H
-#define PMEM_H
-
-#include "types.h"
-
-#define FRAME_SIZE 0x1000
-#define PMM_BIT_FIELD_ARR_SIZE ((0xFFFFFFFF / FRAME_SIZE) / 32)  /* 32 bits in an uint32 */
-
-void pmm_init();
-
-void* pmm_alloc_frame_addr(void * paddr);  /* paddr - the address to try to allocate from the page, should be frame aligned */
-void* pmm_alloc_frames_addr(void * paddr, size_t count); /* paddr - the address to try to allocate from the page, should be frame aligned */
-void* pmm_alloc_frame();
-void pmm_free_frame(void* paddr);
-
+#ifndef PMEM_H
+#define PMEM_H
+
+#include "types.h"
+
+#define FRAME_SIZE 0x1000
+#define PMM_FRAMES_COUNT 0x100000  /* frames in the 4 GiB physical address space, the most the pmm can manage */
+#define PMM_BIT_FIELD_ARR_SIZE (PMM_FRAMES_COUNT / 32)  /* 32 bits in an uint32 */
+
+/*
+ * The frame bitmap (1 bit per frame, 1 - used) is indexed by a tree of summary
+ * bitmaps, a bit in a summary level is set if the word it covers in the level
+ * below still has a free bit:
+ *   level 1 - 1 bit per bit_field word    (1024 words)
+ *   level 2 - 1 bit per level 1 word      (32 words)
+ *   top     - 1 bit per level 2 word      (1 word)
+ */
+#define PMM_SUMMARY_L1_SIZE (PMM_BIT_FIELD_ARR_SIZE / 32)
+#define PMM_SUMMARY_L2_SIZE (PMM_SUMMARY_L1_SIZE / 32)
+
+#define PMM_ZEROED_POOL_TARGET 256  /* frames the idle process keeps zeroed ahead of time (1 MiB) */
+
+/* physical memory is split into zones, an allocation from a zone falls back to the zones below it */
+#define PMM_ZONE_LOW      0  /* below 1 MiB, real mode reachable */
+#define PMM_ZONE_DMA      1  /* below 16 MiB, ISA dma reachable */
+#define PMM_ZONE_NORMAL   2  /* everything else */
+#define PMM_ZONES_COUNT   3
+
+#define PMM_ZONE_LOW_END  0x00100000
+#define PMM_ZONE_DMA_END  0x01000000
+
+typedef struct pmm_zone_struct {
+    const char * name;
+    uint32_t start_frame;   // first frame index of the zone
+    uint32_t end_frame;     // one past the last frame index of the zone
+    uint32_t cursor;        // frame index the next search in the zone starts from
+    uint32_t free_frames;
+} pmm_zone_t;
+
+void pmm_init(uint32_t usable_frames);  /* manage frames up to usable_frames (0 - the whole 4 GiB), everything starts reserved */
+void pmm_reserve_range(uint32_t paddr, size_t size);  /* mark the frames touching [paddr, paddr + size) used, for boot time memory map handling */
+void pmm_release_range(uint32_t paddr, size_t size);  /* mark the whole frames inside [paddr, paddr + size) free, for boot time memory map handling */
+uint32_t pmm_get_frames_count();  /* frames managed by the pmm */
+const pmm_zone_t * pmm_get_zone(uint32_t zone);  /* NULL if zone is not a PMM_ZONE_* */
+
+void* pmm_alloc_frame_addr(void * paddr);  /* paddr - the address to try to allocate from the page, should be frame aligned */
+void* pmm_alloc_frames_addr(void * paddr, size_t count); /* paddr - the address to try to allocate from the page, should be frame aligned */
+void* pmm_alloc_frame();  /* a frame from the normal zone, falls back to the dma and low zones */
+void* pmm_alloc_frame_zone(uint32_t zone);  /* a frame from zone or a zone below it, NULL if no memory */
+void pmm_free_frame(void* paddr);
+uint32_t pmm_get_free_frames_count();
+uint8_t pmm_is_frame_used(uint32_t paddr);
+
+void* pmm_alloc_zeroed_frame();  /* a frame filled with zeros, from the zeroed pool when it has one, NULL if no memory */
+uint8_t pmm_zeroed_pool_refill();  /* zero one more frame into the pool, 0 - the pool is full or there is no memory */
+uint32_t pmm_get_zeroed_frames_count();
+
 #endif // PMEM_H
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef SLAB_H
+#define SLAB_H
+
+#include "multitasking/lock.h"
+#include "types.h"
+
+/* slabs are mapped into their own kernel virtual window, out of the way of the heap */
+#define KMEM_CACHE_VIRT_START       0xD0000000
+#define KMEM_CACHE_VIRT_SIZE        0x04000000  /* 64 MiB */
+
+#define KMEM_CACHE_ALIGN            8
+#define KMEM_CACHE_MIN_OBJECTS      8    /* a slab is grown (in powers of two pages) until this many objects fit */
+#define KMEM_CACHE_MAX_SLAB_PAGES   16
+#define KMEM_CACHE_MAX_EMPTY_SLABS  1    /* empty slabs kept around before pages go back to the pmm */
+
+/*
+ * A slab is a run of slab_pages pages aligned to its own size, so the slab of
+ * an object is found by masking the object address. The slab header lives at
+ * the start of the first page and the objects follow it.
+ */
+typedef struct kmem_slab_struct {
+    struct kmem_cache_struct * cache;   // the cache owning this slab
+    struct kmem_slab_struct * previous; // previous slab in the same cache list
+    struct kmem_slab_struct * next;     // next slab in the same cache list
+    void * free_list;                   // first free object, linked through the objects first word
+    uint32_t in_use;                    // number of allocated objects
+} kmem_slab_t;
+
+typedef struct kmem_cache_struct {
+    const char * name;
+    size_t object_size;             // object size rounded up to align
+    size_t align;                   // object alignment (power of two, at least KMEM_CACHE_ALIGN)
+    uint32_t objects_offset;        // offset of the first object from the slab start
+    uint32_t slab_pages;            // pages per slab (power of two)
+    uint32_t objects_per_slab;
+    kmem_slab_t * slabs_partial;    // slabs with both used and free objects
+    kmem_slab_t * slabs_full;       // slabs without free objects
+    kmem_slab_t * slabs_empty;      // slabs without used objects
+    uint32_t empty_count;           // number of slabs in slabs_empty
+    uint32_t objects_in_use;
+    lock_t lock;                    // taken with interrupts off, caches are used from fault handlers and preemptible threads alike
+    struct kmem_cache_struct * next; // list of all caches
+} kmem_cache_t;
+
+void kmem_cache_init();  // initiate the slab allocator, must be called after paging_init
+kmem_cache_t * kmem_cache_create(const char * name, size_t object_size); // NULL if object_size is too big or no memory
+kmem_cache_t * kmem_cache_create_aligned(const char * name, size_t object_size, size_t align); // like kmem_cache_create, align is a power of two up to PAGE_SIZE
+void kmem_cache_destroy(kmem_cache_t * cache);  // release a cache, all its objects must be freed
+void * kmem_cache_alloc(kmem_cache_t * cache);  // allocate an object, NULL if no memory
+void kmem_cache_free(kmem_cache_t * cache, void * object);  // free an object allocated from cache
+void print_kmem_cache_status();  // print the status of every cache
+
+#endif // SLAB_H
\ No newline at end of file
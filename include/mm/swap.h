@@ -0,0 +1,46 @@
+#ifndef SWAP_H
+#define SWAP_H
+
+#include "drivers/ata_driver.h"
+#include "mm/page.h"
+#include "mm/paging.h"
+#include "types.h"
+
+#define SWAP_SECTORS_PER_SLOT  (PAGE_SIZE / ATA_SECTOR_SIZE)  /* a slot holds one page */
+#define SWAP_MAX_SLOTS         0x4000  /* 64 MiB of swap at most */
+#define SWAP_RECLAIM_BATCH     16      /* pages pushed out when the pmm runs dry */
+#define SWAP_SLOTS_PER_BLOCK   (LARGE_PAGE_SIZE / PAGE_SIZE)  /* ram slots in a 4 MiB high memory block */
+#define SWAP_SLOT_LIMIT        0x100000  /* a slot number has to fit in the frame field of an entry */
+
+/*
+ * Anonymous pages (pages committed by the mmap fault handler) are kept on a
+ * LRU list. When the pmm runs out of frames the list is scanned like a clock:
+ * a page whose accessed bit is set gets a second chance (the bit is cleared
+ * and the page goes to the tail), the first one without it is written to a
+ * free slot of the swap area and its entry keeps the slot number until the
+ * next fault reads it back.
+ *
+ * The swap area has two tiers. RAM slots live in the high memory blocks
+ * (RAM above 4 GiB the page tables can not map as normal pages), they are
+ * tried first and cost a copy through the high memory window. Disk slots are
+ * a run of raw sectors at the end of the drive, swap_init shrinks the drive
+ * size so the file system never sees them. Swap I/O runs with interrupts off,
+ * so a single bounce buffer is enough.
+ */
+
+uint32_t swap_init(ata_drive_t * drive, uint32_t max_slots);  // take every high memory block and up to max_slots disk slots off the end of drive (may be NULL), returns the slots count
+uint8_t swap_enabled();  // 1 once swap_init found room for at least one slot
+uint32_t swap_ram_slots();  // slots backed by high memory
+
+void swap_track_page(uint32_t paddr, uint32_t vaddr);  // put an anonymous page of the current address space on the LRU
+void swap_untrack_page(page_t * page);  // take a freed page off the LRU
+
+uint32_t swap_reclaim(uint32_t count);  // push up to count pages out to the swap area, returns how many frames were freed
+uint8_t swap_handle_fault(uint32_t addr, uint32_t err_code);  // read a swapped out page of the current address space back, 1 - handled
+
+void swap_dup_slot(uint32_t slot);  // another entry refers to slot
+void swap_put_slot(uint32_t slot);  // an entry referring to slot is gone, the slot is free once nobody refers to it
+uint32_t swap_used_slots();
+uint32_t swap_used_ram_slots();
+
+#endif // SWAP_H
\ No newline at end of file
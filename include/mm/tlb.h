@@ -0,0 +1,19 @@
+#ifndef TLB_H
+#define TLB_H
+
+#include "types.h"
+
+#define TLB_FLUSH_FULL_THRESHOLD 32  /* a range flush of more pages than this drops the whole TLB instead */
+
+#define CR4_PGE (1 << 7)  /* global pages */
+
+void tlb_init();  // turn on global pages (CR4.PGE) if the cpu has them
+uint8_t tlb_global_pages_enabled();  // 1 if CR4.PGE is on
+void tlb_set_global_pages(uint8_t enable);  // turn CR4.PGE on or off, flushes the whole TLB (benchmarks only)
+
+void tlb_flush_page(void * vaddr);  // drop the translation of a single page
+void tlb_flush_range(void * vaddr, size_t size);  // drop the translations of [vaddr, vaddr + size)
+void tlb_flush_all();  // drop every non global translation (cr3 reload)
+void tlb_flush_global();  // drop every translation, global ones included
+
+#endif // TLB_H
\ No newline at end of file
@@ -0,0 +1,37 @@
+#ifndef VM_REGION_H
+#define VM_REGION_H
+
+#include "mm/paging.h"
+#include "types.h"
+
+#define VM_MMAP_BASE  0x40000000  /* mmap(NULL, ...) places regions in [VM_MMAP_BASE, VM_MMAP_END) */
+#define VM_MMAP_END   0xC0000000  /* the kernel half is never handed out */
+
+/*
+ * A reserved range of an address space. Nothing is mapped when a region is
+ * created, pages are committed by the page fault handler on first touch:
+ * a read maps the shared zero page read only, a write maps a fresh zeroed frame.
+ * A region backed by a file (flatfs_mmap) maps the file's cached pages instead.
+ */
+typedef struct vm_region_struct {
+    uint32_t start;       // page aligned
+    uint32_t end;         // page aligned, exclusive
+    uint32_t page_flags;  // PG_WRITABLE | PG_USER of the committed pages
+    struct flatfs_mapping_struct * file;  // the mapped file, NULL for anonymous memory
+    uint32_t file_page;   // page of the file mapped at start
+    struct vm_region_struct * next;  // next region by address
+} vm_region_t;
+
+void vm_region_init();  // must be called after kmem_cache_init
+void * vm_region_reserve(page_directory_t * dir, void * addr, size_t length, uint32_t page_flags);  // addr NULL - pick a free range, NULL on overlap or no memory
+void * vm_region_reserve_file(page_directory_t * dir, void * addr, size_t length, uint32_t page_flags,
+                              struct flatfs_mapping_struct * file, uint32_t file_page);  // like vm_region_reserve, the region takes over a reference to file
+uint8_t vm_region_release(page_directory_t * dir, void * addr, size_t length);  // unmap and forget [addr, addr + length), dirty file pages are written back first, 0 - success, 1 - bad range
+uint8_t vm_region_sync(page_directory_t * dir, void * addr, size_t length);  // write the dirty file pages of [addr, addr + length) back, dir must be the current directory, 0 - success, 1 - bad range or I/O error
+uint8_t vm_region_clone(page_directory_t * dst, page_directory_t * src);  // copy the regions of src to an empty dst, 0 - success, 1 - no memory
+void vm_region_destroy_all(page_directory_t * dir);  // forget every region of dir without touching its mappings
+vm_region_t * vm_region_find(page_directory_t * dir, uint32_t addr);  // the region holding addr, NULL if none
+uint8_t vm_region_handle_fault(uint32_t addr, uint32_t err_code);  // commit the page of a fault in the current address space, 1 - handled
+uint32_t vm_region_zero_page();  // physical address of the shared zero page
+
+#endif // VM_REGION_H
\ No newline at end of file
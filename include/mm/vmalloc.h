@@ -0,0 +1,32 @@
+#ifndef VMALLOC_H
+#define VMALLOC_H
+
+#include "types.h"
+
+/* large kernel buffers are mapped into their own window, right after the slab window */
+#define VMALLOC_VIRT_START  0xD4000000
+#define VMALLOC_VIRT_SIZE   0x08000000  /* 128 MiB */
+
+#define VMALLOC_GUARD  (1 << 0)  /* leave an unmapped page on both sides of the area, overruns fault instead of corrupting */
+
+/*
+ * A vmalloc area is a page aligned range of the window backed by frames that
+ * don't need to be physically contiguous. The guard pages (if any) are part of
+ * [start, end) but are never mapped.
+ */
+typedef struct vmalloc_area_struct {
+    uint32_t start;   // first page of the area, guard included
+    uint32_t end;     // exclusive, guard included
+    uint32_t flags;   // VMALLOC_GUARD
+    struct vmalloc_area_struct * next;  // next area by address
+} vmalloc_area_t;
+
+void vmalloc_init();  // must be called after kmem_cache_init
+uint8_t vmalloc_ready();  // 1 once vmalloc_init was called
+void * vmalloc(size_t size);  // page aligned buffer of at least size bytes, NULL if no memory or window space
+void * vmalloc_flags(size_t size, uint32_t flags);  // like vmalloc, flags - VMALLOC_GUARD
+void vfree(void * addr);  // free a buffer returned by vmalloc, NULL is ignored
+uint8_t is_vmalloc_addr(void * addr);  // 1 if addr is inside the vmalloc window
+size_t vmalloc_used_size();  // bytes currently backed by frames
+
+#endif // VMALLOC_H
\ No newline at end of file
@@ -1,10 +1,12 @@
-#ifndef MULTIBOOT_INFO_H
-#define MULTIBOOT_INFO_H
-
-#include "multiboot.h"
-#include "types.h"
-
-void multiboot_info_print(uint32_t magic, const multiboot_info_t *mbi);
-void multiboot_info_invalidate_unavailable_memory(multiboot_info_t *mbi);  // invalidate (by setting as used in pmm) unavailable memory 
-
+#ifndef MULTIBOOT_INFO_H
+#define MULTIBOOT_INFO_H
+
+#include "multiboot.h"
+#include "types.h"
+
+void multiboot_info_print(uint32_t magic, const multiboot_info_t *mbi);
+void multiboot_info_release_available_memory(multiboot_info_t *mbi);  // release the available RAM regions into the pmm
+void multiboot_info_invalidate_unavailable_memory(multiboot_info_t *mbi);  // invalidate (by setting as used in pmm) unavailable memory 
+uint32_t multiboot_info_frames_count(multiboot_info_t *mbi);  // frames up to the end of the highest available region (below 4 GiB)
+
 #endif // MULTIBOOT_INFO_H
\ No newline at end of file
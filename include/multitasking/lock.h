@@ -1,17 +1,26 @@
-#ifndef LOCK_H
-#define LOCK_H
-
-typedef enum {
-    LOCK_FREE,
-    LOCK_LOCKED
-} lock_state_e;
-
-typedef struct lock_struct {
-    volatile lock_state_e state;
-} lock_t;
-
-void lock_init(lock_t * lock);
-void lock_acquire(lock_t * lock); /* acuqire the lock if free, else spinlock */
-void lock_release(lock_t * lock); /* release the lock */
-
+#ifndef LOCK_H
+#define LOCK_H
+
+#include "types.h"
+
+typedef enum {
+    LOCK_FREE,
+    LOCK_LOCKED
+} lock_state_e;
+
+typedef struct lock_struct {
+    volatile lock_state_e state;
+} lock_t;
+
+void lock_init(lock_t * lock);
+void lock_acquire(lock_t * lock); /* acuqire the lock if free, else spinlock */
+void lock_release(lock_t * lock); /* release the lock */
+
+#define EFLAGS_IF (1 << 9)  /* interrupts enabled */
+
+uint32_t irq_save(); /* disable interrupts, returns the previous eflags for irq_restore */
+void irq_restore(uint32_t eflags); /* enable interrupts again if they were enabled at irq_save */
+uint32_t lock_acquire_irqsave(lock_t * lock); /* disable interrupts then acquire, for locks also taken from interrupt handlers */
+void lock_release_irqrestore(lock_t * lock, uint32_t eflags); /* release, then restore the eflags of lock_acquire_irqsave */
+
 #endif // LOCK_H
\ No newline at end of file
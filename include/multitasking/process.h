@@ -1,36 +1,52 @@
-#ifndef THREAD_H
-#define THREAD_H
-
-#include "kernel/tty.h"
-#include "kernel/description_tables.h"
-#include "types.h"
-
-typedef enum process_state_enum {
-    PROCESS_NEW,
-    PROCESS_READY,
-    PROCESS_RUNNING,
-    PROCESS_BLOCKED,
-    PROCESS_SLEEPING,
-    PROCESS_ZOMBIE
-} process_state_e;
-
-typedef enum process_type_enum {
-    PROCESS_IDLE,
-    PROCESS_KERNEL
-} process_type_e;
-
-typedef size_t pid_t;
-
-typedef struct process_sturct {
-    pid_t pid;
-    process_state_e status;
-    process_type_e type;
-    uint32_t * esp;
-    struct process_sturct * next;
-} process_t;
-
-process_t * process_create(process_type_e type, void (*entry)(void), size_t stack_size);
-uint8_t process_announce(process_t * process);
-uint8_t process_set_current(process_t * process); /* the process must be annonced */
-
+#ifndef THREAD_H
+#define THREAD_H
+
+#include "kernel/tty.h"
+#include "kernel/description_tables.h"
+#include "mm/paging.h"
+#include "mm/kheap.h"
+#include "types.h"
+
+typedef enum process_state_enum {
+    PROCESS_NEW,
+    PROCESS_READY,
+    PROCESS_RUNNING,
+    PROCESS_BLOCKED,
+    PROCESS_SLEEPING,
+    PROCESS_ZOMBIE
+} process_state_e;
+
+typedef enum process_type_enum {
+    PROCESS_IDLE,
+    PROCESS_KERNEL
+} process_type_e;
+
+typedef size_t pid_t;
+
+#define PROCESS_PRIORITIES        32  /* 0 is the most urgent, a ready process of a better priority always runs first */
+#define PROCESS_PRIORITY_DEFAULT  16
+
+typedef struct process_sturct {
+    pid_t pid;
+    process_state_e status;
+    process_type_e type;
+    uint8_t priority;       /* the current (MLFQ) priority, it sinks below base_priority while the thread uses whole slices */
+    uint8_t base_priority;  /* PROCESS_PRIORITY_DEFAULT on creation, change it through scheduler_set_priority */
+    uint32_t slice_ticks;   /* timer ticks left of the current slice, 0 - a new slice on the next switch in */
+    uint32_t wake_tick;     /* the sleep queue tick a PROCESS_SLEEPING thread wakes on */
+    uint32_t * esp;         /* the cpu_status_t frame saved by isr_common_stub while the thread is not running */
+    void * stack;  /* the kernel stack allocation (lowest address) */
+    page_directory_t * page_directory;  /* the address space, kernel threads share the kernel directory */
+    kheap_magazine_t heap_magazine;  /* small chunks this thread freed, reused by its next allocations without the heap lock */
+    struct process_sturct * next;      /* links of the run queue (or other process list) the process is in */
+    struct process_sturct * previous;
+} process_t;
+
+void process_init(); /* initiate the process object cache, must be called before process_create */
+process_t * process_create(process_type_e type, void (*entry)(void), size_t stack_size);
+process_t * process_clone(void (*entry)(void), size_t stack_size); /* like process_create, but entry runs in a copy-on-write copy of the current address space */
+void process_destroy(process_t * process); /* free the process, its stack and its address space, the process must not be running or queued */
+uint8_t process_announce(process_t * process);
+uint8_t process_set_current(process_t * process); /* the process must be annonced */
+
 #endif // THREAD_H
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef RUN_QUEUE_H
+#define RUN_QUEUE_H
+
+#include "multitasking/process.h"
+#include "types.h"
+
+/* a FIFO of processes linked through their own next/previous fields, a process is in at most one list */
+typedef struct process_list_struct {
+    process_t * head;
+    process_t * tail;
+    uint32_t count;
+} process_list_t;
+
+/*
+ * One list per priority and a bitmap with bit p set <=> lists[p] is not
+ * empty, so every operation is O(1): the best priority is the lowest set
+ * bit (bsf) and the lists are doubly linked with a tail pointer.
+ */
+typedef struct run_queue_struct {
+    process_list_t lists[PROCESS_PRIORITIES];
+    uint32_t bitmap;
+    uint32_t count;
+} run_queue_t;
+
+void process_list_push(process_list_t * list, process_t * process);  // add at the tail
+process_t * process_list_pop(process_list_t * list);  // take the head, NULL if the list is empty
+void process_list_remove(process_list_t * list, process_t * process);  // unlink a process from anywhere in the list
+
+void run_queue_init(run_queue_t * queue);
+void run_queue_push(run_queue_t * queue, process_t * process);  // add at the tail of the process priority
+process_t * run_queue_pop(run_queue_t * queue);  // take the first process of the best priority, NULL if the queue is empty
+void run_queue_remove(run_queue_t * queue, process_t * process);  // unlink a queued process
+uint8_t run_queue_best_priority(run_queue_t * queue);  // the best queued priority, PROCESS_PRIORITIES if the queue is empty
+
+#endif // RUN_QUEUE_H
\ No newline at end of file
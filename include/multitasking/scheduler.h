@@ -1,16 +1,36 @@
-#ifndef SCHEDULER_H
-#define SCHEDULER_H
-
-#include "kernel/description_tables.h"
-#include "multitasking/process.h"
-
-extern void scheduler_context_switch_asm(uint32_t ** current_stack_pointer, uint32_t * next_stack); /* calls sti!!!! */
-extern void scheduler_start_thread_asm(uint32_t * thread_stack);
-
-void scheduler_init();
-void scheduler_set_on();
-void scheduler_add_process_to_ready_queue(process_t * process);
-process_t * scheduler_get_next_process();
-void scheduler_schedule();
-
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "kernel/description_tables.h"
+#include "multitasking/process.h"
+
+#define SCHEDULER_DEFAULT_QUANTUM_MS  10    /* slice of a thread at its base priority */
+#define SCHEDULER_MLFQ_LEVELS         4     /* a cpu bound thread sinks at most this many levels - 1 below its base, its slice doubles per level */
+#define SCHEDULER_BOOST_MS            1000  /* every thread goes back to its base priority this often */
+#define SCHEDULER_YIELD_VECTOR        0x81  /* software interrupt a thread raises to give the cpu up */
+
+/*
+ * Threads only switch on the way out of an interrupt: the timer (or a thread
+ * giving the cpu up through SCHEDULER_YIELD_VECTOR) sets need_resched and
+ * isr_common_stub irets into the cpu_status_t frame saved on the next
+ * thread's stack. A thread's esp points at that frame while it is not running.
+ */
+
+void scheduler_init();
+void scheduler_set_on();
+void scheduler_set_quantum_ms(uint32_t ms);  /* the base slice, rounded down to timer ticks (at least one) */
+uint32_t scheduler_get_quantum_ms();
+void scheduler_add_process_to_ready_queue(process_t * process);  /* queued at the tail of its priority */
+void scheduler_set_priority(process_t * process, uint8_t priority);  /* 0 is the most urgent, clamped to PROCESS_PRIORITIES - 1 */
+process_t * scheduler_get_next_process();
+process_t * scheduler_get_current_process(); /* NULL before scheduler_init */
+void scheduler_schedule();  /* yield, the cpu goes to a ready thread of at least the same priority if there is one */
+cpu_status_t * scheduler_interrupt_return(cpu_status_t * frame);  /* called at the end of every interrupt, returns the frame to iret into */
+void scheduler_tick();  /* called by the timer on every tick, asks for a switch on an used up slice or a better ready thread */
+void scheduler_block();  /* the current thread stops running until scheduler_wake, blocking early boosts its priority */
+void scheduler_wake(process_t * process);  /* queue a blocked thread again, does nothing if it is not blocked */
+void scheduler_sleep();  /* like scheduler_block but PROCESS_SLEEPING, only the sleep queue wakes the thread (see sleep.h) */
+void scheduler_thread_exit();  /* the current thread ends, process_create makes every entry function return here */
+void scheduler_reap_zombies();  /* destroy the threads that exited, thread context only (the idle loop and process_create call it) */
+
 #endif // SCHEDULER_H
\ No newline at end of file
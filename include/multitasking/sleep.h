@@ -0,0 +1,26 @@
+#ifndef SLEEP_H
+#define SLEEP_H
+
+#include "types.h"
+
+/*
+ * Sleeping threads are kept in a hierarchical timer wheel indexed by the
+ * timer tick they wake on: a root level of 256 one-tick slots and 4 levels
+ * of 64 slots, each slot of a level spanning a whole turn of the level
+ * below. Every tick empties one root slot into the ready queue, when the
+ * root wraps the next slot of the levels above is spread down (cascaded).
+ * Adding a sleeper and waking it are O(1), a sleeping thread is in no run
+ * queue and costs no cpu.
+ */
+#define SLEEP_WHEEL_ROOT_BITS   8
+#define SLEEP_WHEEL_LEVEL_BITS  6
+#define SLEEP_WHEEL_LEVELS      4   /* 8 + 4 * 6 = 32 bits, every tick count fits */
+
+void sleep_queue_init();
+void sleep_queue_tick();  /* called by the timer on every tick, before the scheduler */
+uint32_t sleep_queue_count();  /* threads sleeping right now */
+
+void ksleep_ms(uint32_t ms);  /* sleep at least ms milliseconds */
+void ksleep_until(uint32_t deadline_ms);  /* sleep until timer_time_ms() reaches deadline_ms, the idle thread waits with hlt instead */
+
+#endif // SLEEP_H
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef SYNC_H
+#define SYNC_H
+
+#include "multitasking/run_queue.h"
+#include "types.h"
+
+/*
+ * Sleeping locks for thread context. A contended waiter is put in the wait
+ * queue of the object as PROCESS_BLOCKED and costs no cpu, the release hands
+ * the lock (or the semaphore unit) straight to the first waiter, so a woken
+ * thread never has to race for it again and waiters are served FIFO.
+ * Threads that can not block (the idle thread, kernel_main) spin instead.
+ */
+
+#define MUTEX_SPIN_MIN  64     /* pause iterations an adaptive mutex always tries before sleeping */
+#define MUTEX_SPIN_MAX  65536  /* the longest an adaptive mutex spins before sleeping */
+
+/* threads blocked on something, woken in FIFO order */
+typedef struct wait_queue_struct {
+    process_list_t waiters;
+} wait_queue_t;
+
+typedef enum mutex_mode_enum {
+    MUTEX_SLEEP,     // a contended lock blocks right away
+    MUTEX_ADAPTIVE,  // spin up to spin_budget pauses while the owner runs (on another cpu), the budget doubles when spinning paid off and halves when it did not
+    MUTEX_SPIN       // never block, the behaviour of lock_t (kept for comparisons)
+} mutex_mode_e;
+
+typedef struct mutex_struct {
+    volatile uint8_t locked;
+    mutex_mode_e mode;
+    process_t * owner;      // NULL while free (or taken before the scheduler exists)
+    wait_queue_t waiters;
+    uint32_t spin_budget;   // MUTEX_ADAPTIVE only
+    uint32_t contentions;   // lock calls that found the mutex taken
+    uint32_t sleeps;        // contended lock calls that ended up blocking
+} mutex_t;
+
+typedef struct semaphore_struct {
+    volatile int32_t count;
+    wait_queue_t waiters;
+} semaphore_t;
+
+typedef struct condvar_struct {
+    wait_queue_t waiters;
+} condvar_t;
+
+void wait_queue_init(wait_queue_t * queue);
+void wait_queue_wait(wait_queue_t * queue);  /* block the current thread, interrupts must stay off from the condition check to this call */
+process_t * wait_queue_wake_one(wait_queue_t * queue);  /* wake the oldest waiter, NULL if there is none */
+uint32_t wait_queue_wake_all(wait_queue_t * queue);  /* returns how many threads were woken */
+
+void mutex_init(mutex_t * mutex);  /* free, MUTEX_SLEEP */
+void mutex_set_mode(mutex_t * mutex, mutex_mode_e mode);
+void mutex_lock(mutex_t * mutex);  /* panics if the mutex is taken and interrupts are off, the owner could never run */
+uint8_t mutex_trylock(mutex_t * mutex);  /* 1 - taken, 0 - it is held by someone else */
+void mutex_unlock(mutex_t * mutex);  /* the first waiter becomes the owner */
+
+void semaphore_init(semaphore_t * semaphore, int32_t count);
+void semaphore_down(semaphore_t * semaphore);  /* take a unit, blocks while there is none */
+uint8_t semaphore_try_down(semaphore_t * semaphore);  /* 1 - took a unit, 0 - there was none */
+void semaphore_up(semaphore_t * semaphore);  /* give a unit back (to the first waiter if any), safe from interrupt handlers */
+
+void condvar_init(condvar_t * condvar);
+void condvar_wait(condvar_t * condvar, mutex_t * mutex);  /* unlock, block until signaled, lock again. The condition must be checked again in a loop */
+void condvar_signal(condvar_t * condvar);  /* wake one waiter */
+void condvar_broadcast(condvar_t * condvar);  /* wake every waiter */
+
+#endif // SYNC_H
\ No newline at end of file
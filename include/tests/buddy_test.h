@@ -0,0 +1,6 @@
+#ifndef BUDDY_TEST_H
+#define BUDDY_TEST_H
+
+void buddy_test_stress(void);
+
+#endif
\ No newline at end of file
@@ -1,7 +1,12 @@
-#ifndef HEAP_TEST_H
-#define HEAP_TEST_H
-
-void heap_test_basic(void);
-void heap_test_many_small_allocs(void);
-
+#ifndef HEAP_TEST_H
+#define HEAP_TEST_H
+
+void heap_test_basic(void);
+void heap_test_many_small_allocs(void);
+void heap_test_bench_churn(void);
+void heap_test_expand_and_trim(void);
+void heap_test_telemetry(void);
+void heap_test_aligned(void);
+void heap_test_bench_threads(void);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,9 @@
+#ifndef MMAP_TEST_H
+#define MMAP_TEST_H
+
+#include "drivers/flatfs/flatfs_driver.h"
+
+void mmap_test_demand_zero(void);
+void mmap_test_file_backed(ata_drive_t *drive);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,6 @@
+#ifndef PAGE_TEST_H
+#define PAGE_TEST_H
+
+void page_test_refcount(void);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,8 @@
+#ifndef PAGING_TEST_H
+#define PAGING_TEST_H
+
+void paging_test_bench_tlb(void);
+void paging_test_bench_large_pages(void);
+void paging_test_cow_clone(void);
+
+#endif
\ No newline at end of file
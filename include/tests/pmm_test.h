@@ -0,0 +1,9 @@
+#ifndef PMM_TEST_H
+#define PMM_TEST_H
+
+void pmm_test_bench_alloc_all(void);
+void pmm_test_bench_zeroed_pool(void);
+void pmm_test_ranges_and_zones(void);
+void pmm_test_idle_refill(void);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,9 @@
+#ifndef SCHEDULER_TEST_H
+#define SCHEDULER_TEST_H
+
+void scheduler_test_bench_run_queue(void);
+void scheduler_test_wakeup_latency(void);
+void scheduler_test_sleepers(void);
+void scheduler_test_bench_switch(void);
+
+#endif
\ No newline at end of file
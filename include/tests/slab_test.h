@@ -0,0 +1,6 @@
+#ifndef SLAB_TEST_H
+#define SLAB_TEST_H
+
+void slab_test_basic(void);
+
+#endif
\ No newline at end of file
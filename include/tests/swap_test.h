@@ -0,0 +1,9 @@
+#ifndef SWAP_TEST_H
+#define SWAP_TEST_H
+
+#include "drivers/ata_driver.h"
+
+void swap_test_roundtrip(void);
+void swap_test_fault_during_drive_io(ata_drive_t *drive);
+
+#endif
\ No newline at end of file
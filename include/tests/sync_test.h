@@ -0,0 +1,9 @@
+#ifndef SYNC_TEST_H
+#define SYNC_TEST_H
+
+#include "drivers/ata_driver.h"
+
+void sync_test_primitives(void);
+void sync_test_bench_contention(ata_drive_t *drive);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,6 @@
+#ifndef VMALLOC_TEST_H
+#define VMALLOC_TEST_H
+
+void vmalloc_test_basic(void);
+
+#endif
\ No newline at end of file
@@ -1,115 +1,162 @@
-#include "boot/boot_ipl.h"
-#include "boot/boot_utils.h"
-
-/*
- * 32-bit paging address layout:
- * | Page Directory Index (10) | Page Table Index (10) | Offset (12) |
- */
-#define PAGE_OFFSET(addr)   ((addr) & 0xFFF)
-#define PAGE_TABLE_INDEX(a) (((a) >> 12) & 0x3FF)
-#define PAGE_DIR_INDEX(a)   (((a) >> 22) & 0x3FF)
-#define PAGE_ALIGN(addr)   ((addr) & 0xFFFFF000)
-
-/*
- * Temporary paging structures used during early boot.
- * They live in .boot.bss so they are identity-mapped and zero-initialized.
- */
-__attribute__((aligned(0x1000), section(".boot.bss")))
-page_directory_t boot_page_directory;
-
-__attribute__((aligned(0x1000), section(".boot.bss")))
-page_table_t boot_page_tables[PAGING_ENTRIES_SIZE];
-
-/* Symbols provided by the linker */
-extern uint32_t __kernel_start;
-extern uint32_t __kernel_start_v;
-extern uint32_t __kernel_end_v_no_heap;
-extern uint32_t __kernel_end;
-
-/*
- * Maps a single 4KB page.
- * Assumes the page table already exists.
- */
-uint8_t boot_map_page(page_directory_t *pd, void *vaddr, void *paddr, uint32_t flags)
-{
-    uint32_t va = (uint32_t)vaddr;
-    uint32_t pa = (uint32_t)paddr;
-
-    page_table_t *pt = pd->tables[PAGE_DIR_INDEX(va)];
-    page_entry_t * entry = &pt->entries[PAGE_TABLE_INDEX(va)];
-
-    entry->present  = flags & PG_PRESENT;
-    entry->rw       = flags & PG_WRITABLE;
-    entry->user     = flags & PG_USER;
-    entry->accessed = flags & PG_ACCESSED;
-    entry->dirty    = flags & PG_DIRTY;
-    entry->unused   = (flags & 0xFE0) >> 5;
-    entry->frame    = pa >> 12;
-
-    return 0;
-}
-
-/*
- * Initial Paging Loader (IPL)
- * Sets up identity mapping + higher-half kernel mapping,
- * then enables paging.
- */
-void boot_ipl(multiboot_info_t *mb_info, uint32_t mb_magic) {
-    // At this point: virtual == physical
-    
-    /* Clear paging structures */
-    boot_memset(&boot_page_directory, 0, sizeof(page_directory_t));
-    boot_memset(boot_page_tables, 0,
-                sizeof(page_table_t) * PAGING_ENTRIES_SIZE);
-
-    /*
-     * Initialize page directory entries.
-     * Linear pointers are used before paging,
-     * physical addresses are written to PDEs.
-     */
-    boot_page_directory.physical_addr = (uint32_t)boot_page_directory.tables_physical;
-
-    for (size_t i = 0; i < PAGING_ENTRIES_SIZE; i++) {
-        boot_page_directory.tables[i] =  &boot_page_tables[i];
-
-        boot_page_directory.tables_physical[i] = 
-            (uint32_t)&boot_page_tables[i] | PG_PRESENT | PG_WRITABLE;
-    }
-
-    /*
-     * Identity map the lower memory region.
-     */
-    uint32_t kernel_end_phys = (uint32_t)&__kernel_end_v_no_heap - 0xC0000000;
-
-    for (uint32_t addr = 0; addr < kernel_end_phys; addr += PAGE_SIZE) 
-        boot_map_page(&boot_page_directory, (void *)addr, (void *)addr, PG_PRESENT | PG_WRITABLE);
-    
-
-    /*
-     * Map kernel into the higher half (0xC0000000+)
-     */
-    for (uint32_t vaddr = (uint32_t)&__kernel_start_v; vaddr < (uint32_t)&__kernel_end; vaddr += PAGE_SIZE) 
-            boot_map_page(&boot_page_directory, (void *)vaddr, (void *)(vaddr - 0xC0000000), PG_PRESENT | PG_WRITABLE);
-    
-    /*
-     * Map the last page to the text screen mmio
-     */
-    boot_map_page(&boot_page_directory, (void *)0xFFFFF000, (void *)0xB8000, PG_PRESENT | PG_WRITABLE);
-
-    uint16_t * t = (void *)0xFFFFF000;
-    (*t) = 0x076D;
-    uint16_t h = (*t);
-
-    /*
-     * Load page directory and enable paging
-     */
-    asm volatile("mov %0, %%cr3"
-                 :
-                 : "r"(boot_page_directory.physical_addr)
-                 : "memory");
-
-    uint32_t cr0;
-    asm volatile("mov %%cr0, %0" : "=r"(cr0));
-    cr0 |= 0x80000000;  /* PG bit */
-    asm volatile("mov %0, %%cr0" :: "r"(cr0));
-}
+#include "boot/boot_ipl.h"
+#include "boot/boot_utils.h"
+
+/*
+ * 32-bit paging address layout:
+ * | Page Directory Index (10) | Page Table Index (10) | Offset (12) |
+ */
+#define PAGE_OFFSET(addr)   ((addr) & 0xFFF)
+#define PAGE_TABLE_INDEX(a) (((a) >> 12) & 0x3FF)
+#define PAGE_DIR_INDEX(a)   (((a) >> 22) & 0x3FF)
+#define PAGE_ALIGN(addr)   ((addr) & 0xFFFFF000)
+
+/*
+ * Temporary paging structures used during early boot.
+ * They live in .boot.bss so they are identity-mapped and zero-initialized.
+ * Only the tables that are actually used are wired, they are taken from a
+ * small pool (the kernel directory adopts the higher half ones later).
+ */
+__attribute__((aligned(0x1000), section(".boot.bss")))
+page_directory_t boot_page_directory;
+
+__attribute__((aligned(0x1000), section(".boot.bss")))
+page_table_t boot_page_tables[BOOT_PAGE_TABLES_COUNT];
+
+__attribute__((section(".boot.bss")))
+uint32_t boot_page_tables_used;
+
+/* Symbols provided by the linker */
+extern uint32_t __kernel_start;
+extern uint32_t __kernel_start_v;
+extern uint32_t __kernel_end_v_no_heap;
+extern uint32_t __kernel_end;
+
+/*
+ * Maps a single 4KB page.
+ * Assumes the page table already exists.
+ */
+uint8_t boot_map_page(page_directory_t *pd, void *vaddr, void *paddr, uint32_t flags)
+{
+    uint32_t va = (uint32_t)vaddr;
+    uint32_t pa = (uint32_t)paddr;
+
+    page_table_t *pt = pd->tables[PAGE_DIR_INDEX(va)];
+
+    if (pt == NULL) {
+        /* out of boot tables, there is no way to report it this early */
+        if (boot_page_tables_used == BOOT_PAGE_TABLES_COUNT)
+            while (1) asm volatile("hlt");
+
+        pt = &boot_page_tables[boot_page_tables_used++];
+        pd->tables[PAGE_DIR_INDEX(va)] = pt;
+        pd->tables_physical[PAGE_DIR_INDEX(va)] = (uint32_t)pt | PG_PRESENT | PG_WRITABLE;
+    }
+
+    page_entry_t * entry = &pt->entries[PAGE_TABLE_INDEX(va)];
+
+    entry->present    = (flags & PG_PRESENT) != 0;
+    entry->rw         = (flags & PG_WRITABLE) != 0;
+    entry->user       = (flags & PG_USER) != 0;
+    entry->write_thru = (flags & PG_WRITE_THRU) != 0;
+    entry->no_cache   = (flags & PG_NO_CACHE) != 0;
+    entry->accessed   = (flags & PG_ACCESSED) != 0;
+    entry->dirty      = (flags & PG_DIRTY) != 0;
+    entry->global     = (flags & PG_GLOBAL) != 0;
+    entry->frame      = pa >> 12;
+
+    return 0;
+}
+
+/*
+ * Maps a single 4MB page, the directory slot must not have a table.
+ */
+uint8_t boot_map_large_page(page_directory_t *pd, void *vaddr, void *paddr, uint32_t flags)
+{
+    pd->tables_physical[PAGE_DIR_INDEX((uint32_t)vaddr)] = (uint32_t)paddr | flags | PG_4MB;
+
+    return 0;
+}
+
+/*
+ * Initial Paging Loader (IPL)
+ * Sets up identity mapping + higher-half kernel mapping,
+ * then enables paging.
+ */
+void boot_ipl(multiboot_info_t *mb_info, uint32_t mb_magic) {
+    // At this point: virtual == physical
+    
+    /* Clear paging structures */
+    boot_memset(&boot_page_directory, 0, sizeof(page_directory_t));
+    boot_memset(boot_page_tables, 0,
+                sizeof(page_table_t) * BOOT_PAGE_TABLES_COUNT);
+    boot_page_tables_used = 0;
+
+    /*
+     * Linear pointers are used before paging,
+     * physical addresses are written to PDEs.
+     * Tables are wired by boot_map_page on first use.
+     */
+    boot_page_directory.physical_addr = (uint32_t)boot_page_directory.tables_physical;
+
+    /*
+     * 4MB pages need CPUID.PSE, the kernel image is then covered by a
+     * couple of directory entries instead of hundreds of PTEs.
+     */
+    uint32_t eax = 1, ebx, ecx, edx;
+    asm volatile("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    uint8_t use_large_pages = (edx & (1 << 3)) != 0;
+
+    /*
+     * Identity map the lower memory region.
+     */
+    uint32_t kernel_end_phys = (uint32_t)&__kernel_end_v_no_heap - 0xC0000000;
+
+    if (use_large_pages) {
+        for (uint32_t addr = 0; addr < kernel_end_phys; addr += LARGE_PAGE_SIZE) 
+            boot_map_large_page(&boot_page_directory, (void *)addr, (void *)addr, PG_PRESENT | PG_WRITABLE);
+    } else {
+        for (uint32_t addr = 0; addr < kernel_end_phys; addr += PAGE_SIZE) 
+            boot_map_page(&boot_page_directory, (void *)addr, (void *)addr, PG_PRESENT | PG_WRITABLE);
+    }
+
+    /*
+     * Map kernel into the higher half (0xC0000000+),
+     * the large pages start at 0xC0000000 (physical 0), the heap is aligned past them by the linker
+     */
+    if (use_large_pages) {
+        for (uint32_t vaddr = 0xC0000000; vaddr < (uint32_t)&__kernel_end_v_no_heap; vaddr += LARGE_PAGE_SIZE) 
+            boot_map_large_page(&boot_page_directory, (void *)vaddr, (void *)(vaddr - 0xC0000000), PG_PRESENT | PG_WRITABLE);
+    } else {
+        for (uint32_t vaddr = (uint32_t)&__kernel_start_v; vaddr < (uint32_t)&__kernel_end_v_no_heap; vaddr += PAGE_SIZE) 
+            boot_map_page(&boot_page_directory, (void *)vaddr, (void *)(vaddr - 0xC0000000), PG_PRESENT | PG_WRITABLE);
+    }
+    
+    /*
+     * Map the last page to the text screen mmio
+     */
+    boot_map_page(&boot_page_directory, (void *)0xFFFFF000, (void *)0xB8000, PG_PRESENT | PG_WRITABLE);
+
+    uint16_t * t = (void *)0xFFFFF000;
+    (*t) = 0x076D;
+    uint16_t h = (*t);
+
+    if (use_large_pages) {
+        uint32_t cr4;
+        asm volatile("mov %%cr4, %0" : "=r"(cr4));
+        cr4 |= CR4_PSE;
+        asm volatile("mov %0, %%cr4" :: "r"(cr4));
+    }
+
+    /*
+     * Load page directory and enable paging
+     */
+    asm volatile("mov %0, %%cr3"
+                 :
+                 : "r"(boot_page_directory.physical_addr)
+                 : "memory");
+
+    uint32_t cr0;
+    asm volatile("mov %%cr0, %0" : "=r"(cr0));
+    cr0 |= 0x80000000;  /* PG bit */
+    asm volatile("mov %0, %%cr0" :: "r"(cr0));
+}
@@ -0,0 +1,254 @@
+#include "drivers/flatfs/flatfs_driver.h"
+#include "kernel/syscall.h"
+#include "mm/kheap.h"
+#include "mm/page.h"
+#include "mm/paging.h"
+#include "mm/pmm.h"
+#include "mm/vm_region.h"
+#include "utils/utils.h"
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
+#define FLATFS_PAGE_SECTORS (PAGE_SIZE / ATA_SECTOR_SIZE)
+
+static flatfs_mapping_t *find_mapping(flatfs_t *fs, uint32_t inode_idx);
+static uint32_t sector_lba(flatfs_mapping_t *mapping, uint32_t file_sector);
+static flatfs_err_t page_io(flatfs_mapping_t *mapping, uint32_t page_idx, uint8_t *data, uint8_t write);
+
+void *flatfs_mmap(flatfs_t *fs, const char *name, void *addr,
+                  uint32_t length, uint32_t offset, uint32_t flags) {
+    if (!fs || !name || length == 0 || offset & (PAGE_SIZE - 1))
+        return NULL;
+
+    uint32_t inode_idx;
+    if (flatfs_find(fs, name, &inode_idx) != FLATFS_OK)
+        return NULL;
+
+    flatfs_mapping_t *mapping = find_mapping(fs, inode_idx);
+    uint8_t created = 0;
+
+    if (!mapping) {
+        mapping = kalloc(sizeof(flatfs_mapping_t));
+        if (!mapping)
+            return NULL;
+
+        memset(mapping, 0, sizeof(flatfs_mapping_t));
+        mapping->fs = fs;
+        mapping->inode_idx = inode_idx;
+
+        /* every byte of the file has to live in an allocated block, the fault handler never allocates */
+        if (flatfs_get_inode_by_index(fs, inode_idx, &mapping->inode) != FLATFS_OK ||
+            mapping->inode.size == 0 ||
+            mapping->inode.size > mapping->inode.block_count * FLATFS_BLOCK_SIZE(&fs->sb)) {
+            kfree(mapping);
+            return NULL;
+        }
+
+        mapping->pages_count = FLATFS_DIV_ROUND_UP(mapping->inode.size, PAGE_SIZE);
+        mapping->frames = kalloc(mapping->pages_count * sizeof(uint32_t));
+        if (!mapping->frames) {
+            kfree(mapping);
+            return NULL;
+        }
+        memset(mapping->frames, 0, mapping->pages_count * sizeof(uint32_t));
+
+        mapping->next = fs->mappings;
+        fs->mappings = mapping;
+        created = 1;
+    }
+
+    if (offset / PAGE_SIZE >= mapping->pages_count ||
+        FLATFS_DIV_ROUND_UP(length, PAGE_SIZE) > mapping->pages_count - offset / PAGE_SIZE) {
+        if (created)
+            flatfs_mapping_put(mapping);
+        return NULL;
+    }
+
+    uint32_t page_flags = 0;
+    if (flags & PPROT_WRITE)
+        page_flags |= PG_WRITABLE;
+    if (flags & PPROT_USER)
+        page_flags |= PG_USER;
+
+    mapping->refs++;
+    void *start = vm_region_reserve_file(paging_get_current_directory(), addr, length, page_flags,
+                                         mapping, offset / PAGE_SIZE);
+    if (!start)
+        flatfs_mapping_put(mapping);
+
+    return start;
+}
+
+uint8_t flatfs_is_mapped(flatfs_t *fs, uint32_t inode_idx) {
+    return find_mapping(fs, inode_idx) != NULL;
+}
+
+void flatfs_mapping_get(flatfs_mapping_t *mapping) {
+    mapping->refs++;
+}
+
+void flatfs_mapping_put(flatfs_mapping_t *mapping) {
+    if (mapping->refs > 0 && --mapping->refs > 0)
+        return;
+
+    uint8_t *bounce = NULL;
+
+    for (uint32_t i = 0; i < mapping->pages_count; i++) {
+        uint32_t frame = mapping->frames[i];
+        if (frame == 0)
+            continue;
+
+        page_t *page = page_from_frame(frame);
+
+        /* dirtied in an address space that was destroyed without munmap, it is not mapped anywhere now */
+        if (page && (page->flags & PAGE_DIRTY)) {
+            if (!bounce)
+                bounce = kalloc(PAGE_SIZE);
+
+            if (bounce) {
+                paging_read_frame(frame, bounce);
+                page_io(mapping, i, bounce, 1);
+            }
+        }
+
+        if (page)
+            page->flags &= ~(PAGE_FILE | PAGE_DIRTY);
+
+        pmm_free_frame((void *)frame);  /* the cache reference */
+    }
+
+    kfree(bounce);
+
+    flatfs_mapping_t **link = &mapping->fs->mappings;
+    while (*link && *link != mapping)
+        link = &(*link)->next;
+    if (*link)
+        *link = mapping->next;
+
+    kfree(mapping->frames);
+    kfree(mapping);
+}
+
+uint8_t flatfs_mapping_fault(flatfs_mapping_t *mapping, uint32_t page_idx,
+                             uint32_t vaddr, uint32_t page_flags) {
+    if (page_idx >= mapping->pages_count)
+        return 0;
+
+    uint32_t frame = mapping->frames[page_idx];
+
+    if (frame == 0) {
+        /* the page is read off to the side and mapped only once it is complete, the I/O runs with interrupts on */
+        uint8_t *bounce = kalloc(PAGE_SIZE);
+        if (!bounce)
+            return 0;
+
+        flatfs_mapping_get(mapping);  /* the region may be unmapped during the read */
+
+        paging_fault_io_begin();
+        flatfs_err_t err = page_io(mapping, page_idx, bounce, 0);
+        paging_fault_io_end();
+
+        /* another fault may have cached (and mapped) the page meanwhile, or the region may be gone */
+        uint8_t gone = mapping->refs == 1;
+        uint8_t mapped = paging_get_mapping((void *)vaddr) != NULL;
+        flatfs_mapping_put(mapping);
+
+        if (err != FLATFS_OK || gone || mapped) {
+            kfree(bounce);
+            return err == FLATFS_OK;  /* handled, the access is retried */
+        }
+
+        frame = mapping->frames[page_idx];
+        if (frame == 0) {
+            void *fresh = pmm_alloc_frame();
+            if (!fresh) {
+                kfree(bounce);
+                return 0;
+            }
+            paging_write_frame((uint32_t)fresh, bounce);
+
+            frame = (uint32_t)fresh;
+            mapping->frames[page_idx] = frame;
+
+            page_t *page = page_from_frame(frame);
+            if (page)
+                page->flags = (page->flags & ~PAGE_DIRTY) | PAGE_FILE;
+        }
+
+        kfree(bounce);
+    }
+
+    /* the mapping holds its own reference, the cache keeps the one from the allocation */
+    page_get(frame);
+    paging_map_page((void *)vaddr, (void *)frame, PG_PRESENT | page_flags);
+
+    return 1;
+}
+
+flatfs_err_t flatfs_mapping_write_page(flatfs_mapping_t *mapping, uint32_t page_idx,
+                                       const void *vaddr) {
+    if (page_idx >= mapping->pages_count)
+        return FLATFS_ERR_INVALID;
+
+    return page_io(mapping, page_idx, (uint8_t *)vaddr, 1);
+}
+
+/* =========================================================================
+ * INTERNAL HELPERS
+ * ========================================================================= */
+
+static flatfs_mapping_t *find_mapping(flatfs_t *fs, uint32_t inode_idx) {
+    for (flatfs_mapping_t *mapping = fs->mappings; mapping; mapping = mapping->next)
+        if (mapping->inode_idx == inode_idx)
+            return mapping;
+
+    return NULL;
+}
+
+/*
+ * Drive sector holding sector `file_sector` of the file
+ * (block indices are resolved the same way flatfs_read does).
+ */
+static uint32_t sector_lba(flatfs_mapping_t *mapping, uint32_t file_sector) {
+    uint32_t sectors_per_block = mapping->fs->sb.sectors_per_block;
+    uint32_t block = mapping->fs->sb.data_start_block + mapping->inode.blocks[file_sector / sectors_per_block];
+
+    return block * sectors_per_block + file_sector % sectors_per_block;
+}
+
+/*
+ * Read (write == 0) or write the sectors of file page `page_idx` that are
+ * inside the file, runs of sectors that are contiguous on the drive go in a
+ * single request. A read zeroes the part of the page past the end of file.
+ */
+static flatfs_err_t page_io(flatfs_mapping_t *mapping, uint32_t page_idx, uint8_t *data, uint8_t write) {
+    flatfs_t *fs = mapping->fs;
+    uint32_t first = page_idx * FLATFS_PAGE_SECTORS;
+    uint32_t end = MIN(first + FLATFS_PAGE_SECTORS,
+                       FLATFS_DIV_ROUND_UP(mapping->inode.size, ATA_SECTOR_SIZE));
+
+    for (uint32_t sector = first; sector < end;) {
+        uint32_t lba = sector_lba(mapping, sector);
+        uint32_t count = 1;
+
+        while (sector + count < end && sector_lba(mapping, sector + count) == lba + count)
+            count++;
+
+        if (lba + count > fs->sb.total_sectors)
+            return FLATFS_ERR_CORRUPT;
+
+        uint8_t *buffer = data + (sector - first) * ATA_SECTOR_SIZE;
+        ata_error_t err = write ? ata_write28_request(fs->drive, lba, count, buffer)
+                                : ata_read28_request(fs->drive, lba, count, buffer);
+        if (err != ATA_OK)
+            return FLATFS_ERR_IO;
+
+        sector += count;
+    }
+
+    uint32_t page_offset = page_idx * PAGE_SIZE;
+    if (!write && page_offset + PAGE_SIZE > mapping->inode.size)
+        memset(data + (mapping->inode.size - page_offset), 0, page_offset + PAGE_SIZE - mapping->inode.size);
+
+    return FLATFS_OK;
+}
\ No newline at end of file
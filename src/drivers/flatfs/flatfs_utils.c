@@ -1,41 +1,66 @@
-#include "drivers/flatfs/flatfs_driver.h"
-
-flatfs_err_t flatfs_write_blocks(flatfs_t *fs,
-                                  uint32_t start_block_idx,
-                                  uint32_t block_count,
-                                  const uint8_t *data) {
-    if (!fs || !data)
-        return FLATFS_ERR_INVALID;
-    
-    uint32_t total_drive_blocks = fs->sb.total_sectors / fs->sb.sectors_per_block;
-
-    if (start_block_idx + block_count >= total_drive_blocks)
-        return FLATFS_ERR_INVALID;
-
-    uint8_t err = ata_write28_request(fs->drive,
-                                      start_block_idx * fs->sb.sectors_per_block,
-                                      block_count * fs->sb.sectors_per_block,
-                                      (uint8_t *)data);
-
-    return (err == 1) ? FLATFS_ERR_IO : FLATFS_OK;
-}
-
-flatfs_err_t flatfs_read_blocks(flatfs_t *fs,
-                                 uint32_t start_block_idx,
-                                 uint32_t block_count,
-                                 uint8_t *buffer) {
-    if (!fs || !buffer)
-        return FLATFS_ERR_INVALID;
-
-    uint32_t total_drive_blocks = fs->sb.total_sectors / fs->sb.sectors_per_block;
-
-    if (start_block_idx + block_count >= total_drive_blocks)
-        return FLATFS_ERR_INVALID;
-
-    uint8_t err = ata_read28_request(fs->drive,
-                                     start_block_idx * fs->sb.sectors_per_block,
-                                     block_count * fs->sb.sectors_per_block,
-                                     buffer);
-
-    return (err == 1) ? FLATFS_ERR_IO : FLATFS_OK;
+#include "drivers/flatfs/flatfs_driver.h"
+
+flatfs_err_t flatfs_write_blocks(flatfs_t *fs,
+                                  uint32_t start_block_idx,
+                                  uint32_t block_count,
+                                  const uint8_t *data) {
+    if (!fs || !data)
+        return FLATFS_ERR_INVALID;
+    
+    uint32_t total_drive_blocks = fs->sb.total_sectors / fs->sb.sectors_per_block;
+
+    if (start_block_idx + block_count >= total_drive_blocks)
+        return FLATFS_ERR_INVALID;
+
+    uint8_t err = ata_write28_request(fs->drive,
+                                      start_block_idx * fs->sb.sectors_per_block,
+                                      block_count * fs->sb.sectors_per_block,
+                                      (uint8_t *)data);
+
+    return (err == 1) ? FLATFS_ERR_IO : FLATFS_OK;
+}
+
+flatfs_err_t flatfs_read_blocks(flatfs_t *fs,
+                                 uint32_t start_block_idx,
+                                 uint32_t block_count,
+                                 uint8_t *buffer) {
+    if (!fs || !buffer)
+        return FLATFS_ERR_INVALID;
+
+    uint32_t total_drive_blocks = fs->sb.total_sectors / fs->sb.sectors_per_block;
+
+    if (start_block_idx + block_count >= total_drive_blocks)
+        return FLATFS_ERR_INVALID;
+
+    uint8_t err = ata_read28_request(fs->drive,
+                                     start_block_idx * fs->sb.sectors_per_block,
+                                     block_count * fs->sb.sectors_per_block,
+                                     buffer);
+
+    return (err == 1) ? FLATFS_ERR_IO : FLATFS_OK;
+}
+
+flatfs_err_t flatfs_scratch_init(flatfs_t *fs) {
+    if (!fs)
+        return FLATFS_ERR_INVALID;
+
+    fs->scratch_cache = kmem_cache_create("flatfs scratch", FLATFS_SCRATCH_SIZE(&fs->sb));
+
+    return (fs->scratch_cache == NULL) ? FLATFS_ERR_NO_MEM : FLATFS_OK;
+}
+
+void flatfs_scratch_destroy(flatfs_t *fs) {
+    if (!fs)
+        return;
+
+    kmem_cache_destroy(fs->scratch_cache);
+    fs->scratch_cache = NULL;
+}
+
+uint8_t *flatfs_scratch_alloc(flatfs_t *fs) {
+    return (uint8_t *)kmem_cache_alloc(fs->scratch_cache);
+}
+
+void flatfs_scratch_free(flatfs_t *fs, uint8_t *buffer) {
+    kmem_cache_free(fs->scratch_cache, buffer);
 }
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "drivers/serial_driver.h"
+#include "kernel/print.h"
+#include "io/port.h"
+#include "utils/utils.h"
+#include "arg.h"
+
+/* register offsets from the port base */
+#define SERIAL_DATA           0  /* divisor low byte while DLAB is set */
+#define SERIAL_INT_ENABLE     1  /* divisor high byte while DLAB is set */
+#define SERIAL_FIFO_CONTROL   2
+#define SERIAL_LINE_CONTROL   3
+#define SERIAL_MODEM_CONTROL  4
+#define SERIAL_LINE_STATUS    5
+
+#define SERIAL_LINE_DLAB          0x80
+#define SERIAL_LINE_8N1           0x03
+#define SERIAL_STATUS_TX_EMPTY    0x20
+#define SERIAL_MODEM_LOOPBACK     0x10
+
+static uint8_t serial_ready = 0;
+static char buf[SERIAL_MAX_STRING_PRINT + 1];  /* temporary buffer for serial_printf */
+
+void serial_init() {
+    uint16_t port = SERIAL_COM1_PORT;
+
+    outb(port + SERIAL_INT_ENABLE, 0x00);  // polled, no interrupts
+    outb(port + SERIAL_LINE_CONTROL, SERIAL_LINE_DLAB);
+    outb(port + SERIAL_DATA, SERIAL_BAUD_DIVISOR & 0xFF);
+    outb(port + SERIAL_INT_ENABLE, (SERIAL_BAUD_DIVISOR >> 8) & 0xFF);
+    outb(port + SERIAL_LINE_CONTROL, SERIAL_LINE_8N1);
+    outb(port + SERIAL_FIFO_CONTROL, 0xC7);  // enable and clear the FIFOs, 14 byte threshold
+
+    /* loopback test, a missing UART reads back garbage */
+    outb(port + SERIAL_MODEM_CONTROL, SERIAL_MODEM_LOOPBACK | 0x0B);
+    outb(port + SERIAL_DATA, 0xAE);
+    if (inb(port + SERIAL_DATA) != 0xAE) {
+        serial_ready = 0;
+        return;
+    }
+
+    outb(port + SERIAL_MODEM_CONTROL, 0x0F);  // normal operation, DTR, RTS, OUT1, OUT2
+    serial_ready = 1;
+}
+
+uint8_t serial_is_ready() {
+    return serial_ready;
+}
+
+void serial_write_char(char c) {
+    if (!serial_ready) return;
+
+    while ((inb(SERIAL_COM1_PORT + SERIAL_LINE_STATUS) & SERIAL_STATUS_TX_EMPTY) == 0);
+
+    outb(SERIAL_COM1_PORT + SERIAL_DATA, c);
+}
+
+void serial_write_string(const char * string) {
+    for (; *string != '\0'; string++) {
+        if (*string == '\n')
+            serial_write_char('\r');
+        serial_write_char(*string);
+    }
+}
+
+void serial_printf(const char * format, ...) {
+    va_list args;
+
+    if (!serial_ready) return;
+
+    memset(buf, 0, (SERIAL_MAX_STRING_PRINT + 1) * sizeof(char));
+
+    va_start(args, format);
+    vsprintf(buf, format, args);
+    va_end(args);
+
+    serial_write_string(buf);
+}
\ No newline at end of file
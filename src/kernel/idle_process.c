@@ -1,10 +1,17 @@
-#include "kernel/print.h"
-
-void idle_process_main() {
-    // enable interrupts
-    asm volatile ("sti");
-    
-    while (1)
-        __asm__ __volatile__("hlt");
-    
+#include "kernel/print.h"
+#include "mm/pmm.h"
+#include "multitasking/scheduler.h"
+
+void idle_process_main() {
+    // enable interrupts
+    asm volatile ("sti");
+    
+    /* spend the idle time destroying exited threads and zeroing frames for pmm_alloc_zeroed_frame, sleep once the pool is full */
+    while (1) {
+        scheduler_reap_zombies();
+
+        if (!pmm_zeroed_pool_refill())
+            __asm__ __volatile__("hlt");
+    }
+    
 }
\ No newline at end of file
@@ -1,123 +1,202 @@
-
-#include "kernel/description_tables.h"
-#include "kernel/early_print.h"
-#include "kernel/print.h"
-#include "kernel/screen.h"
-#include "kernel/timer.h"
-#include "kernel/panic.h"
-#include "kernel/syscall.h"
-#include "mm/paging.h"
-#include "mm/kheap.h"
-#include "mm/pmm.h"
-#include "drivers/flatfs/flatfs_driver.h"
-#include "drivers/keyboard_driver.h"
-#include "drivers/ata_driver.h"
-#include "multitasking/process.h"
-#include "multitasking/scheduler.h"
-#include "tests/ata_test.h"
-#include "tests/flatfs_test.h"
-#include "tests/heap_test.h"
-#include "multiboot_info.h"
-#include "multiboot.h"
-#include "utils/utils.h"
-#include "types.h"
-
-void p1_main();
-void p2_main();
-
-void print_process_list(process_t *head);
-
-multiboot_info_t multiboot_info;
-tty_t tty;
-ata_drive_t drive_prime_master;
-uint8_t temp_buffer[50 * sizeof(event_t)];
-
-// Entry point called by GRUB
-void kernel_main(multiboot_info_t* lower_multiboot_info_structure, uint32_t multiboot_magic) {
-    early_print_init();
-
-    if (multiboot_magic != MULTIBOOT_BOOTLOADER_MAGIC) {
-        early_printf("KERNEL PANIC: %s at %s:%d in %s()\n",          
-               "Error: multiboot magic number unknown", 
-               __FILE__, 
-               __LINE__, 
-               __func__);         
-        while (1)__asm__ __volatile__("hlt");                      
-        
-    }
-
-    /* remember, when we get here, lower half of the kernel is still mapped*/
-    /* there is a need to copy that before paging */
-    memcpy(&multiboot_info, lower_multiboot_info_structure, sizeof(multiboot_info_t));
-
-    multiboot_info_print(multiboot_magic, lower_multiboot_info_structure);
-
-    pmm_init();  // initialize physical memory manager (will be needed for invalidation of invalide memory address)
-    early_printf("Physical memory initialized.\n");
-
-    multiboot_info_invalidate_unavailable_memory(lower_multiboot_info_structure);
-
-    gdt_init();
-    early_printf("GDT initialized.\n");
-
-    idt_init();
-    early_printf("IDT initialized.\n");
-
-    paging_init(); // init paging module
-    early_printf("Paging initialized.\n");
-
-    heap_init();  // Initialize heap module
-    early_printf("Heap initialized.\n");
-
-    timer_init(1000); // Initialize timer to 1000Hz
-    early_printf("Timer initialized.\n");
-    
-    syscall_init();  // initialize the syscall module 
-    early_printf("Syscall module  initialized.\n");
-
-    keyboard_driver_init();  // initialize the keyboard driver
-    early_printf("Keyboard driver initialized.\n");
-
-    ata_driver_init();  // initiate the ata driver
-    early_printf("Ata driver initialized.\n");
-
-    scheduler_init(); // initialize the scheduler
-    early_printf("Scheduler initialized.\n");
-    
-    asm volatile ("sti"); // enable interrupts
-    
-    tty_init(&tty); /* initialize tty again after all modules initialized (heap is now initizlied)*/
-    print_set_tty(&tty);
-    
-    /* setup information on the first primery master drive */
-    identify_device_data_t identify_buf;
-    ata_drive_init(&drive_prime_master, ATA_PRIMARY_IO, ATA_PRIMARY_CTRL, ATA_MASTER_DRIVE);
-
-    uint8_t _ = ata_send_identify_command(&drive_prime_master, &identify_buf);
-    if (_ == 1) PANIC("ATA identify error");
-    drive_prime_master.exists = 1;
-    
-    print_identify_device_data(&identify_buf);
-    drive_prime_master.size_in_sectors = identify_buf.UserAddressableSectors;
-    
-
-    /* test modules */
-    ata_test_write_read_3_sectors(&drive_prime_master, 50);
-    flatfs_test_basic(&drive_prime_master);
-    
-    heap_test_basic();
-    heap_test_many_small_allocs();
-
-    /*process_t * p1 = process_create(PROCESS_KERNEL, p1_main, 0x10000);
-    process_t * p2 = process_create(PROCESS_KERNEL, p2_main, 0x10000);
-
-    scheduler_add_process_to_ready_queue(p1);
-    scheduler_add_process_to_ready_queue(p2);
-
-    print_process_list(p1);
-
-    scheduler_set_on();*/
-
-
-    while (1);
-}
+
+#include "kernel/description_tables.h"
+#include "kernel/early_print.h"
+#include "kernel/print.h"
+#include "kernel/screen.h"
+#include "kernel/timer.h"
+#include "kernel/panic.h"
+#include "kernel/syscall.h"
+#include "mm/paging.h"
+#include "mm/kheap.h"
+#include "mm/slab.h"
+#include "mm/vm_region.h"
+#include "mm/vmalloc.h"
+#include "mm/pmm.h"
+#include "mm/page.h"
+#include "mm/buddy.h"
+#include "mm/highmem.h"
+#include "mm/swap.h"
+#include "drivers/flatfs/flatfs_driver.h"
+#include "drivers/keyboard_driver.h"
+#include "drivers/ata_driver.h"
+#include "drivers/serial_driver.h"
+#include "multitasking/process.h"
+#include "multitasking/scheduler.h"
+#include "multitasking/sleep.h"
+#include "tests/ata_test.h"
+#include "tests/flatfs_test.h"
+#include "tests/heap_test.h"
+#include "tests/pmm_test.h"
+#include "tests/scheduler_test.h"
+#include "tests/buddy_test.h"
+#include "tests/paging_test.h"
+#include "tests/mmap_test.h"
+#include "tests/page_test.h"
+#include "tests/slab_test.h"
+#include "tests/swap_test.h"
+#include "tests/sync_test.h"
+#include "tests/vmalloc_test.h"
+#include "multiboot_info.h"
+#include "multiboot.h"
+#include "utils/utils.h"
+#include "types.h"
+
+void p1_main();
+void p2_main();
+void idle_process_main();
+
+void print_process_list(process_t *head);
+
+multiboot_info_t multiboot_info;
+tty_t tty;
+ata_drive_t drive_prime_master;
+uint8_t temp_buffer[50 * sizeof(event_t)];
+
+// Entry point called by GRUB
+void kernel_main(multiboot_info_t* lower_multiboot_info_structure, uint32_t multiboot_magic) {
+    early_print_init();
+
+    if (multiboot_magic != MULTIBOOT_BOOTLOADER_MAGIC) {
+        early_printf("KERNEL PANIC: %s at %s:%d in %s()\n",          
+               "Error: multiboot magic number unknown", 
+               __FILE__, 
+               __LINE__, 
+               __func__);         
+        while (1)__asm__ __volatile__("hlt");                      
+        
+    }
+
+    /* remember, when we get here, lower half of the kernel is still mapped*/
+    /* there is a need to copy that before paging */
+    memcpy(&multiboot_info, lower_multiboot_info_structure, sizeof(multiboot_info_t));
+
+    multiboot_info_print(multiboot_magic, lower_multiboot_info_structure);
+
+    serial_init();  // polled COM1, used to dump diagnostics
+    early_printf("Serial port %s.\n", serial_is_ready() ? "initialized" : "not found");
+
+    uint32_t frames_count = multiboot_info_frames_count(lower_multiboot_info_structure);  // the memory map is unreachable after paging_init
+
+    pmm_init(frames_count);  // initialize physical memory manager, sized to the highest usable address
+    multiboot_info_release_available_memory(lower_multiboot_info_structure);
+    multiboot_info_invalidate_unavailable_memory(lower_multiboot_info_structure);
+    pmm_reserve_range(0, PMM_ZONE_LOW_END);  // the first MiB holds the BIOS data and the multiboot structures, keep it out of use
+    early_printf("Physical memory initialized (%d frames, %d free).\n", pmm_get_frames_count(), pmm_get_free_frames_count());
+
+    buddy_init(lower_multiboot_info_structure);  // the buddy pool is taken from the pmm before anything else allocates frames
+    early_printf("Buddy allocator initialized.\n");
+
+    highmem_init(lower_multiboot_info_structure);  // RAM above 4 GiB, reached through PSE-36 large pages
+    early_printf("High memory initialized (%d MiB above 4 GiB).\n", highmem_total_blocks() * 4);
+
+    gdt_init();
+    early_printf("GDT initialized.\n");
+
+    idt_init();
+    early_printf("IDT initialized.\n");
+
+    paging_init(); // init paging module
+    early_printf("Paging initialized.\n");
+
+    page_db_init(frames_count);  // Initialize the page frame descriptors
+    early_printf("Page descriptors initialized (%d frames).\n", frames_count);
+
+    uint64_t heap_init_start = timer_read_tsc();
+    heap_init();  // Initialize heap module
+    uint32_t heap_init_cycles = (uint32_t)(timer_read_tsc() - heap_init_start);
+    early_printf("Heap initialized (%d KiB resident, %d cycles).\n", kheap_committed_size() / 1024, heap_init_cycles);
+
+    kmem_cache_init();  // Initialize the kernel object caches
+    early_printf("Object caches initialized.\n");
+
+    vm_region_init();  // Initialize the mmap regions
+    early_printf("Memory regions initialized.\n");
+
+    vmalloc_init();  // Initialize the large buffer allocator
+    early_printf("Vmalloc initialized.\n");
+
+    timer_init(1000); // Initialize timer to 1000Hz
+    early_printf("Timer initialized.\n");
+    
+    syscall_init();  // initialize the syscall module 
+    early_printf("Syscall module  initialized.\n");
+
+    keyboard_driver_init();  // initialize the keyboard driver
+    early_printf("Keyboard driver initialized.\n");
+
+    ata_driver_init();  // initiate the ata driver
+    early_printf("Ata driver initialized.\n");
+
+    scheduler_init(); // initialize the scheduler
+    early_printf("Scheduler initialized.\n");
+
+    sleep_queue_init(); // initialize the sleep queue (timer wheel)
+    early_printf("Sleep queue initialized.\n");
+    
+    asm volatile ("sti"); // enable interrupts
+    
+    tty_init(&tty); /* initialize tty again after all modules initialized (heap is now initizlied)*/
+    print_set_tty(&tty);
+    
+    /* setup information on the first primery master drive */
+    identify_device_data_t identify_buf;
+    ata_drive_init(&drive_prime_master, ATA_PRIMARY_IO, ATA_PRIMARY_CTRL, ATA_MASTER_DRIVE);
+
+    uint8_t _ = ata_send_identify_command(&drive_prime_master, &identify_buf);
+    if (_ == 1) PANIC("ATA identify error");
+    drive_prime_master.exists = 1;
+    
+    print_identify_device_data(&identify_buf);
+    drive_prime_master.size_in_sectors = identify_buf.UserAddressableSectors;
+
+    /* the swap area is taken off the end of the drive before the file system is formatted on it */
+    uint32_t swap_slots = swap_init(&drive_prime_master, SWAP_MAX_SLOTS);
+    printf("Swap initialized (%d KiB, %d KiB in high memory).\n", swap_slots * PAGE_SIZE / 1024, swap_ram_slots() * PAGE_SIZE / 1024);
+    
+
+    /* test modules */
+    ata_test_write_read_3_sectors(&drive_prime_master, 50);
+    flatfs_test_basic(&drive_prime_master);
+    
+    heap_test_basic();
+    heap_test_many_small_allocs();
+    heap_test_bench_churn();
+    heap_test_expand_and_trim();
+    heap_test_telemetry();
+    heap_test_aligned();
+    heap_test_bench_threads();
+    slab_test_basic();
+    vmalloc_test_basic();
+    pmm_test_bench_alloc_all();
+    pmm_test_bench_zeroed_pool();
+    pmm_test_ranges_and_zones();
+    buddy_test_stress();
+    paging_test_bench_tlb();
+    paging_test_bench_large_pages();
+    mmap_test_demand_zero();
+    mmap_test_file_backed(&drive_prime_master);
+    page_test_refcount();
+    paging_test_cow_clone();
+    swap_test_roundtrip();
+    swap_test_fault_during_drive_io(&drive_prime_master);
+    scheduler_test_bench_run_queue();
+    scheduler_test_wakeup_latency();
+    scheduler_test_sleepers();
+    scheduler_test_bench_switch();
+    sync_test_primitives();
+    sync_test_bench_contention(&drive_prime_master);
+    pmm_test_idle_refill();
+
+    /*process_t * p1 = process_create(PROCESS_KERNEL, p1_main, 0x10000);
+    process_t * p2 = process_create(PROCESS_KERNEL, p2_main, 0x10000);
+
+    scheduler_add_process_to_ready_queue(p1);
+    scheduler_add_process_to_ready_queue(p2);
+
+    print_process_list(p1);
+
+    scheduler_set_on();*/
+
+    /* kernel_main is the idle thread from here on */
+    idle_process_main();
+}
@@ -1,27 +1,27 @@
-#include "kernel/screen.h"
-#include "types.h"
-#include "utils/utils.h"
-
-static volatile char *video = (volatile char*)0xFFFFF000;
-
-void screen_flush_text_and_colour_buffer(char *text_buffer, 
-                                         char *colour_buffer, 
-                                         uint32_t start_row, 
-                                         uint32_t start_column, 
-                                         uint32_t rows, 
-                                         uint32_t columns)
-{
-    for (uint32_t y = 0; y < SCREEN_ROWS; y++) {
-        for (uint32_t x = 0; x < SCREEN_COLUMNS; x++) {
-            video[(y * SCREEN_COLUMNS + x) * 2] 
-                = (text_buffer + ((y + start_row) % rows) * columns)[(x + start_column) % columns];
-            video[(y * SCREEN_COLUMNS + x) * 2 + 1] 
-                = (colour_buffer + ((y + start_row) % rows) * columns)[(x + start_column) % columns];
-        }
-    }
-}
-
-void screen_print_char(char c, char colour, uint32_t row, uint32_t column) {
-    video[(row * SCREEN_COLUMNS + column) * 2] = c;
-    video[(row * SCREEN_COLUMNS + column) * 2 + 1] = colour;
+#include "kernel/screen.h"
+#include "types.h"
+#include "utils/utils.h"
+
+static volatile char *video = (volatile char*)0xFFFFF000;
+
+void screen_flush_text_and_colour_buffer(char *text_buffer, 
+                                         char *colour_buffer, 
+                                         uint32_t start_row, 
+                                         uint32_t start_column, 
+                                         uint32_t rows, 
+                                         uint32_t columns)
+{
+    for (uint32_t y = 0; y < SCREEN_ROWS; y++) {
+        for (uint32_t x = 0; x < SCREEN_COLUMNS; x++) {
+            video[(y * SCREEN_COLUMNS + x) * 2] 
+                = (text_buffer + ((y + start_row) % rows) * columns)[(x + start_column) % columns];
+            video[(y * SCREEN_COLUMNS + x) * 2 + 1] 
+                = (colour_buffer + ((y + start_row) % rows) * columns)[(x + start_column) % columns];
+        }
+    }
+}
+
+void screen_print_char(char c, char colour, uint32_t row, uint32_t column) {
+    video[(row * SCREEN_COLUMNS + column) * 2] = c;
+    video[(row * SCREEN_COLUMNS + column) * 2 + 1] = colour;
 }
\ No newline at end of file
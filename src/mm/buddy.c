@@ -0,0 +1,239 @@
+#include "kernel/early_print.h"
+#include "kernel/print.h"
+#include "kernel/panic.h"
+#include "mm/buddy.h"
+#include "mm/pmm.h"
+#include "utils/utils.h"
+
+#define BUDDY_MAX_BLOCK_SIZE  ((1u << BUDDY_MAX_ORDER) * FRAME_SIZE)
+#define ALIGN_UP(x, a)        (((x) + (a) - 1) & ~((a) - 1))
+#define ALIGN_DOWN(x, a)      ((x) & ~((a) - 1))
+
+/* Symbols provided by the linker */
+extern uint32_t __kernel_end_v_no_heap;
+
+static buddy_block_t blocks[BUDDY_POOL_FRAMES];  /* one entry per pool frame */
+static buddy_block_t * free_lists[BUDDY_ORDERS];
+static uint32_t free_count[BUDDY_ORDERS];
+static uint32_t pool_base;    /* physical address of the pool */
+static uint32_t total_frames;
+static uint32_t free_frames;
+
+#define BLOCK_INDEX(block)   ((uint32_t)((block) - blocks))
+#define BLOCK_ADDR(block)    (pool_base + BLOCK_INDEX(block) * FRAME_SIZE)
+
+static void free_list_add(buddy_block_t * block, uint32_t order) {
+    block->order = order;
+    block->flags = BUDDY_BLOCK_FREE;
+    block->previous = NULL;
+    block->next = free_lists[order];
+
+    if (block->next != NULL)
+        block->next->previous = block;
+
+    free_lists[order] = block;
+    free_count[order]++;
+}
+
+static void free_list_remove(buddy_block_t * block) {
+    if (block->previous != NULL)
+        block->previous->next = block->next;
+    else
+        free_lists[block->order] = block->next;
+
+    if (block->next != NULL)
+        block->next->previous = block->previous;
+
+    free_count[block->order]--;
+    block->flags = 0;
+    block->previous = NULL;
+    block->next = NULL;
+}
+
+/* put a block back, merging it with its buddy as long as the buddy is a free block of the same order */
+static void release_block(uint32_t index, uint32_t order) {
+    while (order < BUDDY_MAX_ORDER) {
+        /* the pool is a multiple of the largest block, so the buddy is always inside it */
+        buddy_block_t * buddy = &blocks[index ^ (1u << order)];
+
+        if (buddy->flags != BUDDY_BLOCK_FREE || buddy->order != order)
+            break;
+
+        free_list_remove(buddy);
+        index &= ~(1u << order);  /* the merged block starts at the lower of the two */
+        order++;
+    }
+
+    free_list_add(&blocks[index], order);
+}
+
+/* find where the pool goes: the top of the largest available region, above the kernel image */
+static uint32_t choose_pool_base(multiboot_info_t * mbi) {
+    uint32_t kernel_end_phys = ALIGN_UP((uint32_t)&__kernel_end_v_no_heap - 0xC0000000, BUDDY_MAX_BLOCK_SIZE);
+    uint64_t best_len = 0;
+    uint32_t best_base = 0;
+
+    uint32_t mmap_end = mbi->mmap_addr + mbi->mmap_length;
+
+    for (
+        multiboot_memory_map_t *mmap = (multiboot_memory_map_t *)mbi->mmap_addr;
+        (uint32_t)mmap < mmap_end;
+        mmap = (multiboot_memory_map_t *)((uint32_t)mmap + mmap->size + sizeof(mmap->size)))
+    {
+        if (mmap->type != MULTIBOOT_MEMORY_AVAILABLE || mmap->addr >= 0x100000000ULL) continue;
+
+        uint64_t end = mmap->addr + mmap->len;
+        if (end > 0x100000000ULL) end = 0x100000000ULL;
+        if (end <= kernel_end_phys + BUDDY_MAX_BLOCK_SIZE) continue;
+        if (end - mmap->addr <= best_len) continue;
+
+        uint32_t base = kernel_end_phys;
+        if (end >= kernel_end_phys + BUDDY_POOL_FRAMES * FRAME_SIZE)
+            base = ALIGN_DOWN((uint32_t)(end - BUDDY_POOL_FRAMES * FRAME_SIZE), BUDDY_MAX_BLOCK_SIZE);
+
+        best_len = end - mmap->addr;
+        best_base = base;
+    }
+
+    return best_base;
+}
+
+/* is the frame at paddr inside an available region of the multiboot map */
+static uint8_t is_available_ram(multiboot_info_t * mbi, uint32_t paddr) {
+    uint32_t mmap_end = mbi->mmap_addr + mbi->mmap_length;
+
+    for (
+        multiboot_memory_map_t *mmap = (multiboot_memory_map_t *)mbi->mmap_addr;
+        (uint32_t)mmap < mmap_end;
+        mmap = (multiboot_memory_map_t *)((uint32_t)mmap + mmap->size + sizeof(mmap->size)))
+    {
+        if (mmap->type == MULTIBOOT_MEMORY_AVAILABLE &&
+            paddr >= mmap->addr && (uint64_t)paddr + FRAME_SIZE <= mmap->addr + mmap->len)
+            return 1;
+    }
+
+    return 0;
+}
+
+void buddy_init(multiboot_info_t * mbi) {
+    memset(blocks, 0, sizeof(blocks));
+    memset(free_lists, 0, sizeof(free_lists));
+    memset(free_count, 0, sizeof(free_count));
+    total_frames = 0;
+    free_frames = 0;
+
+    if (!(mbi->flags & MULTIBOOT_INFO_MEM_MAP)) {
+        early_printf("Buddy allocator: no memory map, pool is empty\n");
+        return;
+    }
+
+    pool_base = choose_pool_base(mbi);
+    if (pool_base == 0) {
+        early_printf("Buddy allocator: no region is big enough, pool is empty\n");
+        return;
+    }
+
+    /* take every free RAM frame of the pool from the pmm, and free it into the buddy lists */
+    for (uint32_t i = 0; i < BUDDY_POOL_FRAMES; i++) {
+        uint32_t paddr = pool_base + i * FRAME_SIZE;
+
+        if (!is_available_ram(mbi, paddr) || pmm_alloc_frame_addr((void *)paddr) == NULL)
+            continue;
+
+        total_frames++;
+        free_frames++;
+        release_block(i, 0);
+    }
+
+    early_printf("Buddy allocator: %d frames at 0x%x\n", total_frames, pool_base);
+}
+
+void * buddy_alloc(uint32_t order) {
+    if (order > BUDDY_MAX_ORDER)
+        return NULL;
+
+    uint32_t current = order;
+    while (current <= BUDDY_MAX_ORDER && free_lists[current] == NULL)
+        current++;
+
+    if (current > BUDDY_MAX_ORDER)
+        return NULL;  /* no block big enough */
+
+    buddy_block_t * block = free_lists[current];
+    free_list_remove(block);
+
+    /* split down to the wanted order, the upper halves go back to the free lists */
+    while (current > order) {
+        current--;
+        free_list_add(block + (1u << current), current);
+    }
+
+    block->order = order;
+    block->flags = BUDDY_BLOCK_USED;
+    free_frames -= 1u << order;
+
+    return (void *)BLOCK_ADDR(block);
+}
+
+void buddy_free(void * paddr, uint32_t order) {
+    if (paddr == NULL) return;
+
+    uint32_t addr = (uint32_t)paddr;
+    if (addr < pool_base || addr >= pool_base + BUDDY_POOL_FRAMES * FRAME_SIZE)
+        PANIC("buddy_free of an address outside the pool");
+
+    uint32_t index = (addr - pool_base) / FRAME_SIZE;
+    buddy_block_t * block = &blocks[index];
+
+    if (block->flags != BUDDY_BLOCK_USED || block->order != order)
+        PANIC("buddy_free of a block that is not allocated with this order");
+
+    block->flags = 0;
+    free_frames += 1u << order;
+    release_block(index, order);
+}
+
+uint32_t buddy_order_for_size(size_t size) {
+    uint32_t order = 0;
+
+    while (order < BUDDY_MAX_ORDER && ((size_t)FRAME_SIZE << order) < size)
+        order++;
+
+    return order;
+}
+
+void buddy_get_stats(buddy_stats_t * stats) {
+    stats->total_frames = total_frames;
+    stats->free_frames = free_frames;
+    stats->largest_free_order = -1;
+
+    for (uint32_t order = 0; order < BUDDY_ORDERS; order++) {
+        stats->free_blocks[order] = free_count[order];
+
+        if (free_count[order] != 0)
+            stats->largest_free_order = order;
+    }
+}
+
+uint32_t buddy_unusable_index(uint32_t order) {
+    if (free_frames == 0)
+        return 100;
+
+    /* frames in free blocks smaller than order can not be used for such a block */
+    uint32_t unusable = 0;
+    for (uint32_t o = 0; o < order && o < BUDDY_ORDERS; o++)
+        unusable += free_count[o] << o;
+
+    return unusable * 100 / free_frames;
+}
+
+void print_buddy_status() {
+    printf("--- Buddy Allocator Status ---\n");
+    printf("Pool at 0x%x, %d of %d frames free\n", pool_base, free_frames, total_frames);
+
+    for (uint32_t order = 0; order < BUDDY_ORDERS; order++)
+        printf("Order %d (%d KiB): %d free blocks, unusable index %d%%\n",
+               order, (FRAME_SIZE << order) / 1024, free_count[order], buddy_unusable_index(order));
+
+    printf("--- End of Buddy Allocator Status ---\n");
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "kernel/panic.h"
+#include "mm/highmem.h"
+#include "mm/paging.h"
+#include "utils/bitmap_util.h"
+#include "utils/utils.h"
+
+#define CPUID_PSE36 (1 << 17)
+
+static uint8_t used_blocks[HIGHMEM_MAX_BLOCKS / 8];  /* 1 bit per block above 4 GiB, 1 - used or not RAM */
+static uint32_t total_blocks;
+static uint32_t free_blocks;
+static uint32_t window_block;  /* the block mapped at HIGHMEM_WINDOW, 0 - none */
+
+static uint8_t cpu_has_pse36() {
+    uint32_t eax = 1, ebx, ecx, edx;
+    __asm__ __volatile__("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    return (edx & CPUID_PSE36) != 0;
+}
+
+void highmem_init(multiboot_info_t * mbi) {
+    memset(used_blocks, 0xFF, sizeof(used_blocks));
+    total_blocks = 0;
+    free_blocks = 0;
+    window_block = 0;
+
+    if (!(mbi->flags & MULTIBOOT_INFO_MEM_MAP) || !paging_large_pages_enabled() || !cpu_has_pse36())
+        return;
+
+    uint32_t mmap_end = mbi->mmap_addr + mbi->mmap_length;
+
+    for (
+        multiboot_memory_map_t *mmap = (multiboot_memory_map_t *)mbi->mmap_addr;
+        (uint32_t)mmap < mmap_end;
+        mmap = (multiboot_memory_map_t *)((uint32_t)mmap + mmap->size + sizeof(mmap->size)))
+    {
+        if (mmap->type != MULTIBOOT_MEMORY_AVAILABLE) continue;
+
+        /* only the whole blocks inside the region */
+        uint64_t first = (mmap->addr + LARGE_PAGE_SIZE - 1) / LARGE_PAGE_SIZE;
+        uint64_t end = (mmap->addr + mmap->len) / LARGE_PAGE_SIZE;
+
+        if (first < HIGHMEM_FIRST_BLOCK) first = HIGHMEM_FIRST_BLOCK;
+        if (end > HIGHMEM_END_BLOCK) end = HIGHMEM_END_BLOCK;
+
+        for (uint64_t block = first; block < end; block++) {
+            if (!bitmap_get(used_blocks, (uint32_t)block - HIGHMEM_FIRST_BLOCK)) continue;
+
+            bitmap_clear(used_blocks, (uint32_t)block - HIGHMEM_FIRST_BLOCK);
+            total_blocks++;
+            free_blocks++;
+        }
+    }
+}
+
+uint32_t highmem_total_blocks() {
+    return total_blocks;
+}
+
+uint32_t highmem_free_blocks() {
+    return free_blocks;
+}
+
+uint32_t highmem_alloc_block() {
+    uint32_t index;
+
+    if (free_blocks == 0 || !bitmap_find_first_clear(used_blocks, HIGHMEM_MAX_BLOCKS, &index))
+        return 0;
+
+    bitmap_set(used_blocks, index);
+    free_blocks--;
+
+    return HIGHMEM_FIRST_BLOCK + index;
+}
+
+void highmem_free_block(uint32_t block) {
+    if (block < HIGHMEM_FIRST_BLOCK || block >= HIGHMEM_END_BLOCK) PANIC("Freeing a block that is not high memory");
+    if (!bitmap_get(used_blocks, block - HIGHMEM_FIRST_BLOCK)) PANIC("Freeing a free high memory block");
+
+    bitmap_clear(used_blocks, block - HIGHMEM_FIRST_BLOCK);
+    free_blocks++;
+}
+
+void * highmem_map_block(uint32_t block) {
+    /* the window stays on the last block, back to back accesses to one block cost nothing */
+    if (block != window_block) {
+        if (paging_map_large_page_high((void *)HIGHMEM_WINDOW, block, PG_PRESENT | PG_WRITABLE) != 0)
+            PANIC("Unable to map the high memory window");
+
+        window_block = block;
+    }
+
+    return (void *)HIGHMEM_WINDOW;
+}
\ No newline at end of file
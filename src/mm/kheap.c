@@ -1,161 +1,714 @@
-#include "kernel/print.h"
-#include "mm/kheap.h"
-#include "mm/paging.h"
-#include "mm/pmm.h"
-
-// Defined in the linker
-extern uint32_t __heap_start;  // end is defined in the linker scrip
-extern uint32_t __heap_end;  // heap_start is defined in the linker script
-heap_t kernel_heap;   
-
-
-void print_heap_status() {
-    printf("--- Kernel Heap Status ---\n");
-    
-    if (kernel_heap.heap_first == NULL) {
-        printf("Heap is empty or uninitialized.\n");
-        return;
-    }
-
-    heap_chunk_t *current_chunk = kernel_heap.heap_first;
-    uint32_t chunk_count = 0;
-
-    while (current_chunk != NULL) {
-        chunk_count++;
-
-        printf("Chunk #%d at address: %p\n", chunk_count, (uint32_t)current_chunk);
-
-        printf("  Status: ");
-        if (current_chunk->is_used == CHUNK_IN_US) {
-            printf("USED");
-        } else {
-            printf("FREE");
-        }
-        printf("\n");
-
-        printf("  User Data Size: 0x%x bytes\n", current_chunk->size);
-
-        printf("  Previous Chunk: 0x%p\n", (uint32_t)current_chunk->previous);
-
-        printf("  Next Chunk: 0x%p\n", (uint32_t)current_chunk->next);
-        
-        printf("\n");
-
-        // Move to the next chunk in the linked list
-        current_chunk = current_chunk->next;
-    }
-
-    printf("--- End of Heap Status (Total Chunks: %d) ---\n", chunk_count);
-}
-
-void heap_init(){
-    /* map the heap somewere */
-    void * paddr;
-
-    for (uint32_t vaddr = (uint32_t)&__heap_start; vaddr < (uint32_t)&__heap_end; vaddr += PAGE_SIZE) {
-        paddr = pmm_alloc_frame();
-        paging_map_page((void *)vaddr, paddr, PG_WRITABLE | PG_PRESENT);
-    }
-
-    heap_chunk_t * first_chunk = (heap_chunk_t *)(&__heap_start);
-    first_chunk->is_used = CHUNK_NOT_IN_US;
-    first_chunk->size = KHEAP_INITIAL_SIZE - sizeof(heap_chunk_t);
-    first_chunk->previous = NULL;
-    first_chunk->next = NULL;
-    kernel_heap.heap_first = first_chunk;
-}
-
-void* kalloc(size_t size){
-    heap_chunk_t * current = kernel_heap.heap_first;
-
-    while (current != NULL)
-    {
-        if (current->is_used == CHUNK_NOT_IN_US && (current->size > size + sizeof(heap_chunk_t) /* the > in here may be replaced with more rigorous condition */)){
-            // calculate returned chunk position in memory
-            void * position_after_chunk = (void *)current + current->size + sizeof(heap_chunk_t);
-            heap_chunk_t * new_chunk = (heap_chunk_t *)(position_after_chunk - size - sizeof(heap_chunk_t));
-            
-            // NOTE: next = current->next
-
-            // set list's pointers
-            // set pointers for next
-            if (current->next != NULL) {
-                current->next->previous = new_chunk;
-            }
-
-            // set pointers of new_chunk chunk
-            new_chunk->next = current->next;
-            new_chunk->previous = current;
-
-            // set current chunk pointers
-            current->next = new_chunk;
-
-            // initialize chunk
-            new_chunk->is_used = CHUNK_IN_US;
-            new_chunk->size = size;
-
-            // update current chunk size
-            current->size -= size + sizeof(heap_chunk_t);
-
-            return (void *)new_chunk + sizeof(heap_chunk_t);
-        }
-
-        current = current->next;
-    }
-
-    return NULL; // faild to allocate memoy
-}
-
-void kfree(void * user_pointer) {
-    /* NOTE: should probably impliment an protections so not every pointer will be
-             to use kfree functionality */
-    if (user_pointer == NULL) return;
-    
-    heap_chunk_t * chunk = (heap_chunk_t *)((char *)user_pointer - sizeof(heap_chunk_t));
-
-    // update chunk status
-    chunk->is_used = CHUNK_NOT_IN_US;
-
-    // Fix 4: assimilate current chunk to the previous chunk if it is free FIRST
-    if (chunk->previous != NULL && chunk->previous->is_used == CHUNK_NOT_IN_US) {
-        // preserve the current prespective
-        heap_chunk_t * next = chunk->next;
-        heap_chunk_t * current = chunk;
-        heap_chunk_t * previous = chunk->previous;
-
-        // update pointers of next
-        if (next != NULL) {
-            next->previous = previous;
-        }
-        
-        // there isn't a need to update the pointers of current since it will be assimilated to previous
-        // update pointers of previous
-        previous->next = next;
-
-        // update the previous (in the current prespective) chunk size
-        previous->size += sizeof(heap_chunk_t) + current->size;
-
-        // repoint chunk to previous so the next merge works correctly
-        chunk = previous;
-    }
-
-    // assimilate next chunk to the current chunk if it is free
-    if (chunk->next != NULL && chunk->next->is_used == CHUNK_NOT_IN_US) {
-        // change the prespective to the next chunk
-        heap_chunk_t * next = chunk->next->next;
-        heap_chunk_t * current = chunk->next;
-        heap_chunk_t * previous = chunk;
-
-        // update pointers of next
-        if (next != NULL) {
-            next->previous = previous;
-        }
-        
-        // there isn't a need to update the pointers of current since it will be assimilated to previous
-        // update pointers of previous
-        previous->next = next;
-
-        // update the previous (in the current prespective) chunk size
-        previous->size += sizeof(heap_chunk_t) + current->size;
-    }
+#include "kernel/print.h"
+#include "kernel/panic.h"
+#include "mm/kheap.h"
+#include "mm/buddy.h"
+#include "mm/paging.h"
+#include "mm/pmm.h"
+#include "mm/vmalloc.h"
+#include "drivers/serial_driver.h"
+#include "multitasking/lock.h"
+#include "multitasking/scheduler.h"
+#include "utils/utils.h"
+
+#define ALIGN_UP(x, a) (((x) + (a) - 1) & ~((a) - 1))
+
+#define CHUNK_DATA(chunk)       ((void *)((uint8_t *)(chunk) + HEAP_CHUNK_HEADER_SIZE))
+#define CHUNK_FROM_DATA(data)   ((heap_chunk_t *)((uint8_t *)(data) - HEAP_CHUNK_HEADER_SIZE))
+#define CHUNK_NEXT(chunk)       ((heap_chunk_t *)((uint8_t *)CHUNK_DATA(chunk) + (chunk)->size))
+#define CHUNK_FOOTER(chunk)     ((size_t *)((uint8_t *)CHUNK_NEXT(chunk) - sizeof(size_t)))
+#define CHUNK_PREV_FOOTER(chunk) ((size_t *)((uint8_t *)(chunk) - sizeof(size_t)))
+
+// Defined in the linker
+extern uint32_t __heap_start;  // end is defined in the linker scrip
+extern uint32_t __heap_end;  // heap_start is defined in the linker script
+heap_t kernel_heap;
+static uint32_t heap_top;  // end of the committed part of the heap (page aligned)
+static kheap_stats_t stats;  // kept up to date on every bin and chunk change, largest_free and fragmentation are computed on query
+static kheap_callsite_t callsites[KHEAP_CALLSITES_MAX];  // open addressed by caller address
+static uint8_t callsite_tracking = 0;
+static lock_t heap_lock;  // taken with interrupts off, the heap is used from interrupt handlers too
+
+/* index of the highest set bit, size must not be 0 */
+static inline uint32_t floor_log2(size_t size) {
+    return 31 - __builtin_clz(size);
+}
+
+static void bin_insert(heap_chunk_t * chunk) {
+    uint32_t bin = floor_log2(chunk->size);
+
+    chunk->previous = NULL;
+    chunk->next = kernel_heap.bins[bin];
+
+    if (chunk->next != NULL)
+        chunk->next->previous = chunk;
+
+    kernel_heap.bins[bin] = chunk;
+    kernel_heap.bins_bitmap |= (1u << bin);
+
+    stats.free_chunks++;
+    stats.free_bytes += chunk->size;
+    stats.free_histogram[bin]++;
+}
+
+static void bin_remove(heap_chunk_t * chunk) {
+    uint32_t bin = floor_log2(chunk->size);
+
+    if (chunk->previous != NULL)
+        chunk->previous->next = chunk->next;
+    else
+        kernel_heap.bins[bin] = chunk->next;
+
+    if (chunk->next != NULL)
+        chunk->next->previous = chunk->previous;
+
+    if (kernel_heap.bins[bin] == NULL)
+        kernel_heap.bins_bitmap &= ~(1u << bin);
+
+    stats.free_chunks--;
+    stats.free_bytes -= chunk->size;
+    stats.free_histogram[bin]--;
+}
+
+/* the callsite table index + 1 of caller, claiming a slot on first use, 0 if the table is full */
+static uint32_t callsite_lookup(void * caller) {
+    uint32_t i = ((uint32_t)caller >> 2) % KHEAP_CALLSITES_MAX;
+
+    for (uint32_t probe = 0; probe < KHEAP_CALLSITES_MAX; probe++) {
+        if (callsites[i].caller == caller)
+            return i + 1;
+
+        if (callsites[i].caller == NULL) {
+            callsites[i].caller = caller;
+            return i + 1;
+        }
+
+        i = (i + 1) % KHEAP_CALLSITES_MAX;
+    }
+
+    return 0;
+}
+
+/* account a chunk that just became used, charging it to caller if tracking is on */
+static void stats_chunk_used(heap_chunk_t * chunk, void * caller) {
+    stats.bytes_in_use += chunk->size;
+    stats.chunks_in_use++;
+    stats.total_allocs++;
+    stats.used_histogram[floor_log2(chunk->size)]++;
+
+    if (stats.bytes_in_use > stats.peak_bytes_in_use)
+        stats.peak_bytes_in_use = stats.bytes_in_use;
+
+    chunk->flags &= ~CHUNK_CALLSITE_MASK;
+
+    if (callsite_tracking) {
+        uint32_t index = callsite_lookup(caller);
+
+        if (index != 0) {
+            callsites[index - 1].allocs++;
+            callsites[index - 1].live_chunks++;
+            callsites[index - 1].live_bytes += chunk->size;
+            chunk->flags |= index << CHUNK_CALLSITE_SHIFT;
+        }
+    }
+}
+
+/* account a used chunk that is about to be released */
+static void stats_chunk_released(heap_chunk_t * chunk) {
+    uint32_t index = (chunk->flags & CHUNK_CALLSITE_MASK) >> CHUNK_CALLSITE_SHIFT;
+
+    stats.bytes_in_use -= chunk->size;
+    stats.chunks_in_use--;
+    stats.total_frees++;
+    stats.used_histogram[floor_log2(chunk->size)]--;
+
+    /* charged chunks are settled even after tracking was turned off, so the live counts stay exact */
+    if (index != 0) {
+        callsites[index - 1].live_chunks--;
+        callsites[index - 1].live_bytes -= chunk->size;
+        chunk->flags &= ~CHUNK_CALLSITE_MASK;
+    }
+}
+
+/* turn chunk into a free chunk: write its boundary tag, tell the next chunk and bin it */
+static void chunk_make_free(heap_chunk_t * chunk) {
+    chunk->flags &= ~CHUNK_IN_US;
+    *CHUNK_FOOTER(chunk) = chunk->size;
+    CHUNK_NEXT(chunk)->flags &= ~CHUNK_PREV_IN_US;
+
+    bin_insert(chunk);
+}
+
+/* find a free chunk with at least size bytes of user data, NULL if there is none */
+static heap_chunk_t * find_free_chunk(size_t size) {
+    uint32_t bin = floor_log2(size);
+
+    /* every chunk in a bin above the size's own bin is big enough, so take the first one */
+    uint32_t first_fitting_bin = ((size & (size - 1)) == 0) ? bin : bin + 1;
+    uint32_t mask = (first_fitting_bin < HEAP_BINS_COUNT) ? kernel_heap.bins_bitmap & (~0u << first_fitting_bin) : 0;
+
+    if (mask != 0)
+        return kernel_heap.bins[__builtin_ctz(mask)];
+
+    /* last resort (the heap is nearly full), the size's own bin may still hold a big enough chunk */
+    for (heap_chunk_t * current = kernel_heap.bins[bin]; current != NULL; current = current->next)
+        if (current->size >= size)
+            return current;
+
+    return NULL;
+}
+
+void print_heap_status() {
+    printf("--- Kernel Heap Status ---\n");
+
+    if (kernel_heap.heap_first == NULL) {
+        printf("Heap is empty or uninitialized.\n");
+        return;
+    }
+
+    uint32_t eflags = lock_acquire_irqsave(&heap_lock);
+
+    heap_chunk_t *current_chunk = kernel_heap.heap_first;
+    uint32_t chunk_count = 0;
+
+    while (current_chunk != kernel_heap.heap_end) {
+        chunk_count++;
+
+        printf("Chunk #%d at address: %p\n", chunk_count, (uint32_t)current_chunk);
+
+        printf("  Status: ");
+        if (current_chunk->flags & CHUNK_IN_US) {
+            printf("USED");
+        } else {
+            printf("FREE (bin %d)", floor_log2(current_chunk->size));
+        }
+        printf("\n");
+
+        printf("  User Data Size: 0x%x bytes\n", current_chunk->size);
+
+        printf("\n");
+
+        // Move to the next chunk in address order
+        current_chunk = CHUNK_NEXT(current_chunk);
+    }
+
+    lock_release_irqrestore(&heap_lock, eflags);
+
+    printf("--- End of Heap Status (Total Chunks: %d, Bins Bitmap: 0x%x) ---\n", chunk_count, kernel_heap.bins_bitmap);
+}
+
+static void release_pages(uint32_t start, uint32_t end) {
+    uint32_t vaddr = start;
+
+    while (vaddr < end) {
+        /* 4 MiB pages come from the buddy allocator, and are only ever released whole */
+        if (paging_is_large_page((void *)vaddr)) {
+            buddy_free(paging_get_mapping((void *)vaddr), BUDDY_MAX_ORDER);
+            paging_unmap_large_page((void *)vaddr);
+            vaddr += LARGE_PAGE_SIZE;
+            continue;
+        }
+
+        uint32_t run_start = vaddr;
+        for (; vaddr < end && !paging_is_large_page((void *)vaddr); vaddr += PAGE_SIZE)
+            pmm_free_frame(paging_get_mapping((void *)vaddr));
+
+        paging_unmap_range((void *)run_start, vaddr - run_start);
+    }
+}
+
+/* back [start, end) with fresh frames, 0 - success, 1 - out of memory (nothing stays mapped) */
+static uint8_t commit_pages(uint32_t start, uint32_t end) {
+    uint32_t vaddr = start;
+
+    while (vaddr < end) {
+        /* an aligned 4 MiB stretch is backed by one large page (one TLB entry) if the buddy allocator has a block */
+        if ((vaddr & (LARGE_PAGE_SIZE - 1)) == 0 && end - vaddr >= LARGE_PAGE_SIZE && paging_large_pages_enabled()) {
+            void * block = buddy_alloc(BUDDY_MAX_ORDER);
+
+            if (block != NULL && paging_map_large_page((void *)vaddr, block, PG_WRITABLE | PG_PRESENT) == 0) {
+                vaddr += LARGE_PAGE_SIZE;
+                continue;
+            }
+
+            buddy_free(block, BUDDY_MAX_ORDER);
+        }
+
+        void * paddr = pmm_alloc_frame();
+
+        if (paddr == NULL) {
+            release_pages(start, vaddr);
+            return 1;
+        }
+
+        paging_map_page((void *)vaddr, paddr, PG_WRITABLE | PG_PRESENT);
+        vaddr += PAGE_SIZE;
+    }
+
+    return 0;
+}
+
+/* place the end fence (a zero sized used chunk) right below heap_top, so coalescing never walks past the heap */
+static heap_chunk_t * place_end_fence() {
+    heap_chunk_t * end_fence = (heap_chunk_t *)(heap_top - HEAP_CHUNK_HEADER_SIZE);
+    end_fence->size = 0;
+    end_fence->flags = CHUNK_IN_US;
+
+    kernel_heap.heap_end = end_fence;
+    return end_fence;
+}
+
+/* mark a used chunk as free, merging it with its free neighbours, returns the resulting free chunk */
+static heap_chunk_t * chunk_release(heap_chunk_t * chunk) {
+    /* assimilate the next chunk into the current chunk if it is free */
+    heap_chunk_t * next = CHUNK_NEXT(chunk);
+    if (!(next->flags & CHUNK_IN_US)) {
+        bin_remove(next);
+        chunk->size += HEAP_CHUNK_HEADER_SIZE + next->size;
+    }
+
+    /* assimilate the current chunk into the previous chunk if it is free,
+       the previous chunk is found by its boundary tag */
+    if (!(chunk->flags & CHUNK_PREV_IN_US)) {
+        size_t previous_size = *CHUNK_PREV_FOOTER(chunk);
+        heap_chunk_t * previous = (heap_chunk_t *)((uint8_t *)chunk - previous_size - HEAP_CHUNK_HEADER_SIZE);
+
+        bin_remove(previous);
+        previous->size += HEAP_CHUNK_HEADER_SIZE + chunk->size;
+        chunk = previous;
+    }
+
+    chunk_make_free(chunk);
+
+    return chunk;
+}
+
+/* give the pages under a big free chunk at the end of the heap back to the pmm */
+static void heap_trim(heap_chunk_t * last_chunk) {
+    uint32_t keep_top = ALIGN_UP((uint32_t)CHUNK_DATA(last_chunk) + HEAP_MIN_CHUNK_SIZE + HEAP_CHUNK_HEADER_SIZE, PAGE_SIZE);
+
+    if (keep_top < (uint32_t)&__heap_start + KHEAP_INITIAL_COMMIT)
+        keep_top = (uint32_t)&__heap_start + KHEAP_INITIAL_COMMIT;
+
+    /* a 4 MiB page can not be split, keep all of it */
+    if (paging_is_large_page((void *)keep_top))
+        keep_top = ALIGN_UP(keep_top, LARGE_PAGE_SIZE);
+
+    if (heap_top <= keep_top || heap_top - keep_top < KHEAP_TRIM_THRESHOLD)
+        return;
+
+    bin_remove(last_chunk);
+
+    release_pages(keep_top, heap_top);
+    heap_top = keep_top;
+
+    heap_chunk_t * end_fence = place_end_fence();
+    last_chunk->size = (uint8_t *)end_fence - (uint8_t *)CHUNK_DATA(last_chunk);
+
+    chunk_make_free(last_chunk);
+}
+
+void heap_init(){
+    lock_init(&heap_lock);
+    memset(&stats, 0, sizeof(kheap_stats_t));
+    memset(callsites, 0, sizeof(callsites));
+
+    for (uint32_t b = 0; b < HEAP_BINS_COUNT; b++)
+        kernel_heap.bins[b] = NULL;
+    kernel_heap.bins_bitmap = 0;
+
+    /* the whole heap range is reserved by the linker, only the first pages are backed now */
+    heap_top = (uint32_t)&__heap_start;
+    if (commit_pages(heap_top, heap_top + KHEAP_INITIAL_COMMIT) != 0)
+        PANIC("No memory for the initial heap");
+    heap_top += KHEAP_INITIAL_COMMIT;
+
+    heap_chunk_t * end_fence = place_end_fence();
+
+    /* the first chunk has no previous chunk, so treat it as used */
+    heap_chunk_t * first_chunk = (heap_chunk_t *)(&__heap_start);
+    first_chunk->size = (uint8_t *)end_fence - (uint8_t *)CHUNK_DATA(first_chunk);
+    first_chunk->flags = CHUNK_PREV_IN_US;
+
+    kernel_heap.heap_first = first_chunk;
+
+    chunk_make_free(first_chunk);
+}
+
+static uint8_t heap_expand(size_t size) {
+    uint32_t old_top = heap_top;
+    uint32_t new_top = ALIGN_UP(old_top + size, PAGE_SIZE);
+
+    if (new_top > (uint32_t)&__heap_end || new_top < old_top)
+        return 1;  /* out of the reserved heap range */
+
+    if (commit_pages(old_top, new_top) != 0)
+        return 1;
+
+    heap_top = new_top;
+
+    /* the old end fence becomes the header of a chunk covering the new memory,
+       release it so it merges with a free chunk that was at the end of the heap */
+    heap_chunk_t * chunk = kernel_heap.heap_end;
+    heap_chunk_t * end_fence = place_end_fence();
+
+    chunk->size = (uint8_t *)end_fence - (uint8_t *)CHUNK_DATA(chunk);
+    chunk_release(chunk);
+
+    return 0;
+}
+
+uint8_t kheap_expand(size_t size) {
+    uint32_t eflags = lock_acquire_irqsave(&heap_lock);
+    uint8_t result = heap_expand(size);
+    lock_release_irqrestore(&heap_lock, eflags);
+
+    return result;
+}
+
+size_t kheap_committed_size() {
+    return heap_top - (uint32_t)&__heap_start;
+}
+
+/* use chunk (already out of its bin) for size bytes: split the tail off if it is big enough and mark it used */
+static void * chunk_take(heap_chunk_t * chunk, size_t size, void * caller) {
+    /* split the tail off if it is big enough to be a chunk on its own */
+    if (chunk->size >= size + HEAP_CHUNK_HEADER_SIZE + HEAP_MIN_CHUNK_SIZE) {
+        heap_chunk_t * rest = (heap_chunk_t *)((uint8_t *)CHUNK_DATA(chunk) + size);
+        rest->size = chunk->size - size - HEAP_CHUNK_HEADER_SIZE;
+        rest->flags = CHUNK_PREV_IN_US;
+        chunk->size = size;
+
+        chunk_make_free(rest);
+    } else {
+        CHUNK_NEXT(chunk)->flags |= CHUNK_PREV_IN_US;
+    }
+
+    chunk->flags |= CHUNK_IN_US;
+    stats_chunk_used(chunk, caller);
+
+    return CHUNK_DATA(chunk);
+}
+
+/* round size to the heap granularity, 0 if it can never be served */
+static size_t normalize_size(size_t size) {
+    if (size > KHEAP_MAX_SIZE)
+        return 0;
+
+    size = ALIGN_UP(size, HEAP_ALIGNMENT);
+    if (size < HEAP_MIN_CHUNK_SIZE)
+        size = HEAP_MIN_CHUNK_SIZE;
+
+    return size;
+}
+
+/* find a free chunk of at least size bytes, growing the heap if needed, and take it out of its bin */
+static heap_chunk_t * claim_free_chunk(size_t size) {
+    heap_chunk_t * chunk = find_free_chunk(size);
+
+    if (chunk == NULL) {
+        size_t expand_size = size + HEAP_CHUNK_HEADER_SIZE;
+        if (expand_size < KHEAP_EXPAND_MIN)
+            expand_size = KHEAP_EXPAND_MIN;
+
+        if (heap_expand(expand_size) != 0)
+            return NULL; // faild to allocate memoy
+
+        chunk = find_free_chunk(size);
+        if (chunk == NULL)
+            return NULL;
+    }
+
+    bin_remove(chunk);
+
+    return chunk;
+}
+
+/* magazine size class of a chunk size, -1 if chunks of that size are not cached */
+static int32_t magazine_class(size_t size) {
+    if (size > KHEAP_MAGAZINE_MAX_SIZE || (size & (size - 1)) != 0)
+        return -1;
+
+    return floor_log2(size) - floor_log2(HEAP_MIN_CHUNK_SIZE);
+}
+
+kheap_magazine_t * kheap_current_magazine() {
+    process_t * current = scheduler_get_current_process();
+
+    return current != NULL ? &current->heap_magazine : NULL;
+}
+
+/* a cached chunk of class size_class from the running thread's magazine, charged to caller, NULL if there is none */
+static void * magazine_pop(int32_t size_class, void * caller) {
+    void * pointer = NULL;
+
+    /* interrupt handlers use the magazine of the thread they interrupted */
+    uint32_t eflags = irq_save();
+    kheap_magazine_t * magazine = kheap_current_magazine();
+
+    if (magazine != NULL) {
+        if (magazine->counts[size_class] != 0) {
+            pointer = magazine->rounds[size_class][--magazine->counts[size_class]];
+            magazine->hits++;
+
+            /* a reused chunk is a new allocation of a new caller */
+            lock_acquire(&heap_lock);
+            stats_chunk_used(CHUNK_FROM_DATA(pointer), caller);
+            lock_release(&heap_lock);
+        } else {
+            magazine->misses++;
+        }
+    }
+    irq_restore(eflags);
+
+    return pointer;
+}
+
+/* cache a used chunk in the running thread's magazine, 0 - cached, 1 - the magazine is full (or there is none) */
+static uint8_t magazine_push(int32_t size_class, void * pointer) {
+    uint8_t result = 1;
+
+    uint32_t eflags = irq_save();
+    kheap_magazine_t * magazine = kheap_current_magazine();
+
+    if (magazine != NULL) {
+        for (uint32_t i = 0; i < magazine->counts[size_class]; i++)
+            if (magazine->rounds[size_class][i] == pointer) PANIC("kfree of a chunk that is already freed");
+
+        if (magazine->counts[size_class] < KHEAP_MAGAZINE_ROUNDS) {
+            magazine->rounds[size_class][magazine->counts[size_class]++] = pointer;
+            result = 0;
+
+            /* the caller is done with it, a cached chunk is not counted as in use */
+            lock_acquire(&heap_lock);
+            stats_chunk_released(CHUNK_FROM_DATA(pointer));
+            lock_release(&heap_lock);
+        }
+    }
+    irq_restore(eflags);
+
+    return result;
+}
+
+static void * heap_alloc(size_t size, void * caller) {
+    size = normalize_size(size);
+    if (size == 0)
+        return NULL;
+
+    /* small requests are rounded to a power of two, so any cached chunk of the class fits them */
+    if (size <= KHEAP_MAGAZINE_MAX_SIZE) {
+        size = 1u << (floor_log2(size - 1) + 1);
+
+        void * cached = magazine_pop(magazine_class(size), caller);
+        if (cached != NULL)
+            return cached;
+    }
+
+    void * pointer = NULL;
+    uint32_t eflags = lock_acquire_irqsave(&heap_lock);
+
+    heap_chunk_t * chunk = claim_free_chunk(size);
+    if (chunk != NULL)
+        pointer = chunk_take(chunk, size, caller);
+
+    lock_release_irqrestore(&heap_lock, eflags);
+
+    return pointer;
+}
+
+/*
+ * Take a chunk big enough to hold size bytes at any alignment, then cut the
+ * unaligned head off as a free chunk of its own, so only the tail split of a
+ * normal allocation remains and nothing stays wasted while the block lives.
+ */
+static void * heap_alloc_aligned(size_t size, size_t align, void * caller) {
+    size = normalize_size(size);
+    if (size == 0)
+        return NULL;
+
+    uint32_t eflags = lock_acquire_irqsave(&heap_lock);
+
+    heap_chunk_t * chunk = claim_free_chunk(size + align + HEAP_CHUNK_HEADER_SIZE + HEAP_MIN_CHUNK_SIZE);
+    if (chunk == NULL) {
+        lock_release_irqrestore(&heap_lock, eflags);
+        return NULL;
+    }
+
+    uint32_t data = (uint32_t)CHUNK_DATA(chunk);
+    uint32_t aligned = ALIGN_UP(data, align);
+
+    if (aligned != data) {
+        /* the head has to be large enough to be a free chunk */
+        while (aligned - data < HEAP_CHUNK_HEADER_SIZE + HEAP_MIN_CHUNK_SIZE)
+            aligned += align;
+
+        heap_chunk_t * body = CHUNK_FROM_DATA(aligned);
+        body->size = chunk->size - (aligned - data);
+        body->flags = CHUNK_NOT_IN_US;  // the head before it becomes free
+
+        /* the chunk before the head is used (free chunks never touch), so the head is not merged */
+        chunk->size = aligned - data - HEAP_CHUNK_HEADER_SIZE;
+        chunk_make_free(chunk);
+
+        chunk = body;
+    }
+
+    void * pointer = chunk_take(chunk, size, caller);
+    lock_release_irqrestore(&heap_lock, eflags);
+
+    return pointer;
+}
+
+void* kalloc(size_t size){
+    /* multi page buffers would fragment the heap, they get their own pages instead */
+    if (size >= KHEAP_VMALLOC_THRESHOLD && vmalloc_ready())
+        return vmalloc(size);
+
+    return heap_alloc(size, __builtin_return_address(0));
+}
+
+void* kalloc_heap(size_t size){
+    return heap_alloc(size, __builtin_return_address(0));
+}
+
+void* kalloc_aligned(size_t size, size_t align){
+    if (align == 0 || (align & (align - 1)) || align > KHEAP_MAX_ALIGN)
+        return NULL;
+
+    /* vmalloc areas start on a page */
+    if (size >= KHEAP_VMALLOC_THRESHOLD && align <= PAGE_SIZE && vmalloc_ready())
+        return vmalloc(size);
+
+    if (align <= HEAP_ALIGNMENT)
+        return heap_alloc(size, __builtin_return_address(0));
+
+    return heap_alloc_aligned(size, align, __builtin_return_address(0));
+}
+
+void* kalloc_phys(size_t size, size_t align, uint32_t * phys){
+    if (size == 0 || size > PAGE_SIZE || align == 0 || (align & (align - 1)) || align > PAGE_SIZE)
+        return NULL;
+
+    /* a block aligned to its own power of two size never crosses a page, so its frame covers all of it */
+    size_t span = HEAP_MIN_CHUNK_SIZE;
+    while (span < size)
+        span <<= 1;
+    if (span > align)
+        align = span;
+
+    /* span is at least HEAP_MIN_CHUNK_SIZE, more than HEAP_ALIGNMENT, so this is always an aligned request */
+    void * vaddr = heap_alloc_aligned(size, align, __builtin_return_address(0));
+    if (vaddr == NULL)
+        return NULL;
+
+    if (phys != NULL)
+        *phys = (uint32_t)paging_get_mapping(vaddr) | ((uint32_t)vaddr & (PAGE_SIZE - 1));
+
+    return vaddr;
+}
+
+/* put a chunk that is already out of the counters into the bins, the heap lock must be held */
+static void heap_release(heap_chunk_t * chunk) {
+    chunk = chunk_release(chunk);
+
+    if (CHUNK_NEXT(chunk) == kernel_heap.heap_end)
+        heap_trim(chunk);
+}
+
+/* release a used chunk into the bins, the heap lock must be held */
+static void heap_free(heap_chunk_t * chunk) {
+    stats_chunk_released(chunk);
+    heap_release(chunk);
+}
+
+void kfree(void * user_pointer) {
+    if (user_pointer == NULL) return;
+
+    if (is_vmalloc_addr(user_pointer)) {
+        vfree(user_pointer);
+        return;
+    }
+
+    heap_chunk_t * chunk = CHUNK_FROM_DATA(user_pointer);
+
+    if (!(chunk->flags & CHUNK_IN_US)) PANIC("kfree of a chunk that is not in use");
+
+    int32_t size_class = magazine_class(chunk->size);
+    if (size_class >= 0 && magazine_push(size_class, user_pointer) == 0)
+        return;
+
+    uint32_t eflags = lock_acquire_irqsave(&heap_lock);
+    heap_free(chunk);
+    lock_release_irqrestore(&heap_lock, eflags);
+}
+
+void kheap_magazine_flush(kheap_magazine_t * magazine) {
+    if (magazine == NULL) return;
+
+    uint32_t eflags = lock_acquire_irqsave(&heap_lock);
+
+    for (uint32_t c = 0; c < KHEAP_MAGAZINE_CLASSES; c++) {
+        while (magazine->counts[c] != 0)
+            heap_release(CHUNK_FROM_DATA(magazine->rounds[c][--magazine->counts[c]]));  /* counted as released when cached */
+    }
+
+    lock_release_irqrestore(&heap_lock, eflags);
+}
+
+void kheap_get_stats(kheap_stats_t * out) {
+    uint32_t eflags = lock_acquire_irqsave(&heap_lock);
+
+    memcpy(out, &stats, sizeof(kheap_stats_t));
+
+    /* every chunk in the highest non empty bin is bigger than the chunks in the lower bins */
+    out->largest_free = 0;
+    if (kernel_heap.bins_bitmap != 0)
+        for (heap_chunk_t * current = kernel_heap.bins[floor_log2(kernel_heap.bins_bitmap)]; current != NULL; current = current->next)
+            if (current->size > out->largest_free)
+                out->largest_free = current->size;
+
+    lock_release_irqrestore(&heap_lock, eflags);
+
+    out->fragmentation = (out->free_bytes != 0) ? 100 - out->largest_free * 100 / out->free_bytes : 0;
+}
+
+void kheap_set_callsite_tracking(uint8_t enable) {
+    callsite_tracking = enable;
+}
+
+uint32_t kheap_get_callsites(kheap_callsite_t * out, uint32_t max) {
+    uint32_t count = 0;
+    uint32_t eflags = lock_acquire_irqsave(&heap_lock);
+
+    for (uint32_t i = 0; i < KHEAP_CALLSITES_MAX && count < max; i++)
+        if (callsites[i].caller != NULL)
+            out[count++] = callsites[i];
+
+    lock_release_irqrestore(&heap_lock, eflags);
+
+    return count;
+}
+
+void kheap_dump_stats() {
+    kheap_stats_t snapshot;
+    kheap_get_stats(&snapshot);
+
+    serial_printf("--- Kernel Heap Stats ---\n");
+    serial_printf("committed 0x%x, in use 0x%x in %d chunks, peak 0x%x\n",
+                  kheap_committed_size(), snapshot.bytes_in_use, snapshot.chunks_in_use, snapshot.peak_bytes_in_use);
+    serial_printf("free 0x%x in %d chunks, largest free 0x%x, fragmentation %d%%\n",
+                  snapshot.free_bytes, snapshot.free_chunks, snapshot.largest_free, snapshot.fragmentation);
+    serial_printf("allocs %d, frees %d, vmalloc in use 0x%x\n",
+                  snapshot.total_allocs, snapshot.total_frees, vmalloc_used_size());
+
+    serial_printf("size class: used / free chunks\n");
+    for (uint32_t b = 0; b < HEAP_BINS_COUNT; b++)
+        if (snapshot.used_histogram[b] != 0 || snapshot.free_histogram[b] != 0)
+            serial_printf("  [0x%x, 0x%x): %d / %d\n", 1u << b, 2u << b, snapshot.used_histogram[b], snapshot.free_histogram[b]);
+
+    serial_printf("callsites (tracking %s): caller allocs live_chunks live_bytes\n", callsite_tracking ? "on" : "off");
+    for (uint32_t i = 0; i < KHEAP_CALLSITES_MAX; i++)
+        if (callsites[i].caller != NULL)
+            serial_printf("  %p %d %d 0x%x\n", callsites[i].caller, callsites[i].allocs, callsites[i].live_chunks, callsites[i].live_bytes);
+
+    serial_printf("--- End of Kernel Heap Stats ---\n");
 }
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "kernel/panic.h"
+#include "mm/page.h"
+#include "mm/paging.h"
+#include "mm/pmm.h"
+#include "utils/utils.h"
+
+#define ALIGN_UP(x, a) (((x) + (a) - 1) & ~((a) - 1))
+
+/* Symbols provided by the linker */
+extern uint32_t __kernel_end_v_no_heap;
+
+_Static_assert(sizeof(page_t) <= 16, "page_t must stay within 16 bytes per frame");
+
+static page_t * pages;  /* NULL until page_db_init */
+static uint32_t pages_count;
+
+void page_db_init(uint32_t frames_count) {
+    if (frames_count > PAGE_DB_VIRT_SIZE / sizeof(page_t))
+        frames_count = PAGE_DB_VIRT_SIZE / sizeof(page_t);
+
+    uint32_t size = ALIGN_UP(frames_count * sizeof(page_t), PAGE_SIZE);
+
+    for (uint32_t offset = 0; offset < size; offset += PAGE_SIZE) {
+        void * frame = pmm_alloc_frame();
+        if (frame == NULL) PANIC("No memory for the page descriptors");
+
+        paging_map_page((void *)(PAGE_DB_VIRT_START + offset), frame, PG_PRESENT | PG_WRITABLE);
+    }
+
+    pages = (page_t *)PAGE_DB_VIRT_START;
+    memset(pages, 0, size);
+
+    /* everything the pmm handed out so far has exactly one user, the kernel image and low memory never move */
+    uint32_t pinned_end = ((uint32_t)&__kernel_end_v_no_heap - 0xC0000000) / PAGE_SIZE;
+
+    for (uint32_t frame = 0; frame < frames_count; frame++) {
+        if (!pmm_is_frame_used(frame * PAGE_SIZE)) continue;
+
+        pages[frame].refcount = 1;
+        if (frame < pinned_end)
+            pages[frame].flags = PAGE_PINNED;
+    }
+
+    pages_count = frames_count;
+}
+
+uint32_t page_db_frames_count() {
+    return pages_count;
+}
+
+page_t * page_from_frame(uint32_t paddr) {
+    uint32_t frame = paddr / PAGE_SIZE;
+
+    if (pages == NULL || frame >= pages_count) return NULL;
+
+    return &pages[frame];
+}
+
+uint32_t page_to_frame(page_t * page) {
+    return (uint32_t)(page - pages) * PAGE_SIZE;
+}
+
+void page_get(uint32_t paddr) {
+    page_t * page = page_from_frame(paddr);
+    if (page == NULL) return;
+
+    if (page->refcount == 0) PANIC("page_get of a free frame");
+    if (page->refcount == 0xFFFF) PANIC("Frame reference count overflow");
+
+    page->refcount++;
+}
+
+uint16_t page_put(uint32_t paddr) {
+    page_t * page = page_from_frame(paddr);
+    if (page == NULL || page->refcount == 0) return 0;
+
+    return --page->refcount;
+}
+
+void page_list_add_tail(page_list_t * list, page_t * page) {
+    page->lru_next = NULL;
+    page->lru_previous = list->tail;
+
+    if (list->tail != NULL)
+        list->tail->lru_next = page;
+    else
+        list->head = page;
+
+    list->tail = page;
+    list->count++;
+}
+
+void page_list_remove(page_list_t * list, page_t * page) {
+    if (page->lru_previous != NULL)
+        page->lru_previous->lru_next = page->lru_next;
+    else
+        list->head = page->lru_next;
+
+    if (page->lru_next != NULL)
+        page->lru_next->lru_previous = page->lru_previous;
+    else
+        list->tail = page->lru_previous;
+
+    page->lru_previous = NULL;
+    page->lru_next = NULL;
+    list->count--;
+}
+
+page_t * page_list_pop_head(page_list_t * list) {
+    page_t * page = list->head;
+
+    if (page != NULL)
+        page_list_remove(list, page);
+
+    return page;
+}
\ No newline at end of file
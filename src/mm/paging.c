@@ -1,217 +1,817 @@
-#include "kernel/print.h"
-#include "kernel/panic.h"
-#include "mm/paging.h"
-#include "mm/pmm.h"
-#include "mm/kheap.h"
-#include "utils/utils.h"
-#include "errno.h"
-
-// paging breaks down a linear address: | Table Entry (10 bits) | Page Entry (10 bits) | Offset (12 bits) |
-#define PAGE_OFFSET(addr)  (addr & 0xFFF)
-#define PAGE_INDEX(addr)   ((addr >> 12) & 0x3FF)
-#define TABLE_INDEX(addr)  ((addr >> 22) & 0x3FF)
-#define PAGE_MASK(addr)    (addr & 0xFFFFF000) 
-
-__attribute__((aligned(0x1000))) page_directory_t kernel_page_directory;
-__attribute__((aligned(0x1000))) page_table_t kernel_page_tables[PAGING_ENTRIES_SIZE];
-
-static page_directory_t * current_directory;
-
-/* Symbols provided by the linker */
-extern uint32_t __kernel_end;
-extern uint32_t __kernel_start_v;
-extern uint32_t __kernel_end_v_no_heap;
-
-void static print_page_directory(page_directory_t* dir) {
-    print_clean_screen();
-
-    printf("Page Directory Table:\n");
-    printf("====================\n");
-
-    for (uint32_t pd_idx = 0; pd_idx < PAGING_ENTRIES_SIZE; pd_idx++) {
-        page_table_t* table = dir->tables[pd_idx];
-        if (!table) continue; // skip empty tables
-
-        printf("PD Entry %d: Table at %x\n", pd_idx, (uint32_t)table);
-
-        // Print table header
-        printf("  PT Index | Present | R/W | User | Frame\n");
-        printf("  --------------------------------------\n");
-
-        for (uint32_t pt_idx = 0; pt_idx < PAGING_ENTRIES_SIZE; pt_idx++) {
-            page_entry_t* entry = &table->entries[pt_idx];
-
-            if (!entry->present) continue; // skip not-present pages
-
-            printf("  %d        | ", pt_idx);
-
-            // Present
-            printf("%d       | ", entry->present);
-
-            // R/W
-            printf("%d   | ", entry->rw);
-
-            // User
-            printf("%d    | ", entry->user);
-
-            // Frame
-            printf("%x\n", entry->frame);
-        }
-
-        printf("\n");
-    }
-
-    printf("====================\n");
-    printf("End of page directory\n");
-}
-
-void paging_init() {
-    /* register fault handle first, so in case of error will found the problem fast */
-    register_interrupt_handler(13, general_protection_fault_handler);
-    register_interrupt_handler(14, page_fault_handler);
-
-    /* there is a need to setup this before the use of paging_map_page */
-    current_directory = &kernel_page_directory;
-    kernel_page_directory.physical_addr = ((uint32_t)kernel_page_directory.tables_physical) - 0xC0000000;
-
-    /* setup kernel tables */
-    for (size_t t = 0; t < PAGING_ENTRIES_SIZE; t++) {
-        kernel_page_directory.tables[t] = (page_table_t *)(&(kernel_page_tables[t]));  // pointer in linear address space
-        kernel_page_directory.tables_physical[t] = (PAGE_MASK((uint32_t)(&(kernel_page_tables[t]))) - 0xC0000000) | PG_WRITABLE | PG_PRESENT;  // physical address for CR3 / PDEs
-    }
-
-    /* map kernel to higher memory and  */
-    for (uint32_t vaddr = (uint32_t)&__kernel_start_v; vaddr < (uint32_t)&__kernel_end; vaddr += PAGE_SIZE) 
-        paging_map_page((void *)vaddr, (void *)(vaddr - 0xC0000000), PG_PRESENT | PG_WRITABLE);
-    
-    /* map the last page to the text screen mmio */
-    paging_map_page((void *)0xFFFFF000, (void *)0xB8000, PG_PRESENT | PG_WRITABLE); /* test screen mmio size = 2*80*25 = 4000 < 4096 */
-
-    switch_page_directory(&kernel_page_directory);
-}
-
-void switch_page_directory(page_directory_t * dir) {
-    current_directory = dir;
-    asm volatile("mov %0, %%cr3":: "r"(dir->physical_addr));
-    uint32_t cr0;
-    asm volatile("mov %%cr0, %0": "=r"(cr0));
-    cr0 |= 0x80000000; // Enable paging!
-    asm volatile("mov %0, %%cr0":: "r"(cr0));
-}
-
-uint32_t page_fault_handler(cpu_status_t* regs) {
-    // A page fault has occurred.
-    // The faulting address is stored in the CR2 register.
-    uint32_t faulting_address;
-    asm volatile("mov %%cr2, %0" : "=r" (faulting_address));
-
-    // The error code gives us details of what happened.
-    int not_present   = !(regs->err_code & 0x1); // Page not present
-    int rw = regs->err_code & 0x2;           // Write operation?
-    int us = regs->err_code & 0x4;           // Processor was in user-mode?
-    int reserved = regs->err_code & 0x8;     // Overwritten CPU-reserved bits of page entry?
-    int id = regs->err_code & 0x10;          // Caused by an instruction fetch?
-
-    // Output an error message.
-    printf("Page fault! ( ");
-    if (not_present) {printf(" not_present ");}
-    if (rw) {printf("read-only ");}
-    if (us) {printf("user-mode ");}
-    if (reserved) {printf("reserved ");}
-    printf(") at %p. eip is %p\n", faulting_address, regs->eip);
-    PANIC("Page fault");
-
-    return -EPF;
-}
-
-uint32_t general_protection_fault_handler(cpu_status_t* regs) {
-    // Error code format for #GP:
-    // bit 0: EXT  (1 = came from external event, 0 = from software)
-    // bits 1-2: IDT (1 = IDT, 2 = LDT, 3 = GDT)
-    // bits 3-15: selector index (if EXT = 0)
-
-    uint32_t err = regs->err_code;
-
-    int ext = err & 0x1;
-    int table = (err >> 1) & 0x3;      // 0,1,2,3
-    uint16_t selector = err >> 3;      // selector index
-
-    printf("General Protection Fault! ( ");
-
-    if (ext) {
-        printf("external ");
-    } else {
-        printf("software ");
-    }
-
-    switch (table) {
-        case 0:
-            printf("GDT ");
-            break;
-        case 1:
-            printf("IDT ");
-            break;
-        case 2:
-            printf("LDT ");
-            break;
-        case 3:
-            printf("reserved-table ");
-            break;
-    }
-
-    if (!ext) {
-        printf("selector=%#x ", selector);
-    }
-
-    printf(") at eip=%p\n", regs->eip);
-
-    PANIC("General Protection Fault");
-
-    return -EGPF;
-}
-
-void paging_map_page(void* vaddr, void* paddr, uint32_t page_flags) {
-    uint32_t temp_addr;
-
-    /* mark paddr if not marked already */
-    pmm_alloc_frame_addr((void *)PAGE_MASK((uint32_t)paddr));
-
-    /* check if there is a table for vaddr */
-    page_table_t * table = current_directory->tables[TABLE_INDEX((uint32_t)vaddr)];
-    
-    if (table == NULL) PANIC("No table was found for this addr");
-
-    page_entry_t * entry = &table->entries[PAGE_INDEX((uint32_t)vaddr)];
-
-    entry->present  = page_flags & PG_PRESENT;
-    entry->rw       = page_flags & PG_WRITABLE;
-    entry->user     = page_flags & PG_USER;
-    entry->accessed = page_flags & PG_ACCESSED;
-    entry->dirty    = page_flags & PG_DIRTY;
-    entry->unused   = (page_flags & 0xFE0) >> 5;
-    entry->frame    = (uint32_t)paddr >> 12;
-}
-
-void paging_unmap_page(void* vaddr) {
-    /* check if there is a table for vaddr */
-    /* FIX: there may be a memory leak, since we don't free the tables */
-    page_table_t * t = current_directory->tables[TABLE_INDEX((uint32_t)vaddr)];
-
-    if (t == NULL) return; /* no need to un-map */
-
-    /* unmap the page */
-    page_entry_t * p = &(current_directory->tables[TABLE_INDEX((uint32_t)vaddr)]->entries[PAGE_INDEX((uint32_t)vaddr)]);
-    memset(p, 0, sizeof(page_entry_t));
-}
-
-void* paging_get_mapping(void* vaddr) {
-    page_table_t * t = current_directory->tables[TABLE_INDEX((uint32_t)vaddr)];
-
-    if (t == NULL) return NULL;
-
-    return (void*)(t->entries[PAGE_INDEX((uint32_t)vaddr)].frame << 12);
-}
-
-page_directory_t * paging_get_current_directory() {
-    return current_directory;
+#include "kernel/print.h"
+#include "kernel/panic.h"
+#include "mm/paging.h"
+#include "mm/pmm.h"
+#include "mm/page.h"
+#include "mm/tlb.h"
+#include "mm/vm_region.h"
+#include "mm/kheap.h"
+#include "mm/slab.h"
+#include "mm/swap.h"
+#include "multitasking/lock.h"
+#include "utils/utils.h"
+#include "errno.h"
+
+// paging breaks down a linear address: | Table Entry (10 bits) | Page Entry (10 bits) | Offset (12 bits) |
+#define PAGE_OFFSET(addr)  (addr & 0xFFF)
+#define PAGE_INDEX(addr)   ((addr >> 12) & 0x3FF)
+#define TABLE_INDEX(addr)  ((addr >> 22) & 0x3FF)
+#define PAGE_MASK(addr)    (addr & 0xFFFFF000) 
+#define LARGE_PAGE_MASK(addr) (addr & 0xFFC00000)
+
+#define TABLE_WINDOW_ADDR(table_index) ((page_table_t *)(PAGING_TABLES_WINDOW + (table_index) * PAGE_SIZE))
+
+/* a swapped out entry is not present but still holds a page, it keeps its table alive */
+#define ENTRY_SWAPPED(entry) (!(entry)->present && ((entry)->available & (PG_SWAPPED >> 9)))
+#define ENTRY_IN_USE(entry)  ((entry)->present || ENTRY_SWAPPED(entry))
+
+#define KERNEL_TABLE_INDEX TABLE_INDEX(0xC0000000)  /* first directory slot of the kernel half */
+
+#define PF_PRESENT 0x1  /* the fault was a protection violation on a present page */
+#define PF_WRITE   0x2  /* the fault was a write */
+
+__attribute__((aligned(0x1000))) page_directory_t kernel_page_directory;  /* also the head of the directories list */
+
+static page_directory_t * current_directory;
+static kmem_cache_t * directory_cache;  /* directories made by paging_clone_directory, created on first use */
+static uint32_t temp_eflags;  /* interrupts are off while PAGING_TEMP_PAGE is in use */
+static uint32_t fault_eflags;  /* eflags of the code the innermost page fault interrupted */
+
+/* Symbols provided by the linker */
+extern uint32_t __kernel_start;
+extern uint32_t __kernel_end;
+extern uint32_t __kernel_start_v;
+extern uint32_t __kernel_end_v_no_heap;
+
+extern page_directory_t boot_page_directory;  // defined in boot_ipl.c (lower half)
+
+static page_table_t * create_table(uint32_t table_index, uint32_t page_flags);
+static uint8_t handle_cow_fault(uint32_t addr, uint32_t err_code);
+
+void static print_page_directory(page_directory_t* dir) {
+    print_clean_screen();
+
+    printf("Page Directory Table:\n");
+    printf("====================\n");
+
+    for (uint32_t pd_idx = 0; pd_idx < PAGING_ENTRIES_SIZE; pd_idx++) {
+        page_table_t* table = dir->tables[pd_idx];
+        if (!table) continue; // skip empty tables
+
+        printf("PD Entry %d: Table at %x\n", pd_idx, (uint32_t)table);
+
+        // Print table header
+        printf("  PT Index | Present | R/W | User | Frame\n");
+        printf("  --------------------------------------\n");
+
+        for (uint32_t pt_idx = 0; pt_idx < PAGING_ENTRIES_SIZE; pt_idx++) {
+            page_entry_t* entry = &table->entries[pt_idx];
+
+            if (!entry->present) continue; // skip not-present pages
+
+            printf("  %d        | ", pt_idx);
+
+            // Present
+            printf("%d       | ", entry->present);
+
+            // R/W
+            printf("%d   | ", entry->rw);
+
+            // User
+            printf("%d    | ", entry->user);
+
+            // Frame
+            printf("%x\n", entry->frame);
+        }
+
+        printf("\n");
+    }
+
+    printf("====================\n");
+    printf("End of page directory\n");
+}
+
+void paging_init() {
+    /* register fault handle first, so in case of error will found the problem fast */
+    register_interrupt_handler(13, general_protection_fault_handler);
+    register_interrupt_handler(14, page_fault_handler);
+
+    /* the kernel image (boot sections and the boot tables included) must never be handed out by the pmm,
+       page tables are allocated from it from now on */
+    uint32_t kernel_end_phys = (uint32_t)&__kernel_end_v_no_heap - 0xC0000000;
+    pmm_reserve_range((uint32_t)&__kernel_start, kernel_end_phys - (uint32_t)&__kernel_start);
+
+    current_directory = &kernel_page_directory;
+    kernel_page_directory.physical_addr = ((uint32_t)kernel_page_directory.tables_physical) - 0xC0000000;
+
+    /* adopt the boot tables of the higher half (the kernel image and the screen mmio),
+       the identity map of the lower half is dropped */
+    for (size_t t = TABLE_INDEX(0xC0000000); t < PAGING_ENTRIES_SIZE; t++) {
+        /* the kernel image may be mapped by 4 MiB pages, there is no table behind those */
+        if (boot_page_directory.tables_physical[t] & PG_4MB) {
+            kernel_page_directory.tables_physical[t] = boot_page_directory.tables_physical[t] | PG_GLOBAL;
+            continue;
+        }
+
+        page_table_t * boot_table = boot_page_directory.tables[t];
+        if (boot_table == NULL) continue;
+
+        /* the higher half is the same in every address space, keep it in the TLB across switches */
+        uint16_t present = 0;
+        for (size_t p = 0; p < PAGING_ENTRIES_SIZE; p++) {
+            present += boot_table->entries[p].present;
+            boot_table->entries[p].global = boot_table->entries[p].present;
+        }
+
+        kernel_page_directory.tables[t] = TABLE_WINDOW_ADDR(t);
+        kernel_page_directory.tables_physical[t] = boot_page_directory.tables_physical[t];
+        kernel_page_directory.tables_entries[t] = present;
+    }
+
+    kernel_page_directory.tables_physical[PAGING_RECURSIVE_SLOT] = kernel_page_directory.physical_addr | PG_WRITABLE | PG_PRESENT;
+
+    switch_page_directory(&kernel_page_directory);
+    tlb_init();
+
+    /* the table of the temporary page is created once, before any other directory, and kept (see temp_map) */
+    create_table(TABLE_INDEX(PAGING_TEMP_PAGE), 0);
+
+    /* make read only pages read only for the kernel too (the shared zero page depends on it) */
+    uint32_t cr0;
+    asm volatile("mov %%cr0, %0": "=r"(cr0));
+    asm volatile("mov %0, %%cr0":: "r"(cr0 | CR0_WP));
+}
+
+void paging_init_directory(page_directory_t * dir) {
+    memset(dir, 0, sizeof(page_directory_t));
+    dir->physical_addr = (uint32_t)paging_get_mapping(dir->tables_physical);
+
+    /* the kernel half points to the same tables as the kernel directory */
+    for (size_t t = KERNEL_TABLE_INDEX; t < PAGING_ENTRIES_SIZE; t++) {
+        dir->tables[t] = kernel_page_directory.tables[t];
+        dir->tables_physical[t] = kernel_page_directory.tables_physical[t];
+    }
+
+    dir->tables_physical[PAGING_RECURSIVE_SLOT] = dir->physical_addr | PG_WRITABLE | PG_PRESENT;
+
+    /* kernel tables created or freed from now on are copied into dir too */
+    dir->next = kernel_page_directory.next;
+    kernel_page_directory.next = dir;
+}
+
+void paging_unlink_directory(page_directory_t * dir) {
+    page_directory_t ** link = &kernel_page_directory.next;
+    while (*link != NULL && *link != dir)
+        link = &(*link)->next;
+    if (*link != NULL)
+        *link = dir->next;
+
+    dir->next = NULL;
+}
+
+void switch_page_directory(page_directory_t * dir) {
+    /* paging is already enabled by boot_ipl, loading cr3 is enough (it flushes the non global TLB entries) */
+    current_directory = dir;
+    asm volatile("mov %0, %%cr3":: "r"(dir->physical_addr) : "memory");
+}
+
+/*
+ * The fault handlers run with interrupts off, nothing they walk (the pmm, the
+ * tables, the region lists) is locked against a preempting thread. Only the
+ * drive I/O of a swapped or file page turns them back on, if the faulting
+ * code had them on, so another thread can release the drive meanwhile.
+ * fault_eflags is set before any handler runs and read before the first I/O
+ * of the fault, with interrupts off all along, so no other fault can change
+ * it in between.
+ */
+void paging_fault_io_begin() {
+    if (fault_eflags & EFLAGS_IF)
+        asm volatile("sti" ::: "memory");
+}
+
+void paging_fault_io_end() {
+    asm volatile("cli" ::: "memory");
+}
+
+uint32_t page_fault_handler(cpu_status_t* regs) {
+    // A page fault has occurred.
+    // The faulting address is stored in the CR2 register.
+    uint32_t faulting_address;
+    asm volatile("mov %%cr2, %0" : "=r" (faulting_address));
+
+    /* faults nest (a handler may touch lazily committed heap), the outer eflags are put back on the way out */
+    uint32_t outer_eflags = fault_eflags;
+    fault_eflags = regs->eflags;
+
+    /* a write to a page shared with a cloned address space,
+       a page that was pushed out to the swap area,
+       or a page of an mmap region touched for the first time */
+    uint8_t handled = handle_cow_fault(faulting_address, regs->err_code) ||
+                      swap_handle_fault(faulting_address, regs->err_code) ||
+                      vm_region_handle_fault(faulting_address, regs->err_code);
+
+    fault_eflags = outer_eflags;
+
+    if (handled)
+        return ENO;
+
+    // The error code gives us details of what happened.
+    int not_present   = !(regs->err_code & 0x1); // Page not present
+    int rw = regs->err_code & 0x2;           // Write operation?
+    int us = regs->err_code & 0x4;           // Processor was in user-mode?
+    int reserved = regs->err_code & 0x8;     // Overwritten CPU-reserved bits of page entry?
+    int id = regs->err_code & 0x10;          // Caused by an instruction fetch?
+
+    // Output an error message.
+    printf("Page fault! ( ");
+    if (not_present) {printf(" not_present ");}
+    if (rw) {printf("read-only ");}
+    if (us) {printf("user-mode ");}
+    if (reserved) {printf("reserved ");}
+    printf(") at %p. eip is %p\n", faulting_address, regs->eip);
+    PANIC("Page fault");
+
+    return -EPF;
+}
+
+uint32_t general_protection_fault_handler(cpu_status_t* regs) {
+    // Error code format for #GP:
+    // bit 0: EXT  (1 = came from external event, 0 = from software)
+    // bits 1-2: IDT (1 = IDT, 2 = LDT, 3 = GDT)
+    // bits 3-15: selector index (if EXT = 0)
+
+    uint32_t err = regs->err_code;
+
+    int ext = err & 0x1;
+    int table = (err >> 1) & 0x3;      // 0,1,2,3
+    uint16_t selector = err >> 3;      // selector index
+
+    printf("General Protection Fault! ( ");
+
+    if (ext) {
+        printf("external ");
+    } else {
+        printf("software ");
+    }
+
+    switch (table) {
+        case 0:
+            printf("GDT ");
+            break;
+        case 1:
+            printf("IDT ");
+            break;
+        case 2:
+            printf("LDT ");
+            break;
+        case 3:
+            printf("reserved-table ");
+            break;
+    }
+
+    if (!ext) {
+        printf("selector=%#x ", selector);
+    }
+
+    printf(") at eip=%p\n", regs->eip);
+
+    PANIC("General Protection Fault");
+
+    return -EGPF;
+}
+
+/* the kernel half is the same in every address space, copy a changed kernel slot of the current directory to all of them */
+static void sync_kernel_entry(uint32_t table_index) {
+    if (table_index < KERNEL_TABLE_INDEX || table_index == PAGING_RECURSIVE_SLOT) return;
+
+    for (page_directory_t * dir = &kernel_page_directory; dir != NULL; dir = dir->next) {
+        dir->tables_physical[table_index] = current_directory->tables_physical[table_index];
+        dir->tables[table_index] = current_directory->tables[table_index];
+    }
+}
+
+/* present entries of a table, the counts of the kernel half are kept by the kernel directory only */
+static uint16_t * table_entries(uint32_t table_index) {
+    if (table_index >= KERNEL_TABLE_INDEX)
+        return &kernel_page_directory.tables_entries[table_index];
+
+    return &current_directory->tables_entries[table_index];
+}
+
+/* allocate, wire and clear the table for table_index in the current directory */
+static page_table_t * create_table(uint32_t table_index, uint32_t page_flags) {
+    /* zeroing a frame needs the table of the temporary page, which is itself made here once by paging_init */
+    uint8_t bootstrap = current_directory->tables[TABLE_INDEX(PAGING_TEMP_PAGE)] == NULL;
+
+    void * frame = bootstrap ? pmm_alloc_frame() : pmm_alloc_zeroed_frame();
+    if (frame == NULL) PANIC("No memory for a page table");
+
+    page_table_t * table = TABLE_WINDOW_ADDR(table_index);
+
+    current_directory->tables_physical[table_index] = (uint32_t)frame | (page_flags & PG_USER) | PG_WRITABLE | PG_PRESENT;
+    current_directory->tables[table_index] = table;
+    *table_entries(table_index) = 0;
+    sync_kernel_entry(table_index);
+
+    tlb_flush_page(table);
+    if (bootstrap)
+        memset(table, 0, sizeof(page_table_t));
+
+    return table;
+}
+
+/* give an empty table back to the pmm, tables inside the kernel image (adopted from boot) are kept */
+static void destroy_table(uint32_t table_index) {
+    uint32_t frame = PAGE_MASK(current_directory->tables_physical[table_index]);
+
+    if (frame < (uint32_t)&__kernel_end_v_no_heap - 0xC0000000) return;
+
+    current_directory->tables_physical[table_index] = 0;
+    current_directory->tables[table_index] = NULL;
+    sync_kernel_entry(table_index);
+    tlb_flush_page(TABLE_WINDOW_ADDR(table_index));
+
+    pmm_free_frame((void *)frame);
+}
+
+/* map frame at PAGING_TEMP_PAGE until temp_unmap (not nested), the entry is not counted so its table is never reclaimed */
+static void * temp_map(uint32_t frame) {
+    temp_eflags = irq_save();
+
+    page_table_t * table = current_directory->tables[TABLE_INDEX(PAGING_TEMP_PAGE)];
+    page_entry_t * entry = &table->entries[PAGE_INDEX(PAGING_TEMP_PAGE)];
+    entry->present = 1;
+    entry->rw = 1;
+    entry->frame = frame >> 12;
+
+    tlb_flush_page((void *)PAGING_TEMP_PAGE);
+    return (void *)PAGING_TEMP_PAGE;
+}
+
+static void temp_unmap() {
+    page_table_t * table = current_directory->tables[TABLE_INDEX(PAGING_TEMP_PAGE)];
+
+    memset(&table->entries[PAGE_INDEX(PAGING_TEMP_PAGE)], 0, sizeof(page_entry_t));
+    tlb_flush_page((void *)PAGING_TEMP_PAGE);
+
+    irq_restore(temp_eflags);
+}
+
+void paging_zero_frame(uint32_t paddr) {
+    memset(temp_map(PAGE_MASK(paddr)), 0, PAGE_SIZE);
+    temp_unmap();
+}
+
+void paging_read_frame(uint32_t paddr, void * dst) {
+    memcpy(dst, temp_map(PAGE_MASK(paddr)), PAGE_SIZE);
+    temp_unmap();
+}
+
+void paging_write_frame(uint32_t paddr, const void * src) {
+    memcpy(temp_map(PAGE_MASK(paddr)), src, PAGE_SIZE);
+    temp_unmap();
+}
+
+/* the entry of vaddr in dir, NULL if it has no table, tables of another directory are reached through
+   the temporary page so a non NULL result must be followed by entry_done */
+static page_entry_t * dir_entry(page_directory_t * dir, uint32_t vaddr) {
+    uint32_t directory_entry = dir->tables_physical[TABLE_INDEX(vaddr)];
+
+    if (!(directory_entry & PG_PRESENT) || (directory_entry & PG_4MB)) return NULL;
+
+    page_table_t * table = dir == current_directory ? TABLE_WINDOW_ADDR(TABLE_INDEX(vaddr)) : temp_map(PAGE_MASK(directory_entry));
+
+    return &table->entries[PAGE_INDEX(vaddr)];
+}
+
+static void entry_done(page_directory_t * dir, uint32_t vaddr) {
+    if (dir == current_directory)
+        tlb_flush_page((void *)vaddr);
+    else
+        temp_unmap();  /* the entries of a directory that is not loaded are not in the TLB */
+}
+
+uint8_t paging_test_and_clear_accessed(page_directory_t * dir, void * vaddr) {
+    page_entry_t * entry = dir_entry(dir, (uint32_t)vaddr);
+    if (entry == NULL) return 0;
+
+    uint8_t accessed = entry->present && entry->accessed;
+    entry->accessed = 0;
+
+    entry_done(dir, (uint32_t)vaddr);
+    return accessed;
+}
+
+uint8_t paging_test_and_clear_dirty(page_directory_t * dir, void * vaddr) {
+    page_entry_t * entry = dir_entry(dir, (uint32_t)vaddr);
+    if (entry == NULL) return 0;
+
+    uint8_t dirty = entry->present && entry->dirty;
+    entry->dirty = 0;
+
+    entry_done(dir, (uint32_t)vaddr);
+    return dirty;
+}
+
+uint8_t paging_swap_out_entry(page_directory_t * dir, void * vaddr, uint32_t slot) {
+    page_entry_t * entry = dir_entry(dir, (uint32_t)vaddr);
+    if (entry == NULL) return 1;
+
+    if (!entry->present) {
+        entry_done(dir, (uint32_t)vaddr);
+        return 1;
+    }
+
+    /* keep rw, user and cow so the page comes back with the same rights, the entry stays counted */
+    page_entry_t swapped = { 0 };
+    swapped.rw = entry->rw;
+    swapped.user = entry->user;
+    swapped.available = (entry->available & (PG_COW >> 9)) | (PG_SWAPPED >> 9);
+    swapped.frame = slot;
+    *entry = swapped;
+
+    entry_done(dir, (uint32_t)vaddr);
+    return 0;
+}
+
+void paging_swap_in_entry(page_directory_t * dir, void * vaddr, uint32_t paddr) {
+    page_entry_t * entry = dir_entry(dir, (uint32_t)vaddr);
+    if (entry == NULL || !ENTRY_SWAPPED(entry)) PANIC("Swapping in over an entry that is not swapped out");
+
+    /* the page is private now, a copy-on-write page gets its write access back */
+    entry->rw = entry->rw || (entry->available & (PG_COW >> 9));
+    entry->available = 0;
+    entry->frame = paddr >> 12;
+    entry->present = 1;
+
+    entry_done(dir, (uint32_t)vaddr);
+
+    page_t * page = page_from_frame(paddr);
+    if (page != NULL)
+        page->owner = dir;
+}
+
+uint8_t paging_maps_frame(page_directory_t * dir, void * vaddr, uint32_t paddr) {
+    page_entry_t * entry = dir_entry(dir, (uint32_t)vaddr);
+    if (entry == NULL) return 0;
+
+    uint8_t maps = entry->present && entry->frame == paddr >> 12;
+
+    if (dir != current_directory)
+        temp_unmap();
+
+    return maps;
+}
+
+uint8_t paging_get_swap_slot(page_directory_t * dir, void * vaddr, uint32_t * slot) {
+    page_entry_t * entry = dir_entry(dir, (uint32_t)vaddr);
+    if (entry == NULL) return 0;
+
+    uint8_t swapped = ENTRY_SWAPPED(entry);
+    *slot = entry->frame;
+
+    if (dir != current_directory)
+        temp_unmap();
+
+    return swapped;
+}
+
+void paging_map_page(void* vaddr, void* paddr, uint32_t page_flags) {
+    uint32_t table_index = TABLE_INDEX((uint32_t)vaddr);
+
+    if (current_directory->tables_physical[table_index] & PG_4MB) PANIC("Mapping a page inside a 4 MiB page");
+
+    /* mark paddr if not marked already */
+    pmm_alloc_frame_addr((void *)PAGE_MASK((uint32_t)paddr));
+
+    /* kernel mappings are shared by every address space */
+    if ((uint32_t)vaddr >= 0xC0000000 && !(page_flags & PG_USER))
+        page_flags |= PG_GLOBAL;
+
+    /* the table for vaddr is created on first use */
+    page_table_t * table = current_directory->tables[table_index];
+
+    if (table == NULL)
+        table = create_table(table_index, page_flags);
+    else if (page_flags & PG_USER)
+        current_directory->tables_physical[table_index] |= PG_USER;
+
+    page_entry_t * entry = &table->entries[PAGE_INDEX((uint32_t)vaddr)];
+    uint8_t was_present = entry->present;
+
+    if (ENTRY_SWAPPED(entry)) PANIC("Mapping over a swapped out page");
+
+    if (!was_present && (page_flags & PG_PRESENT))
+        (*table_entries(table_index))++;
+    else if (was_present && !(page_flags & PG_PRESENT))
+        (*table_entries(table_index))--;
+
+    entry->present    = (page_flags & PG_PRESENT) != 0;
+    entry->rw         = (page_flags & PG_WRITABLE) != 0;
+    entry->user       = (page_flags & PG_USER) != 0;
+    entry->write_thru = (page_flags & PG_WRITE_THRU) != 0;
+    entry->no_cache   = (page_flags & PG_NO_CACHE) != 0;
+    entry->accessed   = (page_flags & PG_ACCESSED) != 0;
+    entry->dirty      = (page_flags & PG_DIRTY) != 0;
+    entry->global     = (page_flags & PG_GLOBAL) != 0;
+    entry->available  = (page_flags >> 9) & 0x7;
+    entry->frame      = (uint32_t)paddr >> 12;
+
+    /* a frame belongs to the first address space that maps it, a writable mapping may dirty it */
+    page_t * page = page_from_frame((uint32_t)paddr);
+    if (page != NULL) {
+        if (page->owner == NULL)
+            page->owner = current_directory;
+        if (page_flags & PG_WRITABLE)
+            page->flags &= ~PAGE_ZEROED;
+    }
+
+    /* a not present entry is never cached, only a changed mapping has to be flushed */
+    if (was_present)
+        tlb_flush_page(vaddr);
+}
+
+uint8_t paging_map_large_page(void* vaddr, void* paddr, uint32_t page_flags) {
+    uint32_t table_index = TABLE_INDEX((uint32_t)vaddr);
+
+    if (!paging_large_pages_enabled() || current_directory->tables[table_index] != NULL)
+        return 1;
+
+    if (((uint32_t)vaddr | (uint32_t)paddr) & (LARGE_PAGE_SIZE - 1)) PANIC("Unaligned 4 MiB page");
+
+    /* mark the frames if not marked already */
+    for (uint32_t offset = 0; offset < LARGE_PAGE_SIZE; offset += PAGE_SIZE)
+        pmm_alloc_frame_addr((uint8_t *)paddr + offset);
+
+    /* kernel mappings are shared by every address space */
+    if ((uint32_t)vaddr >= 0xC0000000 && !(page_flags & PG_USER))
+        page_flags |= PG_GLOBAL;
+
+    uint32_t was_present = current_directory->tables_physical[table_index] & PG_PRESENT;
+
+    current_directory->tables_physical[table_index] = (uint32_t)paddr | (page_flags & 0xFFF) | PG_4MB;
+    sync_kernel_entry(table_index);
+
+    if (was_present)
+        tlb_flush_page(vaddr);
+
+    return 0;
+}
+
+uint8_t paging_map_large_page_high(void* vaddr, uint32_t block, uint32_t page_flags) {
+    uint32_t table_index = TABLE_INDEX((uint32_t)vaddr);
+
+    if (!paging_large_pages_enabled() || current_directory->tables[table_index] != NULL)
+        return 1;
+
+    if ((uint32_t)vaddr & (LARGE_PAGE_SIZE - 1)) PANIC("Unaligned 4 MiB page");
+
+    /* the block is outside the pmm, nothing to mark. PSE-36 keeps physical bits 32-35 in entry bits 13-16 */
+    if ((uint32_t)vaddr >= 0xC0000000 && !(page_flags & PG_USER))
+        page_flags |= PG_GLOBAL;
+
+    uint32_t was_present = current_directory->tables_physical[table_index] & PG_PRESENT;
+
+    current_directory->tables_physical[table_index] = ((block & 0x3FF) << 22) | (((block >> 10) & 0xF) << 13) | (page_flags & 0xFFF) | PG_4MB;
+    sync_kernel_entry(table_index);
+
+    if (was_present)
+        tlb_flush_page(vaddr);
+
+    return 0;
+}
+
+void paging_unmap_large_page(void* vaddr) {
+    uint32_t table_index = TABLE_INDEX((uint32_t)vaddr);
+
+    if (!(current_directory->tables_physical[table_index] & PG_4MB)) return;
+
+    current_directory->tables_physical[table_index] = 0;
+    sync_kernel_entry(table_index);
+
+    /* a single invlpg drops the whole 4 MiB translation */
+    tlb_flush_page(vaddr);
+}
+
+uint8_t paging_is_large_page(void* vaddr) {
+    return (current_directory->tables_physical[TABLE_INDEX((uint32_t)vaddr)] & PG_4MB) != 0;
+}
+
+uint8_t paging_large_pages_enabled() {
+    uint32_t cr4;
+    asm volatile("mov %%cr4, %0" : "=r"(cr4));
+    return (cr4 & CR4_PSE) != 0;
+}
+
+/* clear the entry of vaddr without touching the TLB, the table is freed once it is empty */
+static void clear_entry(void* vaddr) {
+    uint32_t table_index = TABLE_INDEX((uint32_t)vaddr);
+
+    /* check if there is a table for vaddr */
+    page_table_t * t = current_directory->tables[table_index];
+
+    if (t == NULL) return; /* no need to un-map */
+
+    /* unmap the page */
+    page_entry_t * p = &t->entries[PAGE_INDEX((uint32_t)vaddr)];
+    uint8_t was_present = p->present;
+    uint8_t was_in_use = ENTRY_IN_USE(p);
+
+    /* the page only lives in the swap area, forget it there */
+    if (ENTRY_SWAPPED(p))
+        swap_put_slot(p->frame);
+
+    /* carry the hardware dirty bit over to the frame before the entry is gone */
+    page_t * page = was_present ? page_from_frame(p->frame << 12) : NULL;
+    if (page != NULL) {
+        if (p->dirty)
+            page->flags |= PAGE_DIRTY;
+        if (page->owner == current_directory)
+            page->owner = NULL;
+    }
+
+    memset(p, 0, sizeof(page_entry_t));
+
+    if (was_in_use && --(*table_entries(table_index)) == 0)
+        destroy_table(table_index);
+}
+
+void paging_unmap_page(void* vaddr) {
+    clear_entry(vaddr);
+
+    /* the address may be mapped again to another frame, so drop the stale translation */
+    tlb_flush_page(vaddr);
+}
+
+void paging_unmap_range(void* vaddr, size_t size) {
+    for (uint32_t page = PAGE_MASK((uint32_t)vaddr); page < (uint32_t)vaddr + size; page += PAGE_SIZE)
+        clear_entry((void *)page);
+
+    tlb_flush_range(vaddr, size);
+}
+
+void* paging_get_mapping(void* vaddr) {
+    uint32_t directory_entry = current_directory->tables_physical[TABLE_INDEX((uint32_t)vaddr)];
+
+    if (directory_entry & PG_4MB)
+        return (void*)(LARGE_PAGE_MASK(directory_entry) | PAGE_MASK((uint32_t)vaddr & (LARGE_PAGE_SIZE - 1)));
+
+    page_table_t * t = current_directory->tables[TABLE_INDEX((uint32_t)vaddr)];
+
+    if (t == NULL || !t->entries[PAGE_INDEX((uint32_t)vaddr)].present) return NULL;
+
+    return (void*)(t->entries[PAGE_INDEX((uint32_t)vaddr)].frame << 12);
+}
+
+page_directory_t * paging_get_current_directory() {
+    return current_directory;
+}
+
+page_directory_t * paging_get_kernel_directory() {
+    return &kernel_page_directory;
+}
+
+page_directory_t * paging_clone_directory() {
+    if (directory_cache == NULL)
+        directory_cache = kmem_cache_create_aligned("page_directory_t", sizeof(page_directory_t), PAGE_SIZE);
+    if (directory_cache == NULL) return NULL;
+
+    page_directory_t * dir = kmem_cache_alloc(directory_cache);
+    if (dir == NULL) return NULL;
+
+    paging_init_directory(dir);
+
+    /* the user half gets its own tables, the frames behind them are shared: writable pages turn read only
+       in both directories and the first write copies them (see handle_cow_fault) */
+    for (uint32_t t = 0; t < KERNEL_TABLE_INDEX; t++) {
+        page_table_t * table = current_directory->tables[t];
+        if (table == NULL) continue;
+
+        void * frame = pmm_alloc_frame();
+        if (frame == NULL) {
+            paging_destroy_directory(dir);
+            return NULL;
+        }
+
+        page_table_t * copy = temp_map((uint32_t)frame);
+
+        for (uint32_t p = 0; p < PAGING_ENTRIES_SIZE; p++) {
+            page_entry_t * entry = &table->entries[p];
+
+            if (ENTRY_SWAPPED(entry)) {
+                swap_dup_slot(entry->frame);  /* both directories read the same slot back */
+            } else if (entry->present) {
+                /* pages of a mapped file stay shared and writable, both directories see the same file */
+                page_t * page = page_from_frame(entry->frame << 12);
+
+                if (entry->rw && (page == NULL || !(page->flags & PAGE_FILE))) {
+                    entry->rw = 0;
+                    entry->available |= PG_COW >> 9;
+                }
+
+                /* the zero page is never freed by its users, it is not counted */
+                if (entry->frame << 12 != vm_region_zero_page())
+                    page_get(entry->frame << 12);
+            }
+
+            copy->entries[p] = *entry;
+        }
+
+        temp_unmap();
+
+        dir->tables[t] = TABLE_WINDOW_ADDR(t);
+        dir->tables_physical[t] = (uint32_t)frame | (current_directory->tables_physical[t] & 0xFFF);
+        dir->tables_entries[t] = current_directory->tables_entries[t];
+    }
+
+    if (vm_region_clone(dir, current_directory)) {
+        paging_destroy_directory(dir);
+        return NULL;
+    }
+
+    /* the pages of the current directory lost their write permission */
+    tlb_flush_all();
+
+    return dir;
+}
+
+void paging_destroy_directory(page_directory_t * dir) {
+    if (dir == current_directory || dir == &kernel_page_directory) PANIC("Destroying an address space in use");
+
+    /* every user mapping holds one reference to its frame */
+    for (uint32_t t = 0; t < KERNEL_TABLE_INDEX; t++) {
+        uint32_t directory_entry = dir->tables_physical[t];
+        if (!(directory_entry & PG_PRESENT) || (directory_entry & PG_4MB)) continue;
+
+        page_table_t * table = temp_map(PAGE_MASK(directory_entry));
+
+        for (uint32_t p = 0; p < PAGING_ENTRIES_SIZE; p++) {
+            uint32_t frame = table->entries[p].frame << 12;
+
+            if (ENTRY_SWAPPED(&table->entries[p]))
+                swap_put_slot(table->entries[p].frame);
+
+            if (!table->entries[p].present || frame == vm_region_zero_page()) continue;
+
+            page_t * page = page_from_frame(frame);
+            if (page != NULL && page->owner == dir)
+                page->owner = NULL;
+            if (page != NULL && table->entries[p].dirty)
+                page->flags |= PAGE_DIRTY;
+
+            pmm_free_frame((void *)frame);
+        }
+
+        temp_unmap();
+        pmm_free_frame((void *)PAGE_MASK(directory_entry));
+    }
+
+    vm_region_destroy_all(dir);
+
+    paging_unlink_directory(dir);
+
+    kmem_cache_free(directory_cache, dir);
+}
+
+/* a write to a page shared by paging_clone_directory, give the writer its own copy, 1 - handled */
+static uint8_t handle_cow_fault(uint32_t addr, uint32_t err_code) {
+    if ((err_code & (PF_PRESENT | PF_WRITE)) != (PF_PRESENT | PF_WRITE)) return 0;
+
+    page_table_t * table = current_directory->tables[TABLE_INDEX(addr)];
+    if (table == NULL) return 0;
+
+    page_entry_t * entry = &table->entries[PAGE_INDEX(addr)];
+    if (!entry->present || !(entry->available & (PG_COW >> 9))) return 0;
+
+    void * page = (void *)PAGE_MASK(addr);
+    uint32_t frame = entry->frame << 12;
+    uint32_t page_flags = PG_PRESENT | PG_WRITABLE | (entry->user ? PG_USER : 0);
+
+    /* every other sharer is gone, the frame is ours again (and so is its ownership, if the owner copied it away) */
+    page_t * descriptor = page_from_frame(frame);
+    if (descriptor != NULL && descriptor->refcount == 1) {
+        paging_map_page(page, (void *)frame, page_flags);
+        if (vm_region_find(current_directory, addr) != NULL)
+            swap_track_page(frame, addr);
+        return 1;
+    }
+
+    void * copy = pmm_alloc_frame();
+    if (copy == NULL) return 0;
+
+    memcpy(temp_map((uint32_t)copy), page, PAGE_SIZE);
+    temp_unmap();
+
+    paging_map_page(page, copy, page_flags);
+
+    /* the frame stays with the other sharers, swap must not look for it in our tables anymore */
+    if (descriptor != NULL && descriptor->owner == current_directory)
+        descriptor->owner = NULL;
+    pmm_free_frame((void *)frame);  /* drop our reference to the shared frame */
+
+    /* the private copy of an mmap page is anonymous memory like any other */
+    if (vm_region_find(current_directory, addr) != NULL)
+        swap_track_page((uint32_t)copy, addr);
+
+    return 1;
 }
\ No newline at end of file
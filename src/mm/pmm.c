@@ -1,84 +1,411 @@
-#include "kernel/panic.h"
-#include "mm/pmm.h"
-#include "utils/utils.h"
-
-#define FRAME_ALIGN(addr) (addr & ~0xFFF)
-#define FRAME_INDEX(addr) (addr >> 12)
-#define FRAME_BIT_FIELD_INDEX(addr) (FRAME_INDEX(addr) / 32)
-#define FRAME_BIT_FIELD_INNER_INDEX(addr) (FRAME_INDEX(addr) % 32)
-
-static uint32_t bit_field[PMM_BIT_FIELD_ARR_SIZE];
-
-void pmm_init() {
-    memset(bit_field, 0, sizeof(uint32_t) * PMM_BIT_FIELD_ARR_SIZE);
-
-    /* make first 1 Mbit of memory of usable, so no pages will be allocated to here */
-    pmm_alloc_frames_addr(0, 0x00100000 / FRAME_SIZE);
-}
-
-void* pmm_alloc_frame_addr(void * paddr) {
-    paddr = (void *)FRAME_ALIGN((uint32_t)paddr); /* make sure addr is frame aligned */
-    uint32_t bit_field_index = FRAME_BIT_FIELD_INDEX((uint32_t)paddr);
-    uint32_t bit_field_inner_index = FRAME_BIT_FIELD_INNER_INDEX((uint32_t)paddr);
-
-    if (bit_field[bit_field_index] & (1 << bit_field_inner_index)) /* is frame is already used */
-        return NULL;
-    
-    /* mark the frame as used */
-    bit_field[bit_field_index] = bit_field[bit_field_index] | (1 << bit_field_inner_index);
-
-    return paddr;
-}
-
-void* pmm_alloc_frames_addr(void * paddr, size_t count) {
-    uint32_t bit_field_index;
-    uint32_t bit_field_inner_index;
-    uint32_t caddr;
-    
-    paddr = (void *)FRAME_ALIGN((uint32_t)paddr); /* make sure addr is frame aligned */
-
-    for (size_t i = 0; i < count; i++) { /* make sure all addr and address are not used */
-        caddr = (uint32_t)(paddr + i * FRAME_SIZE);
-
-        bit_field_index = FRAME_BIT_FIELD_INDEX((uint32_t)caddr);
-        bit_field_inner_index = FRAME_BIT_FIELD_INNER_INDEX((uint32_t)caddr);
-
-        if (bit_field[bit_field_index] & (1 << bit_field_inner_index)) /* is frame is already used */
-            return NULL;
-    }
-
-    /* all frames are allowed to be allocated */
-
-    for (size_t i = 0; i < count; i++) { /* allocate all of them */
-        caddr = (uint32_t)(paddr + i * FRAME_SIZE);
-        pmm_alloc_frame_addr((void *)caddr);
-    }
-
-    return paddr;
-}
-
-static void * get_last_free_frame() {
-    for (size_t b = 0; b < PMM_BIT_FIELD_ARR_SIZE; b++)
-        if (bit_field[b] != 0xFFFFFFFF)
-            for (size_t i = 0; i < 32; i++)
-                if (!(bit_field[b] & (1 << i))) /* frame is free */
-                    return (void *)(FRAME_SIZE * (32 * b + i));
-    
-    return NULL;
-}
-
-void* pmm_alloc_frame() {
-    void * addr = get_last_free_frame();
-    addr = pmm_alloc_frame_addr(addr);
-
-    return addr;
-}
-
-void pmm_free_frame(void* paddr) {
-    paddr = (void *)FRAME_ALIGN((uint32_t)paddr); /* make sure addr is frame aligned */
-
-    uint32_t bit_field_index = FRAME_BIT_FIELD_INDEX((uint32_t)paddr);
-    uint32_t bit_field_inner_index = FRAME_BIT_FIELD_INNER_INDEX((uint32_t)paddr);
-
-    bit_field[bit_field_index] = bit_field[bit_field_index] & ~(1 << bit_field_inner_index);  /* set frame to be unused */
-}
+#include "kernel/panic.h"
+#include "mm/pmm.h"
+#include "mm/page.h"
+#include "mm/paging.h"
+#include "mm/swap.h"
+#include "multitasking/lock.h"
+#include "utils/bitmap_util.h"
+#include "utils/utils.h"
+
+#define FRAME_ALIGN(addr) (addr & ~0xFFF)
+#define FRAME_INDEX(addr) (addr >> 12)
+#define FRAME_BIT_FIELD_INDEX(addr) (FRAME_INDEX(addr) / 32)
+#define FRAME_BIT_FIELD_INNER_INDEX(addr) (FRAME_INDEX(addr) % 32)
+
+static uint32_t bit_field[PMM_BIT_FIELD_ARR_SIZE];    /* 1 - frame used */
+static uint32_t summary_l1[PMM_SUMMARY_L1_SIZE];      /* 1 - the bit_field word has a free frame */
+static uint32_t summary_l2[PMM_SUMMARY_L2_SIZE];      /* 1 - the summary_l1 word is not 0 */
+static uint32_t summary_top;                          /* 1 - the summary_l2 word is not 0 */
+static uint32_t frames_count;     /* frames managed, up to the highest usable address (a multiple of 32) */
+static uint32_t free_frames_count;
+static pmm_zone_t zones[PMM_ZONES_COUNT];
+
+/* frames zeroed while the cpu was idle, they are used in the bitmap and flagged PAGE_ZEROED,
+   the list is shared with the idle process so it is only touched with interrupts off */
+static page_list_t zeroed_pool;
+
+static pmm_zone_t * zone_of(uint32_t frame) {
+    if (frame < PMM_ZONE_LOW_END / FRAME_SIZE) return &zones[PMM_ZONE_LOW];
+    if (frame < PMM_ZONE_DMA_END / FRAME_SIZE) return &zones[PMM_ZONE_DMA];
+    return &zones[PMM_ZONE_NORMAL];
+}
+
+static void mark_frame_used(uint32_t frame) {
+    uint32_t word = frame / 32;
+
+    bit_field[word] |= (1u << (frame % 32));
+    free_frames_count--;
+    zone_of(frame)->free_frames--;
+
+    page_t * page = page_from_frame(frame * FRAME_SIZE);
+    if (page != NULL) {
+        page->refcount = 1;
+        page->flags = 0;
+        page->owner = NULL;
+    }
+
+    /* propagate "full" up the summary levels, stop at the first level that still has a free bit */
+    if (bit_field[word] != 0xFFFFFFFF) return;
+    summary_l1[word / 32] &= ~(1u << (word % 32));
+
+    if (summary_l1[word / 32] != 0) return;
+    summary_l2[word / 1024] &= ~(1u << ((word / 32) % 32));
+
+    if (summary_l2[word / 1024] != 0) return;
+    summary_top &= ~(1u << (word / 1024));
+}
+
+static void mark_frame_free(uint32_t frame) {
+    uint32_t word = frame / 32;
+
+    bit_field[word] &= ~(1u << (frame % 32));
+    free_frames_count++;
+    zone_of(frame)->free_frames++;
+
+    summary_l1[word / 32] |= (1u << (word % 32));
+    summary_l2[word / 1024] |= (1u << ((word / 32) % 32));
+    summary_top |= (1u << (word / 1024));
+}
+
+/* index of the first bit_field word at or after word that has a free frame, -1 if there is none */
+static int32_t find_free_word(uint32_t word) {
+    if (word >= PMM_BIT_FIELD_ARR_SIZE) return -1;
+
+    uint32_t l1 = word / 32;
+    uint32_t mask = summary_l1[l1] & (~0u << (word % 32));
+    if (mask != 0) return l1 * 32 + __builtin_ctz(mask);
+
+    /* nothing left in this summary_l1 word, find the next summary_l1 word with a set bit */
+    l1++;
+    uint32_t l2 = l1 / 32;
+    mask = (l1 < PMM_SUMMARY_L1_SIZE) ? summary_l2[l2] & (~0u << (l1 % 32)) : 0;
+
+    if (mask == 0) {
+        l2++;
+        mask = (l2 < PMM_SUMMARY_L2_SIZE) ? summary_top & (~0u << l2) : 0;
+        if (mask == 0) return -1;
+
+        l2 = __builtin_ctz(mask);
+        mask = summary_l2[l2];
+    }
+
+    l1 = l2 * 32 + __builtin_ctz(mask);
+    return l1 * 32 + __builtin_ctz(summary_l1[l1]);
+}
+
+/* index of the first free frame at or after frame, -1 if there is none */
+static int32_t find_free_frame(uint32_t frame) {
+    uint32_t word = frame / 32;
+    uint32_t mask = ~bit_field[word] & (~0u << (frame % 32));
+
+    if (mask != 0) return word * 32 + __builtin_ctz(mask);
+
+    int32_t free_word = find_free_word(word + 1);
+    if (free_word < 0) return -1;
+
+    return free_word * 32 + __builtin_ctz(~bit_field[free_word]);
+}
+
+/* next fit inside one zone, continue from the zone's last allocation and wrap around once, -1 if the zone is full */
+static int32_t find_free_frame_in_zone(pmm_zone_t * zone) {
+    if (zone->free_frames == 0) return -1;
+
+    int32_t frame = find_free_frame(zone->cursor);
+    if ((frame < 0 || (uint32_t)frame >= zone->end_frame) && zone->cursor != zone->start_frame)
+        frame = find_free_frame(zone->start_frame);
+
+    if (frame < 0 || (uint32_t)frame >= zone->end_frame) return -1;
+
+    zone->cursor = (uint32_t)frame + 1 < zone->end_frame ? (uint32_t)frame + 1 : zone->start_frame;
+    return frame;
+}
+
+/* set (value 0xFFFFFFFF) or clear (value 0) bits [first, first + count) of a bitmap, whole words at a time */
+static void bits_fill(uint32_t * words, uint32_t first, uint32_t count, uint32_t value) {
+    while (count != 0 && first % 32 != 0) {
+        words[first / 32] = (words[first / 32] & ~(1u << (first % 32))) | (value & (1u << (first % 32)));
+        first++;
+        count--;
+    }
+
+    memset(&words[first / 32], value & 0xFF, (count / 32) * sizeof(uint32_t));
+    first += count & ~31u;
+    count %= 32;
+
+    for (; count != 0; first++, count--)
+        words[first / 32] = (words[first / 32] & ~(1u << (first % 32))) | (value & (1u << (first % 32)));
+}
+
+/* recompute the summary bits covering bit_field words [first_word, last_word] */
+static void summary_refresh(uint32_t first_word, uint32_t last_word) {
+    /* the inner words were all filled with the same value, only the two edge words differ */
+    if (last_word > first_word + 1)
+        bits_fill(summary_l1, first_word + 1, last_word - first_word - 1, bit_field[first_word + 1] != 0xFFFFFFFF ? 0xFFFFFFFF : 0);
+
+    bits_fill(summary_l1, first_word, 1, bit_field[first_word] != 0xFFFFFFFF ? 0xFFFFFFFF : 0);
+    bits_fill(summary_l1, last_word, 1, bit_field[last_word] != 0xFFFFFFFF ? 0xFFFFFFFF : 0);
+
+    for (uint32_t l1 = first_word / 32; l1 <= last_word / 32; l1++)
+        bits_fill(summary_l2, l1, 1, summary_l1[l1] != 0 ? 0xFFFFFFFF : 0);
+
+    for (uint32_t l2 = first_word / 1024; l2 <= last_word / 1024; l2++)
+        bits_fill(&summary_top, l2, 1, summary_l2[l2] != 0 ? 0xFFFFFFFF : 0);
+}
+
+/* mark frames [first, end) of one zone used (value 0xFFFFFFFF) or free (value 0) */
+static void zone_fill_range(pmm_zone_t * zone, uint32_t first, uint32_t end, uint32_t value) {
+    if (first < zone->start_frame) first = zone->start_frame;
+    if (end > zone->end_frame) end = zone->end_frame;
+    if (first >= end) return;
+
+    /* count the frames that change state, one popcount per word */
+    uint32_t changed = 0;
+    for (uint32_t word = first / 32; word <= (end - 1) / 32; word++) {
+        uint32_t mask = 0xFFFFFFFF;
+        if (word == first / 32) mask &= ~0u << (first % 32);
+        if (word == (end - 1) / 32 && end % 32 != 0) mask &= ~(~0u << (end % 32));
+
+        changed += bitmap_popcount32((value ? ~bit_field[word] : bit_field[word]) & mask);
+    }
+
+    bits_fill(bit_field, first, end - first, value);
+    summary_refresh(first / 32, (end - 1) / 32);
+
+    if (value) {
+        free_frames_count -= changed;
+        zone->free_frames -= changed;
+    } else {
+        free_frames_count += changed;
+        zone->free_frames += changed;
+    }
+}
+
+/* reserving covers every frame the range touches, releasing only the frames inside it */
+static void fill_range(uint32_t paddr, size_t size, uint32_t value) {
+    uint64_t end = value ? ((uint64_t)paddr + size + FRAME_SIZE - 1) / FRAME_SIZE : ((uint64_t)paddr + size) / FRAME_SIZE;
+    uint32_t first = value ? paddr / FRAME_SIZE : (uint32_t)(((uint64_t)paddr + FRAME_SIZE - 1) / FRAME_SIZE);
+
+    if (end > frames_count) end = frames_count;
+
+    uint32_t eflags = irq_save();
+    for (uint32_t z = 0; z < PMM_ZONES_COUNT; z++)
+        zone_fill_range(&zones[z], first, (uint32_t)end, value);
+    irq_restore(eflags);
+}
+
+void pmm_init(uint32_t usable_frames) {
+    frames_count = (usable_frames + 31) & ~31u;
+    if (frames_count == 0 || frames_count > PMM_FRAMES_COUNT)
+        frames_count = PMM_FRAMES_COUNT;
+
+    /* everything starts reserved, the usable ranges of the memory map are released into it */
+    memset(bit_field, 0xFF, sizeof(bit_field));
+    memset(summary_l1, 0, sizeof(summary_l1));
+    memset(summary_l2, 0, sizeof(summary_l2));
+    summary_top = 0;
+    free_frames_count = 0;
+
+    static const char * names[PMM_ZONES_COUNT] = { "low", "dma", "normal" };
+    uint32_t bounds[PMM_ZONES_COUNT + 1] = { 0, PMM_ZONE_LOW_END / FRAME_SIZE, PMM_ZONE_DMA_END / FRAME_SIZE, frames_count };
+
+    for (uint32_t z = 0; z < PMM_ZONES_COUNT; z++) {
+        zones[z].name = names[z];
+        zones[z].start_frame = bounds[z] < frames_count ? bounds[z] : frames_count;
+        zones[z].end_frame = bounds[z + 1] < frames_count ? bounds[z + 1] : frames_count;
+        if (zones[z].end_frame < zones[z].start_frame)
+            zones[z].end_frame = zones[z].start_frame;
+        zones[z].cursor = zones[z].start_frame;
+        zones[z].free_frames = 0;
+    }
+}
+
+void pmm_reserve_range(uint32_t paddr, size_t size) {
+    fill_range(paddr, size, 0xFFFFFFFF);
+}
+
+void pmm_release_range(uint32_t paddr, size_t size) {
+    fill_range(paddr, size, 0);
+}
+
+uint32_t pmm_get_frames_count() {
+    return frames_count;
+}
+
+const pmm_zone_t * pmm_get_zone(uint32_t zone) {
+    return zone < PMM_ZONES_COUNT ? &zones[zone] : NULL;
+}
+
+void* pmm_alloc_frame_addr(void * paddr) {
+    paddr = (void *)FRAME_ALIGN((uint32_t)paddr); /* make sure addr is frame aligned */
+    uint32_t bit_field_index = FRAME_BIT_FIELD_INDEX((uint32_t)paddr);
+    uint32_t bit_field_inner_index = FRAME_BIT_FIELD_INNER_INDEX((uint32_t)paddr);
+
+    uint32_t eflags = irq_save();
+
+    if (bit_field[bit_field_index] & (1u << bit_field_inner_index)) { /* is frame is already used */
+        irq_restore(eflags);
+        return NULL;
+    }
+    
+    /* mark the frame as used */
+    mark_frame_used(FRAME_INDEX((uint32_t)paddr));
+
+    irq_restore(eflags);
+    return paddr;
+}
+
+void* pmm_alloc_frames_addr(void * paddr, size_t count) {
+    uint32_t bit_field_index;
+    uint32_t bit_field_inner_index;
+    uint32_t caddr;
+    
+    paddr = (void *)FRAME_ALIGN((uint32_t)paddr); /* make sure addr is frame aligned */
+
+    /* the check and the allocation have to see the same bitmap */
+    uint32_t eflags = irq_save();
+
+    for (size_t i = 0; i < count; i++) { /* make sure all addr and address are not used */
+        caddr = (uint32_t)(paddr + i * FRAME_SIZE);
+
+        bit_field_index = FRAME_BIT_FIELD_INDEX((uint32_t)caddr);
+        bit_field_inner_index = FRAME_BIT_FIELD_INNER_INDEX((uint32_t)caddr);
+
+        if (bit_field[bit_field_index] & (1u << bit_field_inner_index)) { /* is frame is already used */
+            irq_restore(eflags);
+            return NULL;
+        }
+    }
+
+    /* all frames are allowed to be allocated */
+
+    for (size_t i = 0; i < count; i++) { /* allocate all of them */
+        caddr = (uint32_t)(paddr + i * FRAME_SIZE);
+        pmm_alloc_frame_addr((void *)caddr);
+    }
+
+    irq_restore(eflags);
+    return paddr;
+}
+
+/* take a frame out of the zeroed pool, NULL if it is empty */
+static void * take_zeroed_frame() {
+    uint32_t eflags = irq_save();
+    page_t * page = page_list_pop_head(&zeroed_pool);
+    irq_restore(eflags);
+
+    return page != NULL ? (void *)page_to_frame(page) : NULL;
+}
+
+void* pmm_alloc_frame() {
+    return pmm_alloc_frame_zone(PMM_ZONE_NORMAL);
+}
+
+void* pmm_alloc_frame_zone(uint32_t zone) {
+    /* the search and the marking are one step, an interrupt handler growing the heap must not find the same frame */
+    uint32_t eflags = irq_save();
+
+    /* a zone falls back to the zones below it, never above (a dma buffer has to stay below 16 MiB) */
+    int32_t frame = -1;
+    for (int32_t z = zone < PMM_ZONES_COUNT ? (int32_t)zone : PMM_ZONE_NORMAL; z >= 0 && frame < 0; z--)
+        frame = find_free_frame_in_zone(&zones[z]);
+
+    if (frame >= 0)
+        mark_frame_used(frame);
+
+    irq_restore(eflags);
+
+    if (frame < 0) {
+        /* the pool only holds normal zone frames */
+        if (zone != PMM_ZONE_NORMAL) return NULL;
+
+        /* the pooled frames are free memory too, they only happen to be zero already */
+        void * pooled = take_zeroed_frame();
+        if (pooled != NULL) return pooled;
+
+        /* out of memory, push anonymous pages out to the swap area and try again */
+        if (swap_reclaim(SWAP_RECLAIM_BATCH) == 0) return NULL;
+
+        return pmm_alloc_frame_zone(zone);
+    }
+
+    return (void *)(frame * FRAME_SIZE);
+}
+
+void pmm_free_frame(void* paddr) {
+    paddr = (void *)FRAME_ALIGN((uint32_t)paddr); /* make sure addr is frame aligned */
+
+    if (FRAME_INDEX((uint32_t)paddr) >= frames_count) /* past the managed memory (mmio), never handed out */
+        return;
+
+    uint32_t bit_field_index = FRAME_BIT_FIELD_INDEX((uint32_t)paddr);
+    uint32_t bit_field_inner_index = FRAME_BIT_FIELD_INNER_INDEX((uint32_t)paddr);
+
+    uint32_t eflags = irq_save();
+
+    if (!(bit_field[bit_field_index] & (1u << bit_field_inner_index)) || /* frame is already free */
+        page_put((uint32_t)paddr) != 0) {                                /* the frame is still shared */
+        irq_restore(eflags);
+        return;
+    }
+
+    page_t * page = page_from_frame((uint32_t)paddr);
+    if (page != NULL)
+        swap_untrack_page(page);
+
+    mark_frame_free(FRAME_INDEX((uint32_t)paddr));  /* set frame to be unused */
+
+    irq_restore(eflags);
+}
+
+uint32_t pmm_get_free_frames_count() {
+    return free_frames_count + zeroed_pool.count;
+}
+
+uint8_t pmm_is_frame_used(uint32_t paddr) {
+    return (bit_field[FRAME_BIT_FIELD_INDEX(paddr)] >> FRAME_BIT_FIELD_INNER_INDEX(paddr)) & 1;
+}
+
+void* pmm_alloc_zeroed_frame() {
+    void * frame = take_zeroed_frame();
+    if (frame != NULL) return frame;
+
+    /* the idle process did not keep up, zero it here */
+    frame = pmm_alloc_frame();
+    if (frame != NULL)
+        paging_zero_frame((uint32_t)frame);
+
+    return frame;
+}
+
+uint8_t pmm_zeroed_pool_refill() {
+    if (zeroed_pool.count >= PMM_ZEROED_POOL_TARGET) return 0;
+
+    /* low and dma frames are scarce, leave them to the callers that need them */
+    uint32_t eflags = irq_save();
+    int32_t frame = find_free_frame_in_zone(&zones[PMM_ZONE_NORMAL]);
+    if (frame >= 0)
+        mark_frame_used(frame);
+    irq_restore(eflags);
+
+    if (frame < 0) return 0;
+
+    page_t * page = page_from_frame(frame * FRAME_SIZE);
+    if (page == NULL) {
+        /* no descriptor to link it with, leave the frame to pmm_alloc_frame */
+        pmm_free_frame((void *)(frame * FRAME_SIZE));
+        return 0;
+    }
+
+    paging_zero_frame(frame * FRAME_SIZE);
+
+    eflags = irq_save();
+    page->flags |= PAGE_ZEROED;
+    page_list_add_tail(&zeroed_pool, page);
+    irq_restore(eflags);
+
+    return 1;
+}
+
+uint32_t pmm_get_zeroed_frames_count() {
+    return zeroed_pool.count;
+}
\ No newline at end of file
@@ -0,0 +1,277 @@
+#include "kernel/print.h"
+#include "kernel/panic.h"
+#include "mm/slab.h"
+#include "mm/paging.h"
+#include "mm/pmm.h"
+#include "utils/bitmap_util.h"
+#include "utils/utils.h"
+
+#define ALIGN_UP(x, a) (((x) + (a) - 1) & ~((a) - 1))
+
+#define KMEM_CACHE_VIRT_PAGES  (KMEM_CACHE_VIRT_SIZE / PAGE_SIZE)
+#define SLAB_OF(cache, object) ((kmem_slab_t *)((uint32_t)(object) & ~((cache)->slab_pages * PAGE_SIZE - 1)))
+
+static uint8_t virt_pages_bitmap[KMEM_CACHE_VIRT_PAGES / 8];  /* 1 bit per page of the slab window, 1 - used */
+static kmem_cache_t cache_cache;  /* the cache the kmem_cache_t objects themselves come from */
+static kmem_cache_t * caches;     /* list of all caches */
+static lock_t window_lock;        /* the window bitmap and the caches list, shared by every cache */
+
+/* find a run of count free window pages aligned to count, returns the page index or -1 */
+static int32_t find_virt_pages(uint32_t count) {
+    for (uint32_t start = 0; start + count <= KMEM_CACHE_VIRT_PAGES; start += count) {
+        uint32_t i = 0;
+
+        while (i < count && !bitmap_get(virt_pages_bitmap, start + i))
+            i++;
+
+        if (i == count)
+            return start;
+    }
+
+    return -1;
+}
+
+/* the window lock must be held */
+static void unmap_slab_pages(void * vaddr, uint32_t count) {
+    uint32_t first_page = ((uint32_t)vaddr - KMEM_CACHE_VIRT_START) / PAGE_SIZE;
+
+    for (uint32_t i = 0; i < count; i++) {
+        void * page = (uint8_t *)vaddr + i * PAGE_SIZE;
+
+        pmm_free_frame(paging_get_mapping(page));
+        paging_unmap_page(page);
+        bitmap_clear(virt_pages_bitmap, first_page + i);
+    }
+}
+
+static void release_slab_pages(void * vaddr, uint32_t count) {
+    uint32_t eflags = lock_acquire_irqsave(&window_lock);
+    unmap_slab_pages(vaddr, count);
+    lock_release_irqrestore(&window_lock, eflags);
+}
+
+/* map count pages backed by (possibly discontiguous) frames, NULL if out of memory */
+static void * alloc_slab_pages(uint32_t count) {
+    uint32_t eflags = lock_acquire_irqsave(&window_lock);
+
+    int32_t first_page = find_virt_pages(count);
+    if (first_page < 0) {
+        lock_release_irqrestore(&window_lock, eflags);
+        return NULL;
+    }
+
+    void * vaddr = (void *)(KMEM_CACHE_VIRT_START + first_page * PAGE_SIZE);
+
+    for (uint32_t i = 0; i < count; i++) {
+        void * frame = pmm_alloc_frame();
+
+        if (frame == NULL) {
+            unmap_slab_pages(vaddr, i);
+            lock_release_irqrestore(&window_lock, eflags);
+            return NULL;
+        }
+
+        bitmap_set(virt_pages_bitmap, first_page + i);
+        paging_map_page((uint8_t *)vaddr + i * PAGE_SIZE, frame, PG_PRESENT | PG_WRITABLE);
+    }
+
+    lock_release_irqrestore(&window_lock, eflags);
+    return vaddr;
+}
+
+static void slab_list_add(kmem_slab_t ** list, kmem_slab_t * slab) {
+    slab->previous = NULL;
+    slab->next = *list;
+
+    if (*list != NULL)
+        (*list)->previous = slab;
+
+    *list = slab;
+}
+
+static void slab_list_remove(kmem_slab_t ** list, kmem_slab_t * slab) {
+    if (slab->previous != NULL)
+        slab->previous->next = slab->next;
+    else
+        *list = slab->next;
+
+    if (slab->next != NULL)
+        slab->next->previous = slab->previous;
+
+    slab->previous = NULL;
+    slab->next = NULL;
+}
+
+static kmem_slab_t * slab_create(kmem_cache_t * cache) {
+    kmem_slab_t * slab = alloc_slab_pages(cache->slab_pages);
+    if (slab == NULL)
+        return NULL;
+
+    slab->cache = cache;
+    slab->in_use = 0;
+    slab->free_list = NULL;
+
+    /* link every object into the free list, the first object ends up at the head */
+    uint8_t * objects = (uint8_t *)slab + cache->objects_offset;
+    for (uint32_t i = cache->objects_per_slab; i > 0; i--) {
+        void ** object = (void **)(objects + (i - 1) * cache->object_size);
+        *object = slab->free_list;
+        slab->free_list = object;
+    }
+
+    return slab;
+}
+
+static void cache_setup(kmem_cache_t * cache, const char * name, size_t object_size, size_t align) {
+    memset(cache, 0, sizeof(kmem_cache_t));
+
+    cache->name = name;
+    cache->align = align;
+    cache->object_size = ALIGN_UP(object_size < sizeof(void *) ? sizeof(void *) : object_size, align);
+    cache->objects_offset = ALIGN_UP(sizeof(kmem_slab_t), align);  /* slabs are page aligned, so are the objects */
+    cache->slab_pages = 1;
+
+    while (cache->slab_pages < KMEM_CACHE_MAX_SLAB_PAGES &&
+           (cache->slab_pages * PAGE_SIZE - cache->objects_offset) / cache->object_size < KMEM_CACHE_MIN_OBJECTS)
+        cache->slab_pages *= 2;
+
+    cache->objects_per_slab = (cache->slab_pages * PAGE_SIZE - cache->objects_offset) / cache->object_size;
+    lock_init(&cache->lock);
+
+    uint32_t eflags = lock_acquire_irqsave(&window_lock);
+    cache->next = caches;
+    caches = cache;
+    lock_release_irqrestore(&window_lock, eflags);
+}
+
+void kmem_cache_init() {
+    memset(virt_pages_bitmap, 0, sizeof(virt_pages_bitmap));
+    caches = NULL;
+    lock_init(&window_lock);
+
+    cache_setup(&cache_cache, "kmem_cache_t", sizeof(kmem_cache_t), KMEM_CACHE_ALIGN);
+}
+
+kmem_cache_t * kmem_cache_create(const char * name, size_t object_size) {
+    return kmem_cache_create_aligned(name, object_size, KMEM_CACHE_ALIGN);
+}
+
+kmem_cache_t * kmem_cache_create_aligned(const char * name, size_t object_size, size_t align) {
+    if (align < KMEM_CACHE_ALIGN || align > PAGE_SIZE || (align & (align - 1)))
+        return NULL;
+
+    if (object_size == 0 || ALIGN_UP(object_size, align) > KMEM_CACHE_MAX_SLAB_PAGES * PAGE_SIZE - ALIGN_UP(sizeof(kmem_slab_t), align))
+        return NULL;
+
+    kmem_cache_t * cache = kmem_cache_alloc(&cache_cache);
+    if (cache == NULL)
+        return NULL;
+
+    cache_setup(cache, name, object_size, align);
+
+    return cache;
+}
+
+void kmem_cache_destroy(kmem_cache_t * cache) {
+    if (cache == NULL) return;
+
+    if (cache->objects_in_use != 0) PANIC("Destroying a cache with objects still in use");
+
+    uint32_t eflags = lock_acquire_irqsave(&cache->lock);
+    while (cache->slabs_empty != NULL) {
+        kmem_slab_t * slab = cache->slabs_empty;
+        slab_list_remove(&cache->slabs_empty, slab);
+        release_slab_pages(slab, cache->slab_pages);
+    }
+    lock_release_irqrestore(&cache->lock, eflags);
+
+    /* unlink from the caches list */
+    eflags = lock_acquire_irqsave(&window_lock);
+    kmem_cache_t ** link = &caches;
+    while (*link != NULL && *link != cache)
+        link = &(*link)->next;
+    if (*link != NULL)
+        *link = cache->next;
+    lock_release_irqrestore(&window_lock, eflags);
+
+    kmem_cache_free(&cache_cache, cache);
+}
+
+void * kmem_cache_alloc(kmem_cache_t * cache) {
+    uint32_t eflags = lock_acquire_irqsave(&cache->lock);
+    kmem_slab_t * slab = cache->slabs_partial;
+
+    if (slab == NULL) {
+        slab = cache->slabs_empty;
+
+        if (slab != NULL) {
+            slab_list_remove(&cache->slabs_empty, slab);
+            cache->empty_count--;
+        } else {
+            slab = slab_create(cache);
+            if (slab == NULL) {
+                lock_release_irqrestore(&cache->lock, eflags);
+                return NULL;  /* no more memory */
+            }
+        }
+
+        slab_list_add(&cache->slabs_partial, slab);
+    }
+
+    void ** object = slab->free_list;
+    slab->free_list = *object;
+    slab->in_use++;
+    cache->objects_in_use++;
+
+    if (slab->in_use == cache->objects_per_slab) {
+        slab_list_remove(&cache->slabs_partial, slab);
+        slab_list_add(&cache->slabs_full, slab);
+    }
+
+    lock_release_irqrestore(&cache->lock, eflags);
+    return object;
+}
+
+void kmem_cache_free(kmem_cache_t * cache, void * object) {
+    if (object == NULL) return;
+
+    kmem_slab_t * slab = SLAB_OF(cache, object);
+
+    if (slab->cache != cache) PANIC("Object freed to the wrong cache");
+
+    uint32_t eflags = lock_acquire_irqsave(&cache->lock);
+
+    if (slab->in_use == cache->objects_per_slab) {
+        slab_list_remove(&cache->slabs_full, slab);
+        slab_list_add(&cache->slabs_partial, slab);
+    }
+
+    *(void **)object = slab->free_list;
+    slab->free_list = object;
+    slab->in_use--;
+    cache->objects_in_use--;
+
+    if (slab->in_use == 0) {
+        slab_list_remove(&cache->slabs_partial, slab);
+
+        /* keep a few empty slabs for the next allocations, give the rest back */
+        if (cache->empty_count < KMEM_CACHE_MAX_EMPTY_SLABS) {
+            slab_list_add(&cache->slabs_empty, slab);
+            cache->empty_count++;
+        } else {
+            release_slab_pages(slab, cache->slab_pages);
+        }
+    }
+
+    lock_release_irqrestore(&cache->lock, eflags);
+}
+
+void print_kmem_cache_status() {
+    printf("--- Kernel Object Caches Status ---\n");
+
+    for (kmem_cache_t * cache = caches; cache != NULL; cache = cache->next)
+        printf("%s: object size %d, %d per slab of %d pages, %d in use\n",
+               cache->name, cache->object_size, cache->objects_per_slab, cache->slab_pages, cache->objects_in_use);
+
+    printf("--- End of Kernel Object Caches Status ---\n");
+}
\ No newline at end of file
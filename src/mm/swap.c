@@ -0,0 +1,296 @@
+#include "kernel/panic.h"
+#include "mm/swap.h"
+#include "mm/kheap.h"
+#include "mm/highmem.h"
+#include "mm/paging.h"
+#include "mm/pmm.h"
+#include "mm/vmalloc.h"
+#include "multitasking/lock.h"
+#include "multitasking/sync.h"
+#include "utils/utils.h"
+
+#define PF_PRESENT 0x1  /* the fault was a protection violation on a present page */
+
+static uint8_t enabled;
+static ata_drive_t * swap_drive;   /* NULL if the swap area has no disk part */
+static uint32_t swap_start_sector;
+static uint32_t slots_count;       /* ram slots first, then disk slots */
+static uint32_t ram_slots;
+static uint32_t used_slots;
+static uint32_t used_ram_slots;
+static uint32_t ram_cursor;        /* next fit search start in the ram slots */
+static uint32_t disk_cursor;       /* next fit search start in the disk slots */
+static uint8_t * slot_refs;        /* entries referring to each slot, 0 - free */
+static uint32_t * ram_blocks;      /* the high memory block behind every SWAP_SLOTS_PER_BLOCK ram slots */
+
+static page_list_t anon_lru;       /* head - the clock hand */
+static uint32_t * reverse_map;     /* virtual address of every tracked frame, indexed by frame number */
+
+static uint8_t bounce[PAGE_SIZE] __attribute__((aligned(PAGE_SIZE)));        /* swap_out, interrupts off */
+static uint8_t fault_bounce[PAGE_SIZE] __attribute__((aligned(PAGE_SIZE)));  /* disk reads of swap_handle_fault, interrupts on */
+static mutex_t fault_bounce_lock;
+
+uint32_t swap_init(ata_drive_t * drive, uint32_t max_slots) {
+    uint32_t frames = page_db_frames_count();
+    if (frames == 0) return 0;
+
+    /* leave at least three quarters of the drive to the file system */
+    uint32_t disk_slots = drive != NULL ? drive->size_in_sectors / SWAP_SECTORS_PER_SLOT / 4 : 0;
+    if (disk_slots > max_slots)
+        disk_slots = max_slots;
+
+    /* RAM above 4 GiB is useless for anything else, all of it becomes the fast tier */
+    uint32_t blocks = highmem_free_blocks();
+    if (blocks > (SWAP_SLOT_LIMIT - disk_slots) / SWAP_SLOTS_PER_BLOCK)
+        blocks = (SWAP_SLOT_LIMIT - disk_slots) / SWAP_SLOTS_PER_BLOCK;
+
+    uint32_t slots = blocks * SWAP_SLOTS_PER_BLOCK + disk_slots;
+    if (slots == 0) return 0;
+
+    slot_refs = kalloc(slots);
+    ram_blocks = blocks != 0 ? kalloc(blocks * sizeof(uint32_t)) : NULL;
+    reverse_map = vmalloc(frames * sizeof(uint32_t));
+    if (slot_refs == NULL || reverse_map == NULL || (blocks != 0 && ram_blocks == NULL)) {
+        kfree(slot_refs);
+        kfree(ram_blocks);
+        vfree(reverse_map);
+        return 0;
+    }
+    memset(slot_refs, 0, slots);
+
+    for (uint32_t i = 0; i < blocks; i++)
+        ram_blocks[i] = highmem_alloc_block();
+
+    if (disk_slots != 0) {
+        drive->size_in_sectors -= disk_slots * SWAP_SECTORS_PER_SLOT;
+        swap_start_sector = drive->size_in_sectors;
+        swap_drive = drive;
+    }
+
+    mutex_init(&fault_bounce_lock);
+    ram_slots = blocks * SWAP_SLOTS_PER_BLOCK;
+    slots_count = slots;
+    used_slots = 0;
+    used_ram_slots = 0;
+    ram_cursor = 0;
+    disk_cursor = ram_slots;
+    enabled = 1;
+
+    return slots;
+}
+
+uint8_t swap_enabled() {
+    return enabled;
+}
+
+uint32_t swap_ram_slots() {
+    return ram_slots;
+}
+
+void swap_track_page(uint32_t paddr, uint32_t vaddr) {
+    page_t * page = page_from_frame(paddr);
+    if (!enabled || page == NULL || (page->flags & (PAGE_SWAPPABLE | PAGE_PINNED))) return;
+
+    uint32_t eflags = irq_save();
+    reverse_map[paddr / PAGE_SIZE] = vaddr & ~(PAGE_SIZE - 1);
+    page->flags |= PAGE_SWAPPABLE;
+    page_list_add_tail(&anon_lru, page);
+    irq_restore(eflags);
+}
+
+void swap_untrack_page(page_t * page) {
+    if (!(page->flags & PAGE_SWAPPABLE)) return;
+
+    uint32_t eflags = irq_save();
+    page_list_remove(&anon_lru, page);
+    page->flags &= ~PAGE_SWAPPABLE;
+    irq_restore(eflags);
+}
+
+/* a free slot of [first, end) marked used, starting at *cursor, -1 if there is none */
+static int32_t alloc_slot_in(uint32_t first, uint32_t end, uint32_t * cursor) {
+    for (uint32_t i = 0; i < end - first; i++) {
+        uint32_t slot = first + (*cursor - first + i) % (end - first);
+
+        if (slot_refs[slot] == 0) {
+            slot_refs[slot] = 1;
+            *cursor = slot + 1 < end ? slot + 1 : first;
+            used_slots++;
+            if (slot < ram_slots)
+                used_ram_slots++;
+            return slot;
+        }
+    }
+
+    return -1;
+}
+
+/* a free slot marked used, ram slots first, -1 if the swap area is full */
+static int32_t alloc_slot(uint8_t allow_disk) {
+    int32_t slot = alloc_slot_in(0, ram_slots, &ram_cursor);
+
+    if (slot < 0 && allow_disk && swap_drive != NULL)
+        slot = alloc_slot_in(ram_slots, slots_count, &disk_cursor);
+
+    return slot;
+}
+
+/* where the page of a ram slot lives, the window stays valid while interrupts are off */
+static void * ram_slot_addr(uint32_t slot) {
+    uint8_t * block = highmem_map_block(ram_blocks[slot / SWAP_SLOTS_PER_BLOCK]);
+
+    return block + (slot % SWAP_SLOTS_PER_BLOCK) * PAGE_SIZE;
+}
+
+void swap_dup_slot(uint32_t slot) {
+    if (slot >= slots_count || slot_refs[slot] == 0) PANIC("Duplicating a free swap slot");
+    if (slot_refs[slot] == 0xFF) PANIC("Swap slot reference overflow");
+
+    slot_refs[slot]++;
+}
+
+void swap_put_slot(uint32_t slot) {
+    if (slot >= slots_count || slot_refs[slot] == 0) return;
+
+    if (--slot_refs[slot] == 0) {
+        used_slots--;
+        if (slot < ram_slots)
+            used_ram_slots--;
+    }
+}
+
+uint32_t swap_used_slots() {
+    return used_slots;
+}
+
+uint32_t swap_used_ram_slots() {
+    return used_ram_slots;
+}
+
+/* write page out and free its frame, 0 - success, called with interrupts off */
+static uint8_t swap_out(page_t * page, page_directory_t * dir, uint32_t vaddr, uint8_t allow_disk) {
+    uint32_t frame = page_to_frame(page);
+
+    int32_t slot = alloc_slot(allow_disk);
+    if (slot < 0) return 1;
+
+    /* no access is possible once the entry is gone, so the copy is the final content */
+    if (paging_swap_out_entry(dir, (void *)vaddr, slot) != 0) {
+        swap_put_slot(slot);
+        return 1;
+    }
+
+    if ((uint32_t)slot < ram_slots) {
+        paging_read_frame(frame, ram_slot_addr(slot));
+    } else {
+        paging_read_frame(frame, bounce);
+
+        if (ata_write28_request(swap_drive, swap_start_sector + (slot - ram_slots) * SWAP_SECTORS_PER_SLOT, SWAP_SECTORS_PER_SLOT, bounce) != ATA_OK) {
+            /* the frame still holds the data, put it back */
+            paging_swap_in_entry(dir, (void *)vaddr, frame);
+            swap_put_slot(slot);
+            return 1;
+        }
+    }
+
+    page->owner = NULL;
+    page->flags &= ~PAGE_SWAPPABLE;
+    pmm_free_frame((void *)frame);
+
+    return 0;
+}
+
+uint32_t swap_reclaim(uint32_t count) {
+    if (!enabled) return 0;
+
+    uint32_t eflags = irq_save();
+
+    /* the drive is in the middle of another request (its owner was preempted), waiting with interrupts off would never end */
+    uint8_t allow_disk = swap_drive != NULL && !swap_drive->lock.locked;
+    if (!allow_disk && used_ram_slots == ram_slots) {
+        irq_restore(eflags);
+        return 0;
+    }
+    uint32_t reclaimed = 0;
+    uint32_t budget = 2 * anon_lru.count;  /* every page gets at most one second chance per call */
+
+    while (reclaimed < count && budget-- > 0) {
+        page_t * page = page_list_pop_head(&anon_lru);
+        if (page == NULL) break;
+
+        uint32_t vaddr = reverse_map[page_to_frame(page) / PAGE_SIZE];
+        page_directory_t * dir = page->owner;
+
+        /* the address space that mapped it is gone (or mapped something else there since), the page stays resident */
+        if (dir == NULL || !paging_maps_frame(dir, (void *)vaddr, page_to_frame(page))) {
+            page->flags &= ~PAGE_SWAPPABLE;
+            continue;
+        }
+
+        /* shared copy-on-write pages and recently used ones go around again */
+        if (page->refcount != 1 || paging_test_and_clear_accessed(dir, (void *)vaddr)) {
+            page_list_add_tail(&anon_lru, page);
+            continue;
+        }
+
+        if (swap_out(page, dir, vaddr, allow_disk) == 0)
+            reclaimed++;
+        else
+            page_list_add_tail(&anon_lru, page);
+    }
+
+    irq_restore(eflags);
+    return reclaimed;
+}
+
+uint8_t swap_handle_fault(uint32_t addr, uint32_t err_code) {
+    if (!enabled || (err_code & PF_PRESENT)) return 0;
+
+    page_directory_t * dir = paging_get_current_directory();
+    uint32_t page = addr & ~(PAGE_SIZE - 1);
+    uint32_t slot;
+
+    if (!paging_get_swap_slot(dir, (void *)page, &slot)) return 0;
+
+    /* get the frame first, it may push other pages out */
+    void * frame = pmm_alloc_frame();
+    if (frame == NULL) return 0;
+
+    /* the drive may be busy with another thread, wait for it with interrupts on */
+    if (slot >= ram_slots) {
+        paging_fault_io_begin();
+        mutex_lock(&fault_bounce_lock);
+
+        ata_error_t err = ata_read28_request(swap_drive, swap_start_sector + (slot - ram_slots) * SWAP_SECTORS_PER_SLOT, SWAP_SECTORS_PER_SLOT, fault_bounce);
+        if (err == ATA_OK)
+            paging_write_frame((uint32_t)frame, fault_bounce);
+
+        mutex_unlock(&fault_bounce_lock);
+        paging_fault_io_end();
+
+        if (err != ATA_OK) {
+            pmm_free_frame(frame);
+            return 0;
+        }
+    }
+
+    uint32_t eflags = irq_save();
+
+    /* another thread of this address space may have brought it back (or unmapped it) during the read, the access is retried */
+    uint32_t current_slot;
+    if (!paging_get_swap_slot(dir, (void *)page, &current_slot) || current_slot != slot) {
+        irq_restore(eflags);
+        pmm_free_frame(frame);
+        return 1;
+    }
+
+    if (slot < ram_slots)
+        paging_write_frame((uint32_t)frame, ram_slot_addr(slot));
+    paging_swap_in_entry(dir, (void *)page, (uint32_t)frame);
+    swap_put_slot(slot);
+
+    irq_restore(eflags);
+
+    swap_track_page((uint32_t)frame, page);
+    return 1;
+}
\ No newline at end of file
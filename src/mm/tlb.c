@@ -0,0 +1,83 @@
+#include "mm/tlb.h"
+#include "mm/paging.h"
+
+#define CPUID_FEATURE_PGE (1 << 13)
+
+static uint8_t global_pages_supported;
+
+static inline uint32_t read_cr4() {
+    uint32_t cr4;
+    asm volatile("mov %%cr4, %0" : "=r"(cr4));
+    return cr4;
+}
+
+static inline void write_cr4(uint32_t cr4) {
+    asm volatile("mov %0, %%cr4" :: "r"(cr4) : "memory");
+}
+
+static uint32_t cpuid_features() {
+    uint32_t eax = 1, ebx, ecx, edx;
+    asm volatile("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    return edx;
+}
+
+void tlb_init() {
+    global_pages_supported = (cpuid_features() & CPUID_FEATURE_PGE) != 0;
+
+    if (global_pages_supported)
+        tlb_set_global_pages(1);
+}
+
+uint8_t tlb_global_pages_enabled() {
+    return (read_cr4() & CR4_PGE) != 0;
+}
+
+void tlb_set_global_pages(uint8_t enable) {
+    if (!global_pages_supported) return;
+
+    /* any write that changes CR4.PGE flushes the whole TLB, global entries included */
+    if (enable)
+        write_cr4(read_cr4() | CR4_PGE);
+    else
+        write_cr4(read_cr4() & ~CR4_PGE);
+}
+
+void tlb_flush_page(void * vaddr) {
+    asm volatile("invlpg (%0)" :: "r"(vaddr) : "memory");
+}
+
+void tlb_flush_range(void * vaddr, size_t size) {
+    uint32_t start = (uint32_t)vaddr & ~(PAGE_SIZE - 1);
+    uint32_t end = (uint32_t)vaddr + size;
+    uint32_t pages = (end - start + PAGE_SIZE - 1) / PAGE_SIZE;
+
+    if (pages > TLB_FLUSH_FULL_THRESHOLD) {
+        /* kernel mappings are global, a cr3 reload leaves them in the TLB */
+        if (start >= 0xC0000000 || end > 0xC0000000)
+            tlb_flush_global();
+        else
+            tlb_flush_all();
+        return;
+    }
+
+    for (uint32_t page = start; page < end; page += PAGE_SIZE)
+        tlb_flush_page((void *)page);
+}
+
+void tlb_flush_all() {
+    uint32_t cr3;
+    asm volatile("mov %%cr3, %0" : "=r"(cr3));
+    asm volatile("mov %0, %%cr3" :: "r"(cr3) : "memory");
+}
+
+void tlb_flush_global() {
+    uint32_t cr4 = read_cr4();
+
+    if (cr4 & CR4_PGE) {
+        /* toggling PGE drops the global entries too */
+        write_cr4(cr4 & ~CR4_PGE);
+        write_cr4(cr4);
+    } else {
+        tlb_flush_all();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,289 @@
+#include "drivers/flatfs/flatfs_driver.h"
+#include "kernel/panic.h"
+#include "mm/vm_region.h"
+#include "mm/page.h"
+#include "mm/paging.h"
+#include "mm/pmm.h"
+#include "mm/slab.h"
+#include "mm/swap.h"
+#include "utils/utils.h"
+
+#define ALIGN_UP(x, a)   (((x) + (a) - 1) & ~((a) - 1))
+#define ALIGN_DOWN(x, a) ((x) & ~((a) - 1))
+
+#define PF_PRESENT 0x1  /* the fault was a protection violation on a present page */
+#define PF_WRITE   0x2  /* the fault was a write */
+
+#define FILE_PAGE(region, page) ((region)->file_page + ((page) - (region)->start) / PAGE_SIZE)
+
+static kmem_cache_t * region_cache;
+
+/* the page every untouched read of a region sees, it is in the kernel image so it is zero from boot */
+static uint8_t zero_page[PAGE_SIZE] __attribute__((aligned(PAGE_SIZE)));
+
+void vm_region_init() {
+    region_cache = kmem_cache_create("vm_region_t", sizeof(vm_region_t));
+    if (region_cache == NULL) PANIC("No memory for the region cache");
+}
+
+uint32_t vm_region_zero_page() {
+    return (uint32_t)zero_page - 0xC0000000;
+}
+
+vm_region_t * vm_region_find(page_directory_t * dir, uint32_t addr) {
+    for (vm_region_t * region = dir->regions; region != NULL && region->start <= addr; region = region->next)
+        if (addr < region->end)
+            return region;
+
+    return NULL;
+}
+
+/* first gap of at least length bytes in [VM_MMAP_BASE, VM_MMAP_END), 0 if there is none */
+static uint32_t find_free_range(page_directory_t * dir, uint32_t length) {
+    uint32_t candidate = VM_MMAP_BASE;
+
+    for (vm_region_t * region = dir->regions; region != NULL; region = region->next) {
+        if (region->end <= candidate) continue;
+        if (region->start >= candidate + length) break;
+        candidate = region->end;
+    }
+
+    return (candidate + length <= VM_MMAP_END && candidate + length > candidate) ? candidate : 0;
+}
+
+void * vm_region_reserve(page_directory_t * dir, void * addr, size_t length, uint32_t page_flags) {
+    return vm_region_reserve_file(dir, addr, length, page_flags, NULL, 0);
+}
+
+void * vm_region_reserve_file(page_directory_t * dir, void * addr, size_t length, uint32_t page_flags,
+                              struct flatfs_mapping_struct * file, uint32_t file_page) {
+    if (length == 0 || length > VM_MMAP_END) return NULL;
+    length = ALIGN_UP(length, PAGE_SIZE);
+
+    uint32_t start = (uint32_t)addr;
+    if (start == 0)
+        start = find_free_range(dir, length);
+
+    if (start == 0 || start & (PAGE_SIZE - 1) || start + length > VM_MMAP_END || start + length < start)
+        return NULL;
+
+    /* find where the region goes, it must not overlap its neighbours */
+    vm_region_t ** link = &dir->regions;
+    while (*link != NULL && (*link)->end <= start)
+        link = &(*link)->next;
+
+    if (*link != NULL && (*link)->start < start + length)
+        return NULL;
+
+    vm_region_t * region = kmem_cache_alloc(region_cache);
+    if (region == NULL) return NULL;
+
+    region->start = start;
+    region->end = start + length;
+    region->page_flags = page_flags & (PG_WRITABLE | PG_USER);
+    region->file = file;
+    region->file_page = file_page;
+    region->next = *link;
+    *link = region;
+
+    return (void *)start;
+}
+
+uint8_t vm_region_clone(page_directory_t * dst, page_directory_t * src) {
+    vm_region_t ** link = &dst->regions;
+
+    for (vm_region_t * region = src->regions; region != NULL; region = region->next) {
+        vm_region_t * copy = kmem_cache_alloc(region_cache);
+        if (copy == NULL) return 1;
+
+        copy->start = region->start;
+        copy->end = region->end;
+        copy->page_flags = region->page_flags;
+        copy->file = region->file;
+        copy->file_page = region->file_page;
+        copy->next = NULL;
+
+        if (copy->file != NULL)
+            flatfs_mapping_get(copy->file);
+
+        *link = copy;
+        link = &copy->next;
+    }
+
+    return 0;
+}
+
+void vm_region_destroy_all(page_directory_t * dir) {
+    while (dir->regions != NULL) {
+        vm_region_t * region = dir->regions;
+        dir->regions = region->next;
+
+        if (region->file != NULL)
+            flatfs_mapping_put(region->file);
+        kmem_cache_free(region_cache, region);
+    }
+}
+
+/* write a page of a file region back if it was written through any mapping, 0 - clean or written, 1 - I/O error */
+static uint8_t sync_file_page(page_directory_t * dir, vm_region_t * region, uint32_t page, uint32_t frame) {
+    page_t * descriptor = page_from_frame(frame);
+    uint8_t dirty = paging_test_and_clear_dirty(dir, (void *)page);
+
+    if (descriptor != NULL && (descriptor->flags & PAGE_DIRTY))
+        dirty = 1;
+    if (!dirty) return 0;
+
+    /* the blocks are written straight from the mapping, the page stays dirty if that fails */
+    if (flatfs_mapping_write_page(region->file, FILE_PAGE(region, page), (void *)page) != FLATFS_OK) {
+        if (descriptor != NULL)
+            descriptor->flags |= PAGE_DIRTY;
+        return 1;
+    }
+
+    if (descriptor != NULL)
+        descriptor->flags &= ~PAGE_DIRTY;
+    return 0;
+}
+
+/* unmap the committed pages of [start, end) of region, frames other than the zero page go back to the pmm */
+static void release_pages(page_directory_t * dir, vm_region_t * region, uint32_t start, uint32_t end) {
+    for (uint32_t page = start; page < end; page += PAGE_SIZE) {
+        if (dir->tables[page >> 22] == NULL) {
+            page = ALIGN_UP(page + 1, LARGE_PAGE_SIZE) - PAGE_SIZE;  /* no table, skip the whole 4 MiB slot */
+            continue;
+        }
+
+        uint32_t frame = (uint32_t)paging_get_mapping((void *)page);
+        if (frame == 0) continue;
+
+        if (region->file != NULL)
+            sync_file_page(dir, region, page, frame);
+
+        if (frame != vm_region_zero_page())
+            pmm_free_frame((void *)frame);
+    }
+
+    paging_unmap_range((void *)start, end - start);
+}
+
+uint8_t vm_region_release(page_directory_t * dir, void * addr, size_t length) {
+    uint32_t start = (uint32_t)addr;
+    uint32_t end = start + ALIGN_UP(length, PAGE_SIZE);
+
+    if (length == 0 || start & (PAGE_SIZE - 1) || end < start) return 1;
+
+    vm_region_t ** link = &dir->regions;
+    while (*link != NULL && (*link)->start < end) {
+        vm_region_t * region = *link;
+
+        if (region->end <= start) {
+            link = &region->next;
+            continue;
+        }
+
+        uint32_t cut_start = region->start > start ? region->start : start;
+        uint32_t cut_end = region->end < end ? region->end : end;
+        release_pages(dir, region, cut_start, cut_end);
+
+        if (cut_start > region->start && cut_end < region->end) {
+            /* a hole in the middle, split the region in two */
+            vm_region_t * tail = kmem_cache_alloc(region_cache);
+            if (tail == NULL) PANIC("No memory to split a region");
+
+            tail->start = cut_end;
+            tail->end = region->end;
+            tail->page_flags = region->page_flags;
+            tail->file = region->file;
+            tail->file_page = region->file != NULL ? FILE_PAGE(region, cut_end) : 0;
+            tail->next = region->next;
+
+            if (tail->file != NULL)
+                flatfs_mapping_get(tail->file);
+
+            region->end = cut_start;
+            region->next = tail;
+            break;
+        }
+
+        if (cut_start > region->start) {
+            region->end = cut_start;
+            link = &region->next;
+        } else if (cut_end < region->end) {
+            if (region->file != NULL)
+                region->file_page = FILE_PAGE(region, cut_end);
+            region->start = cut_end;
+            link = &region->next;
+        } else {
+            *link = region->next;
+
+            if (region->file != NULL)
+                flatfs_mapping_put(region->file);
+            kmem_cache_free(region_cache, region);
+        }
+    }
+
+    return 0;
+}
+
+uint8_t vm_region_sync(page_directory_t * dir, void * addr, size_t length) {
+    uint32_t start = (uint32_t)addr;
+    uint32_t end = start + ALIGN_UP(length, PAGE_SIZE);
+    uint8_t failed = 0;
+
+    if (length == 0 || start & (PAGE_SIZE - 1) || end < start) return 1;
+
+    for (vm_region_t * region = dir->regions; region != NULL && region->start < end; region = region->next) {
+        if (region->end <= start || region->file == NULL) continue;
+
+        uint32_t sync_start = region->start > start ? region->start : start;
+        uint32_t sync_end = region->end < end ? region->end : end;
+
+        for (uint32_t page = sync_start; page < sync_end; page += PAGE_SIZE) {
+            uint32_t frame = (uint32_t)paging_get_mapping((void *)page);
+
+            if (frame != 0 && sync_file_page(dir, region, page, frame))
+                failed = 1;
+        }
+    }
+
+    return failed;
+}
+
+uint8_t vm_region_handle_fault(uint32_t addr, uint32_t err_code) {
+    page_directory_t * dir = paging_get_current_directory();
+    vm_region_t * region = vm_region_find(dir, addr);
+
+    if (region == NULL) return 0;
+
+    uint32_t page = ALIGN_DOWN(addr, PAGE_SIZE);
+
+    /* file pages are mapped with their final rights at once, a present fault is a real violation */
+    if (region->file != NULL) {
+        if (err_code & PF_PRESENT) return 0;
+        if ((err_code & PF_WRITE) && !(region->page_flags & PG_WRITABLE)) return 0;
+
+        return flatfs_mapping_fault(region->file, FILE_PAGE(region, page), page, region->page_flags);
+    }
+
+    if (!(err_code & PF_WRITE)) {
+        /* first read, share the zero page until the first write */
+        if (err_code & PF_PRESENT) return 0;
+
+        paging_map_page((void *)page, (void *)vm_region_zero_page(), PG_PRESENT | (region->page_flags & PG_USER));
+        return 1;
+    }
+
+    if (!(region->page_flags & PG_WRITABLE)) return 0;
+
+    /* a write to an untouched page or to the zero page, give it its own frame */
+    if ((err_code & PF_PRESENT) && (uint32_t)paging_get_mapping((void *)page) != vm_region_zero_page())
+        return 0;
+
+    void * frame = pmm_alloc_zeroed_frame();
+    if (frame == NULL) return 0;
+
+    paging_map_page((void *)page, frame, PG_PRESENT | region->page_flags);
+    swap_track_page((uint32_t)frame, page);
+
+    return 1;
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "kernel/panic.h"
+#include "mm/vmalloc.h"
+#include "mm/paging.h"
+#include "mm/pmm.h"
+#include "mm/slab.h"
+#include "multitasking/lock.h"
+
+#define ALIGN_UP(x, a) (((x) + (a) - 1) & ~((a) - 1))
+
+#define VMALLOC_VIRT_END (VMALLOC_VIRT_START + VMALLOC_VIRT_SIZE)
+
+static kmem_cache_t * area_cache;  /* NULL until vmalloc_init */
+static vmalloc_area_t * areas;     /* sorted by address */
+static size_t used_size;
+static lock_t areas_lock;          /* taken with interrupts off, kalloc hands large requests over from interrupt handlers too */
+
+void vmalloc_init() {
+    area_cache = kmem_cache_create("vmalloc_area_t", sizeof(vmalloc_area_t));
+    if (area_cache == NULL) PANIC("No memory for the vmalloc area cache");
+
+    areas = NULL;
+    used_size = 0;
+    lock_init(&areas_lock);
+}
+
+uint8_t vmalloc_ready() {
+    return area_cache != NULL;
+}
+
+/* the first page of a mapped area (after the guard) */
+static uint32_t area_data(vmalloc_area_t * area) {
+    return area->start + ((area->flags & VMALLOC_GUARD) ? PAGE_SIZE : 0);
+}
+
+static uint32_t area_data_end(vmalloc_area_t * area) {
+    return area->end - ((area->flags & VMALLOC_GUARD) ? PAGE_SIZE : 0);
+}
+
+/* unmap [start, end) of the window and give the frames back */
+static void release_pages(uint32_t start, uint32_t end) {
+    for (uint32_t page = start; page < end; page += PAGE_SIZE)
+        pmm_free_frame(paging_get_mapping((void *)page));
+
+    paging_unmap_range((void *)start, end - start);
+}
+
+void * vmalloc(size_t size) {
+    return vmalloc_flags(size, 0);
+}
+
+void * vmalloc_flags(size_t size, uint32_t flags) {
+    if (area_cache == NULL || size == 0 || size > VMALLOC_VIRT_SIZE) return NULL;
+
+    uint32_t length = ALIGN_UP(size, PAGE_SIZE) + ((flags & VMALLOC_GUARD) ? 2 * PAGE_SIZE : 0);
+
+    uint32_t eflags = lock_acquire_irqsave(&areas_lock);
+
+    /* first fit over the gaps between the areas */
+    uint32_t candidate = VMALLOC_VIRT_START;
+    vmalloc_area_t ** link = &areas;
+
+    while (*link != NULL && (*link)->start < candidate + length) {
+        candidate = (*link)->end;
+        link = &(*link)->next;
+    }
+
+    vmalloc_area_t * area = candidate + length <= VMALLOC_VIRT_END ? kmem_cache_alloc(area_cache) : NULL;
+    if (area == NULL) {
+        lock_release_irqrestore(&areas_lock, eflags);
+        return NULL;
+    }
+
+    area->start = candidate;
+    area->end = candidate + length;
+    area->flags = flags;
+
+    uint32_t data = area_data(area);
+    uint32_t data_end = area_data_end(area);
+
+    for (uint32_t page = data; page < data_end; page += PAGE_SIZE) {
+        void * frame = pmm_alloc_frame();
+
+        if (frame == NULL) {
+            release_pages(data, page);
+            kmem_cache_free(area_cache, area);
+            lock_release_irqrestore(&areas_lock, eflags);
+            return NULL;
+        }
+
+        paging_map_page((void *)page, frame, PG_PRESENT | PG_WRITABLE);
+    }
+
+    area->next = *link;
+    *link = area;
+    used_size += data_end - data;
+
+    lock_release_irqrestore(&areas_lock, eflags);
+    return (void *)data;
+}
+
+void vfree(void * addr) {
+    if (addr == NULL) return;
+
+    uint32_t eflags = lock_acquire_irqsave(&areas_lock);
+
+    vmalloc_area_t ** link = &areas;
+    while (*link != NULL && area_data(*link) != (uint32_t)addr)
+        link = &(*link)->next;
+
+    if (*link == NULL) PANIC("vfree of an address vmalloc did not return");
+
+    vmalloc_area_t * area = *link;
+    *link = area->next;
+
+    release_pages(area_data(area), area_data_end(area));
+    used_size -= area_data_end(area) - area_data(area);
+
+    kmem_cache_free(area_cache, area);
+
+    lock_release_irqrestore(&areas_lock, eflags);
+}
+
+uint8_t is_vmalloc_addr(void * addr) {
+    return (uint32_t)addr >= VMALLOC_VIRT_START && (uint32_t)addr < VMALLOC_VIRT_END;
+}
+
+size_t vmalloc_used_size() {
+    return used_size;
+}
\ No newline at end of file
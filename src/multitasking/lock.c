@@ -1,16 +1,38 @@
-#include "multitasking/lock.h"
-
-void lock_init(lock_t * lock) {
-    lock->state = LOCK_FREE;
-}
-void lock_acquire(lock_t *lock) {
-    while (__sync_lock_test_and_set(&lock->state, LOCK_LOCKED)) {
-        while (lock->state == LOCK_LOCKED) {
-            __asm__ __volatile__("pause");
-        }
-    }
-}
-
-void lock_release(lock_t *lock) {
-    __sync_lock_release(&lock->state);
+#include "multitasking/lock.h"
+
+void lock_init(lock_t * lock) {
+    lock->state = LOCK_FREE;
+}
+void lock_acquire(lock_t *lock) {
+    while (__sync_lock_test_and_set(&lock->state, LOCK_LOCKED)) {
+        while (lock->state == LOCK_LOCKED) {
+            __asm__ __volatile__("pause");
+        }
+    }
+}
+
+void lock_release(lock_t *lock) {
+    __sync_lock_release(&lock->state);
+}
+
+uint32_t irq_save() {
+    uint32_t eflags;
+    __asm__ __volatile__("pushf; pop %0; cli" : "=r"(eflags) :: "memory");
+    return eflags;
+}
+
+void irq_restore(uint32_t eflags) {
+    if (eflags & EFLAGS_IF)
+        __asm__ __volatile__("sti" ::: "memory");
+}
+
+uint32_t lock_acquire_irqsave(lock_t * lock) {
+    uint32_t eflags = irq_save();
+    lock_acquire(lock);
+    return eflags;
+}
+
+void lock_release_irqrestore(lock_t * lock, uint32_t eflags) {
+    lock_release(lock);
+    irq_restore(eflags);
 }
\ No newline at end of file
@@ -1,66 +1,122 @@
-#include "multitasking/process.h"
-#include "mm/kheap.h"
-#include "mm/paging.h"
-#include "kernel/print.h"
-#include "utils/utils.h"
-
-static pid_t next_pid = 0;
-
-static const char *process_state_str(process_state_e state) {
-    switch (state) {
-        case PROCESS_NEW:     return "NEW";
-        case PROCESS_READY:   return "READY";
-        case PROCESS_RUNNING: return "RUNNING";
-        case PROCESS_BLOCKED: return "BLOCKED";
-        case PROCESS_ZOMBIE:  return "ZOMBIE";
-        default:              return "UNKNOWN";
-    }
-}
-
-void print_process_list(process_t *head) {
-    process_t *p = head;
-
-    printf(" PID      STATE            ESP          NEXT\n");
-    printf("---------------------------------------------------------\n");
-
-    while (p) {
-        printf("pid=%d state=%s esp=%p next=%p\n",
-                p->pid,
-                process_state_str(p->status),
-                (void *)p->esp,
-                (void *)p->next);
-
-        p = p->next;
-    }
-}
-
-process_t * process_create(process_type_e type, void (*entry)(void), size_t stack_size) {
-    void scheduler_thread_exit();
-
-    process_t * process = kalloc(sizeof(process_t));
-
-    if (process == NULL) return NULL; /* no more memory or error */
-    
-    memset(process, 0, sizeof(process_t));
-
-    process->pid = next_pid++;
-    process->status = PROCESS_NEW;
-    process->type = type;
-    process->esp = (uint32_t *)((uint32_t)kalloc(stack_size) + (stack_size - 1));
-    /* Since we don't don't *call* entry we just use *ret* when entry is in the stack top, 
-       the *ret* in the entry function would pop sheudler_thread_exit and redirect code to there */
-    *(--process->esp) = (uint32_t)scheduler_thread_exit;
-    *(--process->esp) = (uint32_t)entry;  /* Main Entry */
-    *(--process->esp) = 0;      /* edi */
-    *(--process->esp) = 0;      /* esi */
-    *(--process->esp) = 0;      /* ebp */
-    *(--process->esp) = 0;      /* esp, ignored by popa */
-    *(--process->esp) = 0;      /* ebx */
-    *(--process->esp) = 0;      /* edx */
-    *(--process->esp) = 0;      /* ecx */
-    *(--process->esp) = 0;      /* eax */
-    
-    process->next = NULL;
-
-    return process;
+#include "multitasking/process.h"
+#include "mm/kheap.h"
+#include "mm/slab.h"
+#include "mm/vmalloc.h"
+#include "mm/paging.h"
+#include "multitasking/lock.h"
+#include "multitasking/scheduler.h"
+#include "kernel/print.h"
+#include "kernel/panic.h"
+#include "utils/utils.h"
+
+#define EFLAGS_RESERVED (1 << 1)  /* always set */
+
+static pid_t next_pid = 0;
+static kmem_cache_t * process_cache;
+
+static const char *process_state_str(process_state_e state) {
+    switch (state) {
+        case PROCESS_NEW:     return "NEW";
+        case PROCESS_READY:   return "READY";
+        case PROCESS_RUNNING: return "RUNNING";
+        case PROCESS_BLOCKED: return "BLOCKED";
+        case PROCESS_SLEEPING: return "SLEEPING";
+        case PROCESS_ZOMBIE:  return "ZOMBIE";
+        default:              return "UNKNOWN";
+    }
+}
+
+void print_process_list(process_t *head) {
+    process_t *p = head;
+
+    printf(" PID      STATE            ESP          NEXT\n");
+    printf("---------------------------------------------------------\n");
+
+    while (p) {
+        printf("pid=%d state=%s esp=%p next=%p\n",
+                p->pid,
+                process_state_str(p->status),
+                (void *)p->esp,
+                (void *)p->next);
+
+        p = p->next;
+    }
+}
+
+void process_init() {
+    process_cache = kmem_cache_create("process_t", sizeof(process_t));
+
+    if (process_cache == NULL) PANIC("Unable to create the process cache");
+}
+
+process_t * process_create(process_type_e type, void (*entry)(void), size_t stack_size) {
+    /* the exited threads are only reaped in thread context, recycle their memory before taking more */
+    scheduler_reap_zombies();
+
+    process_t * process = kmem_cache_alloc(process_cache);
+
+    if (process == NULL) return NULL; /* no more memory or error */
+    
+    memset(process, 0, sizeof(process_t));
+
+    /* stacks get their own pages, an overflow hits the guard page below instead of a neighbour */
+    process->stack = vmalloc_flags(stack_size, VMALLOC_GUARD);
+
+    if (process->stack == NULL) {
+        kmem_cache_free(process_cache, process);
+        return NULL;
+    }
+
+    process->pid = next_pid++;
+    process->status = PROCESS_NEW;
+    process->type = type;
+    process->priority = PROCESS_PRIORITY_DEFAULT;
+    process->base_priority = PROCESS_PRIORITY_DEFAULT;
+    process->page_directory = paging_get_kernel_directory();
+    /* the entry function returns into scheduler_thread_exit, pushed like a return address under the first frame */
+    uint32_t * stack_top = (uint32_t *)(((uint32_t)process->stack + stack_size) & ~0xF);
+    *(--stack_top) = (uint32_t)scheduler_thread_exit;
+
+    /* the thread starts the way an interrupted one resumes: isr_common_stub pops this frame and irets into entry */
+    cpu_status_t * frame = (cpu_status_t *)stack_top - 1;
+    memset(frame, 0, sizeof(cpu_status_t));
+    frame->ds = 0x10;
+    frame->eip = (uint32_t)entry;
+    frame->cs = 0x08;
+    frame->eflags = EFLAGS_RESERVED | EFLAGS_IF;
+    process->esp = (uint32_t *)frame;
+
+    process->next = NULL;
+    process->previous = NULL;
+
+    return process;
+}
+
+process_t * process_clone(void (*entry)(void), size_t stack_size) {
+    process_t * process = process_create(PROCESS_KERNEL, entry, stack_size);
+
+    if (process == NULL) return NULL;
+
+    /* only the page tables are copied, the data is shared until one side writes it */
+    process->page_directory = paging_clone_directory();
+
+    if (process->page_directory == NULL) {
+        process->page_directory = paging_get_kernel_directory();
+        process_destroy(process);
+        return NULL;
+    }
+
+    return process;
+}
+
+void process_destroy(process_t * process) {
+    if (process == NULL) return;
+
+    if (process->page_directory != paging_get_kernel_directory())
+        paging_destroy_directory(process->page_directory);
+
+    kheap_magazine_flush(&process->heap_magazine);
+
+    vfree(process->stack);
+    kmem_cache_free(process_cache, process);
 }
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "multitasking/run_queue.h"
+#include "kernel/panic.h"
+#include "utils/utils.h"
+
+void process_list_push(process_list_t * list, process_t * process) {
+    if (process->next != NULL || process->previous != NULL || list->head == process)
+        PANIC("Added elements to the queues should not be entangled");
+
+    process->previous = list->tail;
+
+    if (list->tail != NULL)
+        list->tail->next = process;
+    else
+        list->head = process;
+
+    list->tail = process;
+    list->count++;
+}
+
+process_t * process_list_pop(process_list_t * list) {
+    process_t * process = list->head;
+
+    if (process != NULL)
+        process_list_remove(list, process);
+
+    return process;
+}
+
+void process_list_remove(process_list_t * list, process_t * process) {
+    if (process->previous != NULL)
+        process->previous->next = process->next;
+    else
+        list->head = process->next;
+
+    if (process->next != NULL)
+        process->next->previous = process->previous;
+    else
+        list->tail = process->previous;
+
+    process->previous = NULL;
+    process->next = NULL;
+    list->count--;
+}
+
+void run_queue_init(run_queue_t * queue) {
+    memset(queue, 0, sizeof(run_queue_t));
+}
+
+void run_queue_push(run_queue_t * queue, process_t * process) {
+    if (process->priority >= PROCESS_PRIORITIES) PANIC("Process priority out of range");
+
+    process_list_push(&queue->lists[process->priority], process);
+    queue->bitmap |= 1u << process->priority;
+    queue->count++;
+}
+
+process_t * run_queue_pop(run_queue_t * queue) {
+    if (queue->bitmap == 0) return NULL;
+
+    uint32_t priority = __builtin_ctz(queue->bitmap);
+    process_t * process = process_list_pop(&queue->lists[priority]);
+
+    if (queue->lists[priority].head == NULL)
+        queue->bitmap &= ~(1u << priority);
+    queue->count--;
+
+    return process;
+}
+
+void run_queue_remove(run_queue_t * queue, process_t * process) {
+    process_list_t * list = &queue->lists[process->priority];
+
+    process_list_remove(list, process);
+
+    if (list->head == NULL)
+        queue->bitmap &= ~(1u << process->priority);
+    queue->count--;
+}
+
+uint8_t run_queue_best_priority(run_queue_t * queue) {
+    return queue->bitmap == 0 ? PROCESS_PRIORITIES : __builtin_ctz(queue->bitmap);
+}
\ No newline at end of file
@@ -1,142 +1,296 @@
-#include "multitasking/scheduler.h"
-#include "kernel/print.h"
-#include "kernel/panic.h"
-#include "mm/kheap.h"
-#include "utils/utils.h"
-
-/* define in process */
-uint8_t scheduler_on;
-static process_t * idle_process;
-static process_t * processes_ready_queue;
-static process_t * processes_zombie_queue;
-static process_t * current_process;
-
-static void add_to_process_queue(process_t ** pqueue, process_t * element) {
-    if (pqueue == NULL) return;
-
-    if (element->next != NULL) PANIC("Added elements to the queues should not be entangled");
-
-    /* the queue is empty */
-    if (*pqueue == NULL) {
-        *pqueue = element;
-        return;
-    }
-
-    /* get the last element in the queue */
-    process_t * last = *pqueue;
-
-    while (last->next != NULL)
-        last = last->next;
-
-    last->next = element;
-}
-
-static process_t * remove_to_process_queue(process_t ** pqueue) {
-    if (pqueue == NULL) return NULL;
-
-    /* the queue is empty */
-    if (*pqueue == NULL) return NULL;
-
-    process_t * p = *pqueue;
-    *pqueue = p->next; /* note, this may set the queue as empty <=> p.next = NULL */
-
-    p->next = NULL;
-
-    return p;
-}
-
-/* Note: a system design is that current process can never be NULL
-   it may always have the idle process */
-void scheduler_init() {
-    void idle_process_main();
-
-    idle_process = process_create(PROCESS_IDLE, idle_process_main, 0x1000); /* idle thread stack doesn't need to be very long */
-    current_process = idle_process;
-    processes_ready_queue = NULL;
-    processes_zombie_queue = NULL;
-    scheduler_on = 0;
-}
-
-void scheduler_set_on() {
-    scheduler_on = 1;
-}
-
-void scheduler_add_process_to_ready_queue(process_t * process) {
-    process->status = PROCESS_READY;
-
-    add_to_process_queue(&processes_ready_queue, process);
-}
-
-static void scheduler_remove_zombie_processes() {
-    process_t * p = remove_to_process_queue(&processes_zombie_queue);
-
-    while (p != NULL) {
-        kfree(p);
-        p = remove_to_process_queue(&processes_zombie_queue);
-    }
-}
-
-process_t * scheduler_get_next_process() {
-    /* Important: may return the same process */
-    process_t * p = remove_to_process_queue(&processes_ready_queue);
-
-    /* If there is no running process and the running process isn't the idle one, we would want to continue on this 
-       process */
-    if (p == NULL && current_process->type != PROCESS_IDLE) {
-        return current_process;
-    } else if (p == NULL) {
-        return idle_process;
-    }
-
-    return p;
-}
-
-void scheduler_schedule() {
-    /* first of all remove all zombie process
-       so next process wouldn't be a zombie status kind */
-    if (!scheduler_on) return;
-
-    scheduler_remove_zombie_processes();
-
-    /* Fix: There is a need to check what will happen if current process = next process */
-    process_t * next_process = scheduler_get_next_process();
-
-    /* there is no need to shedule if the next process is the same */
-    if (current_process == next_process) return;
-    
-    process_t * current_process_copy = current_process;
-
-    current_process->status = PROCESS_READY;
-
-    if (current_process_copy->type != PROCESS_IDLE)
-        add_to_process_queue(&processes_ready_queue, current_process); /* add the process to the end of the queue */
-    
-    next_process->status = PROCESS_RUNNING;
-    current_process = next_process;
-    
-    scheduler_context_switch_asm(&current_process_copy->esp, next_process->esp);
-}
-
-void scheduler_thread_exit() {
-    if (current_process->type == PROCESS_IDLE) PANIC("The idle thread can't exit!!!");
-
-    process_t * next_process = scheduler_get_next_process();
-    /* if the next process equals to the current process then we need to set the current process to idle */
-    if (next_process == current_process) {
-        current_process = idle_process;
-        current_process->status = PROCESS_RUNNING;
-        goto thread_exit_switch;
-    }
-
-    process_t * current_process_copy = current_process;
-    
-    current_process->status = PROCESS_ZOMBIE;
-    /* Note: the current running process, shouldn't be linked in any of the queues */
-    add_to_process_queue(&processes_zombie_queue, current_process);
-    next_process->status = PROCESS_RUNNING;
-
-    current_process = next_process;
-
-thread_exit_switch:
-    scheduler_context_switch_asm(NULL, current_process->esp);
+#include "multitasking/scheduler.h"
+#include "multitasking/run_queue.h"
+#include "kernel/print.h"
+#include "kernel/panic.h"
+#include "kernel/timer.h"
+#include "mm/kheap.h"
+#include "mm/paging.h"
+#include "multitasking/lock.h"
+#include "utils/utils.h"
+
+/* define in process */
+uint8_t scheduler_on;
+static process_t * idle_process;
+static run_queue_t ready_queue;
+static process_list_t zombie_list;
+static process_t * current_process;
+
+static uint32_t quantum_ticks;     /* slice of a thread at its base priority */
+static uint32_t boost_ticks;       /* ticks between two priority boosts */
+static uint32_t boost_countdown;
+static volatile uint8_t need_resched;  /* switch on the way out of the current interrupt */
+
+/* load the address space of next, the kernel stacks live in the shared kernel half so this is safe before the stack switch */
+static void switch_address_space(process_t * next) {
+    if (next->page_directory != paging_get_current_directory())
+        switch_page_directory(next->page_directory);
+}
+
+static uint32_t scheduler_yield_handler(cpu_status_t * regs);
+
+/* the slice doubles for every level a thread sank below its base priority */
+static uint32_t slice_ticks_of(process_t * process) {
+    return quantum_ticks << (process->priority - process->base_priority);
+}
+
+/* Note: a system design is that current process can never be NULL
+   it may always have the idle process */
+void scheduler_init() {
+    void idle_process_main();
+
+    process_init();
+
+    idle_process = process_create(PROCESS_IDLE, idle_process_main, 0x1000); /* idle thread stack doesn't need to be very long */
+    current_process = idle_process;
+    run_queue_init(&ready_queue);
+    memset(&zombie_list, 0, sizeof(process_list_t));
+    scheduler_on = 0;
+
+    scheduler_set_quantum_ms(SCHEDULER_DEFAULT_QUANTUM_MS);
+    boost_ticks = SCHEDULER_BOOST_MS * timer_get_frequency() / 1000;
+    boost_countdown = boost_ticks;
+    need_resched = 0;
+
+    register_interrupt_handler(SCHEDULER_YIELD_VECTOR, scheduler_yield_handler);
+}
+
+void scheduler_set_on() {
+    scheduler_on = 1;
+}
+
+void scheduler_set_quantum_ms(uint32_t ms) {
+    quantum_ticks = ms * timer_get_frequency() / 1000;
+
+    if (quantum_ticks == 0)
+        quantum_ticks = 1;
+}
+
+uint32_t scheduler_get_quantum_ms() {
+    return quantum_ticks * 1000 / timer_get_frequency();
+}
+
+void scheduler_add_process_to_ready_queue(process_t * process) {
+    /* the timer tick and the switch on interrupt return use the queue too */
+    uint32_t eflags = irq_save();
+
+    process->status = PROCESS_READY;
+    run_queue_push(&ready_queue, process);
+
+    irq_restore(eflags);
+}
+
+void scheduler_set_priority(process_t * process, uint8_t priority) {
+    if (priority >= PROCESS_PRIORITIES) priority = PROCESS_PRIORITIES - 1;
+
+    uint32_t eflags = irq_save();
+
+    /* a queued process has to move to the list of its new priority */
+    uint8_t queued = process->status == PROCESS_READY && process != current_process;
+    if (queued)
+        run_queue_remove(&ready_queue, process);
+
+    process->base_priority = priority;
+    process->priority = priority;
+
+    if (queued)
+        run_queue_push(&ready_queue, process);
+
+    irq_restore(eflags);
+}
+
+void scheduler_reap_zombies() {
+    uint32_t eflags = irq_save();
+    process_t * p = process_list_pop(&zombie_list);
+    irq_restore(eflags);
+
+    /* interrupts are on again, process_destroy frees through vmalloc and the slab */
+    while (p != NULL) {
+        process_destroy(p);
+
+        eflags = irq_save();
+        p = process_list_pop(&zombie_list);
+        irq_restore(eflags);
+    }
+}
+
+/* put every ready thread (and the running one) back on its base priority, so a demoted thread can not starve */
+static void scheduler_boost_all() {
+    for (uint32_t priority = 0; priority < PROCESS_PRIORITIES; priority++) {
+        process_t * p = ready_queue.lists[priority].head;
+
+        while (p != NULL) {
+            process_t * next = p->next;
+
+            /* the base list is always before the current one, a moved thread is not seen again */
+            if (p->priority != p->base_priority) {
+                run_queue_remove(&ready_queue, p);
+                p->priority = p->base_priority;
+                run_queue_push(&ready_queue, p);
+            }
+
+            /* what is left of a long slice of a lower level is cut to a base slice */
+            if (p->slice_ticks > quantum_ticks)
+                p->slice_ticks = quantum_ticks;
+
+            p = next;
+        }
+    }
+
+    current_process->priority = current_process->base_priority;
+    if (current_process->slice_ticks > quantum_ticks)
+        current_process->slice_ticks = quantum_ticks;
+}
+
+process_t * scheduler_get_next_process() {
+    /* Important: may return the same process */
+    process_t * p = run_queue_pop(&ready_queue);
+
+    /* If there is no running process and the running process isn't the idle one, we would want to continue on this 
+       process */
+    if (p == NULL && current_process->type != PROCESS_IDLE) {
+        return current_process;
+    } else if (p == NULL) {
+        return idle_process;
+    }
+
+    return p;
+}
+
+process_t * scheduler_get_current_process() {
+    return current_process;
+}
+
+/* ask for a switch and take it right away through the yield interrupt, its frame is saved like any other */
+static void reschedule() {
+    uint32_t eflags = irq_save();
+
+    need_resched = 1;
+    __asm__ __volatile__("int %0" :: "i"(SCHEDULER_YIELD_VECTOR) : "memory");
+
+    irq_restore(eflags);
+}
+
+static uint32_t scheduler_yield_handler(cpu_status_t * regs) {
+    return 0;  /* need_resched is already set, the switch happens on the way out */
+}
+
+void scheduler_schedule() {
+    if (!scheduler_on) return;
+
+    reschedule();
+}
+
+cpu_status_t * scheduler_interrupt_return(cpu_status_t * frame) {
+    if (!need_resched) return frame;
+    need_resched = 0;
+
+    process_t * previous = current_process;
+    process_t * next;
+
+    if (previous->status == PROCESS_RUNNING) {
+        /* a running process keeps the cpu until a process of at least its priority is ready */
+        if (previous->type != PROCESS_IDLE && run_queue_best_priority(&ready_queue) > previous->priority)
+            next = previous;
+        else
+            next = scheduler_get_next_process();
+
+        if (next != previous) {
+            previous->status = PROCESS_READY;
+
+            if (previous->type != PROCESS_IDLE)
+                run_queue_push(&ready_queue, previous); /* add the process to the end of its priority queue */
+        }
+    } else {
+        /* blocked, asleep or exited, it is in no queue of ours */
+        next = run_queue_pop(&ready_queue);
+        if (next == NULL)
+            next = idle_process;
+
+        /* its stack is the one in use right now, it is destroyed later from thread context (scheduler_reap_zombies) */
+        if (previous->status == PROCESS_ZOMBIE)
+            process_list_push(&zombie_list, previous);
+    }
+
+    if (next->slice_ticks == 0)
+        next->slice_ticks = slice_ticks_of(next);
+    next->status = PROCESS_RUNNING;
+
+    if (next == previous) return frame;
+
+    previous->esp = (uint32_t *)frame;
+    current_process = next;
+    switch_address_space(next);
+
+    return (cpu_status_t *)next->esp;
+}
+
+void scheduler_tick() {
+    if (!scheduler_on) return;
+
+    if (--boost_countdown == 0) {
+        boost_countdown = boost_ticks;
+        scheduler_boost_all();
+    }
+
+    process_t * process = current_process;
+
+    if (process->type != PROCESS_IDLE && process->slice_ticks > 0 && --process->slice_ticks == 0) {
+        /* used its whole slice, it is cpu bound: one level down (with a longer slice), up to SCHEDULER_MLFQ_LEVELS */
+        if (process->priority < PROCESS_PRIORITIES - 1 &&
+            process->priority - process->base_priority < SCHEDULER_MLFQ_LEVELS - 1)
+            process->priority++;
+
+        need_resched = 1;
+        return;
+    }
+
+    /* a better thread became ready (woken up, boosted), it does not wait for the slice to end */
+    if (process->type == PROCESS_IDLE ? ready_queue.count > 0 : run_queue_best_priority(&ready_queue) < process->priority)
+        need_resched = 1;
+}
+
+/* take the current thread off the cpu until someone queues it again */
+static void park_current(process_state_e status) {
+    uint32_t eflags = irq_save();
+
+    if (current_process->type == PROCESS_IDLE) PANIC("The idle thread can't block");
+
+    /* it gave the cpu up before its slice ran out, one level back up towards its base priority */
+    if (current_process->priority > current_process->base_priority)
+        current_process->priority--;
+    current_process->slice_ticks = 0;
+    current_process->status = status;
+
+    reschedule();
+
+    irq_restore(eflags);
+}
+
+void scheduler_block() {
+    park_current(PROCESS_BLOCKED);
+}
+
+void scheduler_sleep() {
+    park_current(PROCESS_SLEEPING);
+}
+
+void scheduler_wake(process_t * process) {
+    uint32_t eflags = irq_save();
+
+    if (process->status == PROCESS_BLOCKED)
+        scheduler_add_process_to_ready_queue(process);
+
+    irq_restore(eflags);
+}
+
+/* the entry function of every thread returns here (process_create puts it under the first frame) */
+void scheduler_thread_exit() {
+    if (current_process->type == PROCESS_IDLE) PANIC("The idle thread can't exit!!!");
+
+    irq_save();
+    current_process->status = PROCESS_ZOMBIE;  /* destroyed by a later switch, once its stack is not in use */
+
+    reschedule();
+
+    PANIC("A zombie thread was scheduled");
 }
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "multitasking/sleep.h"
+#include "multitasking/lock.h"
+#include "multitasking/run_queue.h"
+#include "multitasking/scheduler.h"
+#include "kernel/timer.h"
+#include "utils/utils.h"
+
+#define ROOT_SIZE   (1 << SLEEP_WHEEL_ROOT_BITS)
+#define ROOT_MASK   (ROOT_SIZE - 1)
+#define LEVEL_SIZE  (1 << SLEEP_WHEEL_LEVEL_BITS)
+#define LEVEL_MASK  (LEVEL_SIZE - 1)
+#define LEVEL_SHIFT(level) (SLEEP_WHEEL_ROOT_BITS + (level) * SLEEP_WHEEL_LEVEL_BITS)
+
+static process_list_t root[ROOT_SIZE];
+static process_list_t levels[SLEEP_WHEEL_LEVELS][LEVEL_SIZE];
+static uint32_t wheel_tick;  /* the next tick the wheel handles */
+static uint32_t sleepers;
+
+/* the slot of a sleeper is picked by how far away its tick is, the farther the coarser */
+static void wheel_insert(process_t * process) {
+    uint32_t delta = process->wake_tick - wheel_tick;
+    process_list_t * slot;
+
+    if ((int32_t)delta < 0) {
+        slot = &root[wheel_tick & ROOT_MASK];  /* already due, handled by the tick being processed */
+    } else if (delta < ROOT_SIZE) {
+        slot = &root[process->wake_tick & ROOT_MASK];
+    } else {
+        uint32_t level = 0;
+
+        while (level < SLEEP_WHEEL_LEVELS - 1 && delta >= (1u << LEVEL_SHIFT(level + 1)))
+            level++;
+
+        slot = &levels[level][(process->wake_tick >> LEVEL_SHIFT(level)) & LEVEL_MASK];
+    }
+
+    process_list_push(slot, process);
+}
+
+/* spread the current slot of level over the levels below, returns the slot index (0 - the level wrapped too) */
+static uint32_t cascade(uint32_t level) {
+    uint32_t index = (wheel_tick >> LEVEL_SHIFT(level)) & LEVEL_MASK;
+    process_t * process;
+
+    while ((process = process_list_pop(&levels[level][index])) != NULL)
+        wheel_insert(process);
+
+    return index;
+}
+
+static uint32_t ms_to_ticks(uint32_t ms) {
+    uint32_t hz = timer_get_frequency();
+
+    return (ms / 1000) * hz + ((ms % 1000) * hz + 999) / 1000;
+}
+
+void sleep_queue_init() {
+    memset(root, 0, sizeof(root));
+    memset(levels, 0, sizeof(levels));
+    wheel_tick = 0;
+    sleepers = 0;
+}
+
+void sleep_queue_tick() {
+    uint32_t index = wheel_tick & ROOT_MASK;
+
+    /* the root level wrapped, bring the next slot of the levels above down */
+    if (index == 0)
+        for (uint32_t level = 0; level < SLEEP_WHEEL_LEVELS && cascade(level) == 0; level++);
+
+    process_t * process;
+    while ((process = process_list_pop(&root[index])) != NULL) {
+        sleepers--;
+        scheduler_add_process_to_ready_queue(process);
+    }
+
+    wheel_tick++;
+}
+
+uint32_t sleep_queue_count() {
+    return sleepers;
+}
+
+void ksleep_ms(uint32_t ms) {
+    ksleep_until(timer_time_ms() + ms);
+}
+
+void ksleep_until(uint32_t deadline_ms) {
+    process_t * self = scheduler_get_current_process();
+
+    /* the idle thread (kernel_main) can not block */
+    if (self == NULL || self->type == PROCESS_IDLE) {
+        while ((int32_t)(deadline_ms - timer_time_ms()) > 0)
+            __asm__ __volatile__("hlt");
+        return;
+    }
+
+    uint32_t eflags = irq_save();
+
+    int32_t remaining = deadline_ms - timer_time_ms();
+    if (remaining > 0) {
+        /* wheel_tick is only handled on the next tick, so a sleep can end late by a tick but never early */
+        self->wake_tick = wheel_tick + ms_to_ticks(remaining);
+        wheel_insert(self);
+        sleepers++;
+
+        scheduler_sleep();
+    }
+
+    irq_restore(eflags);
+}
\ No newline at end of file
@@ -0,0 +1,233 @@
+#include "multitasking/sync.h"
+#include "multitasking/lock.h"
+#include "multitasking/scheduler.h"
+#include "kernel/panic.h"
+#include "utils/utils.h"
+
+/* a thread may block only if it is a real thread and interrupts were on, the timer has to be able to run the others */
+static uint8_t can_block(process_t * self, uint32_t eflags) {
+    return self != NULL && self->type != PROCESS_IDLE && (eflags & EFLAGS_IF);
+}
+
+static void take(mutex_t * mutex) {
+    mutex->locked = 1;
+    mutex->owner = scheduler_get_current_process();
+}
+
+/*
+ * Spin with interrupts on until the mutex is free, at most iterations pauses
+ * (0 - forever). Only an owner that is running right now can release the
+ * lock during the spin, a bounded spin gives up on any other owner at once.
+ * With a single cpu the owner is never running while we spin (it was
+ * preempted, blocked or asleep), so the adaptive mode only pays off on SMP.
+ * 1 - taken.
+ */
+static uint8_t spin_lock(mutex_t * mutex, uint32_t iterations) {
+    for (uint32_t i = 0; iterations == 0 || i < iterations; i++) {
+        if (!mutex->locked && mutex_trylock(mutex))
+            return 1;
+
+        process_t * owner = mutex->owner;
+        if (iterations != 0 && owner != NULL && owner->status != PROCESS_RUNNING)
+            return 0;
+
+        __asm__ __volatile__("pause");
+    }
+
+    return 0;
+}
+
+void wait_queue_init(wait_queue_t * queue) {
+    memset(&queue->waiters, 0, sizeof(process_list_t));
+}
+
+void wait_queue_wait(wait_queue_t * queue) {
+    process_list_push(&queue->waiters, scheduler_get_current_process());
+    scheduler_block();
+}
+
+process_t * wait_queue_wake_one(wait_queue_t * queue) {
+    uint32_t eflags = irq_save();
+
+    process_t * process = process_list_pop(&queue->waiters);
+    if (process != NULL)
+        scheduler_wake(process);
+
+    irq_restore(eflags);
+    return process;
+}
+
+uint32_t wait_queue_wake_all(wait_queue_t * queue) {
+    uint32_t woken = 0;
+
+    while (wait_queue_wake_one(queue) != NULL)
+        woken++;
+
+    return woken;
+}
+
+void mutex_init(mutex_t * mutex) {
+    memset(mutex, 0, sizeof(mutex_t));
+    mutex->mode = MUTEX_SLEEP;
+    mutex->spin_budget = MUTEX_SPIN_MIN;
+}
+
+void mutex_set_mode(mutex_t * mutex, mutex_mode_e mode) {
+    mutex->mode = mode;
+    mutex->spin_budget = MUTEX_SPIN_MIN;
+}
+
+void mutex_lock(mutex_t * mutex) {
+    uint32_t eflags = irq_save();
+    process_t * self = scheduler_get_current_process();
+
+    if (!mutex->locked) {
+        take(mutex);
+        irq_restore(eflags);
+        return;
+    }
+
+    mutex->contentions++;
+
+    if (!(eflags & EFLAGS_IF)) PANIC("Waiting for a mutex with interrupts off");
+    if (mutex->owner == self && self != NULL) PANIC("Mutex locked twice by the same thread");
+
+    irq_restore(eflags);
+
+    if (!can_block(self, eflags) || mutex->mode == MUTEX_SPIN) {
+        spin_lock(mutex, 0);
+        return;
+    }
+
+    if (mutex->mode == MUTEX_ADAPTIVE) {
+        if (spin_lock(mutex, mutex->spin_budget)) {
+            if (mutex->spin_budget < MUTEX_SPIN_MAX)
+                mutex->spin_budget *= 2;
+            return;
+        }
+
+        if (mutex->spin_budget > MUTEX_SPIN_MIN)
+            mutex->spin_budget /= 2;
+    }
+
+    eflags = irq_save();
+
+    if (!mutex->locked) {
+        take(mutex);
+    } else {
+        mutex->sleeps++;
+        wait_queue_wait(&mutex->waiters);  /* mutex_unlock made us the owner before waking us */
+    }
+
+    irq_restore(eflags);
+}
+
+uint8_t mutex_trylock(mutex_t * mutex) {
+    uint32_t eflags = irq_save();
+    uint8_t taken = !mutex->locked;
+
+    if (taken)
+        take(mutex);
+
+    irq_restore(eflags);
+    return taken;
+}
+
+void mutex_unlock(mutex_t * mutex) {
+    uint32_t eflags = irq_save();
+
+    if (!mutex->locked) PANIC("Unlocking a free mutex");
+
+    /* the lock stays taken and goes straight to the oldest sleeper */
+    process_t * next = wait_queue_wake_one(&mutex->waiters);
+    if (next != NULL) {
+        mutex->owner = next;
+    } else {
+        mutex->owner = NULL;
+        mutex->locked = 0;
+    }
+
+    irq_restore(eflags);
+}
+
+void semaphore_init(semaphore_t * semaphore, int32_t count) {
+    semaphore->count = count;
+    wait_queue_init(&semaphore->waiters);
+}
+
+void semaphore_down(semaphore_t * semaphore) {
+    uint32_t eflags = irq_save();
+
+    if (semaphore->count > 0) {
+        semaphore->count--;
+        irq_restore(eflags);
+        return;
+    }
+
+    if (!(eflags & EFLAGS_IF)) PANIC("Waiting for a semaphore with interrupts off");
+
+    if (!can_block(scheduler_get_current_process(), eflags)) {
+        irq_restore(eflags);
+        while (!semaphore_try_down(semaphore))
+            __asm__ __volatile__("pause");
+        return;
+    }
+
+    wait_queue_wait(&semaphore->waiters);  /* semaphore_up handed its unit to us */
+
+    irq_restore(eflags);
+}
+
+uint8_t semaphore_try_down(semaphore_t * semaphore) {
+    uint32_t eflags = irq_save();
+    uint8_t taken = semaphore->count > 0;
+
+    if (taken)
+        semaphore->count--;
+
+    irq_restore(eflags);
+    return taken;
+}
+
+void semaphore_up(semaphore_t * semaphore) {
+    uint32_t eflags = irq_save();
+
+    if (wait_queue_wake_one(&semaphore->waiters) == NULL)
+        semaphore->count++;
+
+    irq_restore(eflags);
+}
+
+void condvar_init(condvar_t * condvar) {
+    wait_queue_init(&condvar->waiters);
+}
+
+void condvar_wait(condvar_t * condvar, mutex_t * mutex) {
+    uint32_t eflags = irq_save();
+
+    if (!(eflags & EFLAGS_IF)) PANIC("Waiting on a condvar with interrupts off");
+
+    /* the idle thread can not block, it releases the mutex for a tick and lets the caller check again */
+    if (!can_block(scheduler_get_current_process(), eflags)) {
+        mutex_unlock(mutex);
+        irq_restore(eflags);
+        __asm__ __volatile__("hlt");
+        mutex_lock(mutex);
+        return;
+    }
+
+    /* interrupts stay off until we are in the queue, a signal in between can not be lost */
+    mutex_unlock(mutex);
+    wait_queue_wait(&condvar->waiters);
+
+    irq_restore(eflags);
+    mutex_lock(mutex);
+}
+
+void condvar_signal(condvar_t * condvar) {
+    wait_queue_wake_one(&condvar->waiters);
+}
+
+void condvar_broadcast(condvar_t * condvar) {
+    wait_queue_wake_all(&condvar->waiters);
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "tests/test_log.h"
+#include "mm/buddy.h"
+#include "mm/kheap.h"
+#include "mm/pmm.h"
+#include "utils/bitmap_util.h"
+#include "utils/utils.h"
+
+#define STRESS_SLOTS     64
+#define STRESS_OPS       8192
+#define STRESS_MAX_ORDER 6
+
+static uint32_t stress_seed;
+
+static uint32_t stress_rand(void)
+{
+    stress_seed = stress_seed * 1103515245 + 12345;
+    return stress_seed >> 16;
+}
+
+/* mark the frames of a block in the ownership bitmap, 0 if one of them was already owned */
+static int stress_claim(uint8_t *owned, void *paddr, uint32_t order)
+{
+    uint32_t first = (uint32_t)paddr / FRAME_SIZE;
+
+    for (uint32_t i = 0; i < (1u << order); i++) {
+        if (bitmap_get(owned, first + i))
+            return 0;
+        bitmap_set(owned, first + i);
+    }
+
+    return 1;
+}
+
+static void stress_release(uint8_t *owned, void *paddr, uint32_t order)
+{
+    uint32_t first = (uint32_t)paddr / FRAME_SIZE;
+
+    for (uint32_t i = 0; i < (1u << order); i++)
+        bitmap_clear(owned, first + i);
+}
+
+void buddy_test_stress(void)
+{
+    void *blocks[STRESS_SLOTS];
+    uint32_t orders[STRESS_SLOTS];
+    buddy_stats_t before, after;
+
+    TEST_LOG_TEST("Buddy stress test start\n");
+
+    buddy_get_stats(&before);
+    if (before.total_frames == 0) {
+        TEST_LOG_WARN("Buddy pool is empty, skipping\n");
+        return;
+    }
+    TEST_LOG_INFO("%u of %u frames free, largest free order %d\n", before.free_frames, before.total_frames, before.largest_free_order);
+
+    /* one bit per physical frame, set while a live block covers it */
+    uint8_t *owned = (uint8_t *)kalloc(PMM_FRAMES_COUNT / 8);
+    if (!owned) {
+        TEST_LOG_ERR("kalloc of the ownership bitmap failed\n");
+        return;
+    }
+    memset(owned, 0, PMM_FRAMES_COUNT / 8);
+    memset(blocks, 0, sizeof(blocks));
+
+    TEST_LOG_STEP("Running %u random alloc/free operations of orders 0-%u\n", STRESS_OPS, STRESS_MAX_ORDER);
+    stress_seed = 0xB0DD1;
+    uint32_t failed_allocs = 0;
+    uint32_t worst_unusable = 0;
+    uint8_t broken = 0;
+
+    for (uint32_t op = 0; op < STRESS_OPS; op++) {
+        uint32_t slot = stress_rand() % STRESS_SLOTS;
+
+        if (blocks[slot]) {
+            stress_release(owned, blocks[slot], orders[slot]);
+            buddy_free(blocks[slot], orders[slot]);
+            blocks[slot] = NULL;
+            continue;
+        }
+
+        uint32_t order = stress_rand() % (STRESS_MAX_ORDER + 1);
+        void *block = buddy_alloc(order);
+        if (!block) {
+            failed_allocs++;
+            continue;
+        }
+
+        if ((uint32_t)block % (FRAME_SIZE << order) != 0) {
+            TEST_LOG_ERR("Block %p of order %u is not aligned to its size\n", block, order);
+            buddy_free(block, order);
+            broken = 1;
+            goto cleanup;
+        }
+
+        if (!stress_claim(owned, block, order)) {
+            TEST_LOG_ERR("Block %p of order %u overlaps a live block\n", block, order);
+            buddy_free(block, order);
+            broken = 1;
+            goto cleanup;
+        }
+
+        blocks[slot] = block;
+        orders[slot] = order;
+
+        uint32_t unusable = buddy_unusable_index(STRESS_MAX_ORDER);
+        if (unusable > worst_unusable)
+            worst_unusable = unusable;
+    }
+    TEST_LOG_OK("No overlapping or misaligned blocks, %u allocations failed\n", failed_allocs);
+    TEST_LOG_INFO("Worst unusable index for order %u: %u%%\n", STRESS_MAX_ORDER, worst_unusable);
+
+cleanup:
+    for (uint32_t i = 0; i < STRESS_SLOTS; i++)
+        if (blocks[i])
+            buddy_free(blocks[i], orders[i]);
+    kfree(owned);
+
+    TEST_LOG_STEP("Checking every block merged back\n");
+    buddy_get_stats(&after);
+    if (after.free_frames != before.free_frames || after.largest_free_order != before.largest_free_order ||
+        after.free_blocks[BUDDY_MAX_ORDER] != before.free_blocks[BUDDY_MAX_ORDER]) {
+        TEST_LOG_ERR("Pool did not recover: %u free frames, largest order %d\n", after.free_frames, after.largest_free_order);
+        return;
+    }
+    TEST_LOG_OK("Pool recovered: %u free frames, %u free blocks of order %u\n",
+                after.free_frames, after.free_blocks[BUDDY_MAX_ORDER], BUDDY_MAX_ORDER);
+
+    if (broken)
+        return;
+
+    TEST_LOG_TEST("PASS - Buddy stress test finished\n");
+}
\ No newline at end of file
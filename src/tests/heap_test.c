@@ -1,135 +1,605 @@
-#include "tests/test_log.h"
-#include "mm/kheap.h"
-#include "utils/utils.h"
-
-static int heap_check_pattern(uint8_t *buf, size_t size, uint8_t value)
-{
-    for (size_t i = 0; i < size; i++) {
-        if (buf[i] != value) {
-            TEST_LOG_ERR("Pattern mismatch at byte %u expected=0x%x got=0x%x\n",
-                         i, value, buf[i]);
-            return 0;
-        }
-    }
-
-    return 1;
-}
-
-void heap_test_basic(void)
-{
-    TEST_LOG_TEST("Heap basic test start\n");
-
-    TEST_LOG_STEP("Allocating 64 bytes\n");
-    uint8_t *a = (uint8_t *)kalloc(64);
-    if (!a) {
-        TEST_LOG_ERR("kalloc(64) returned NULL\n");
-        return;
-    }
-    TEST_LOG_OK("Allocated block A=%x\n", a);
-
-    TEST_LOG_STEP("Allocating 128 bytes\n");
-    uint8_t *b = (uint8_t *)kalloc(128);
-    if (!b) {
-        TEST_LOG_ERR("kalloc(128) returned NULL\n");
-        kfree(a);
-        return;
-    }
-    TEST_LOG_OK("Allocated block B=%x\n", b);
-
-    TEST_LOG_STEP("Allocating 256 bytes\n");
-    uint8_t *c = (uint8_t *)kalloc(256);
-    if (!c) {
-        TEST_LOG_ERR("kalloc(256) returned NULL\n");
-        kfree(b);
-        kfree(a);
-        return;
-    }
-    TEST_LOG_OK("Allocated block C=%x\n", c);
-
-    TEST_LOG_STEP("Writing patterns\n");
-    memset(a, 0xAA, 64);
-    memset(b, 0xBB, 128);
-    memset(c, 0xCC, 256);
-
-    TEST_LOG_STEP("Verifying patterns\n");
-    if (!heap_check_pattern(a, 64, 0xAA)) return;
-    if (!heap_check_pattern(b, 128, 0xBB)) return;
-    if (!heap_check_pattern(c, 256, 0xCC)) return;
-    TEST_LOG_OK("Patterns verified\n");
-
-    TEST_LOG_STEP("Freeing middle block B\n");
-    kfree(b);
-    TEST_LOG_OK("Freed block B\n");
-
-    TEST_LOG_STEP("Allocating 100 bytes, should reuse/split freed space if supported\n");
-    uint8_t *d = (uint8_t *)kalloc(100);
-    if (!d) {
-        TEST_LOG_ERR("kalloc(100) returned NULL\n");
-        kfree(c);
-        kfree(a);
-        return;
-    }
-    TEST_LOG_OK("Allocated block D=%x\n", d);
-
-    TEST_LOG_STEP("Writing and verifying block D\n");
-    memset(d, 0xDD, 100);
-    if (!heap_check_pattern(d, 100, 0xDD)) return;
-    TEST_LOG_OK("Block D verified\n");
-
-    TEST_LOG_STEP("Ensuring old blocks A and C were not corrupted\n");
-    if (!heap_check_pattern(a, 64, 0xAA)) return;
-    if (!heap_check_pattern(c, 256, 0xCC)) return;
-    TEST_LOG_OK("A and C still valid\n");
-
-    TEST_LOG_STEP("Freeing all blocks\n");
-    kfree(d);
-    kfree(c);
-    kfree(a);
-    TEST_LOG_OK("All blocks freed\n");
-
-    TEST_LOG_TEST("PASS - Heap basic test succeeded\n");
-}
-
-void heap_test_many_small_allocs(void)
-{
-    enum { COUNT = 64, SIZE = 32 };
-
-    uint8_t *ptrs[COUNT];
-
-    TEST_LOG_TEST("Heap many-small-allocs test start\n");
-
-    memset(ptrs, 0, sizeof(ptrs));
-
-    TEST_LOG_STEP("Allocating %u blocks of %u bytes\n", COUNT, SIZE);
-
-    for (uint32_t i = 0; i < COUNT; i++) {
-        ptrs[i] = (uint8_t *)kalloc(SIZE);
-        if (!ptrs[i]) {
-            TEST_LOG_ERR("kalloc failed at index=%u\n", i);
-            return;
-        }
-
-        memset(ptrs[i], (uint8_t)i, SIZE);
-    }
-
-    TEST_LOG_OK("All small blocks allocated\n");
-
-    TEST_LOG_STEP("Verifying all small blocks\n");
-
-    for (uint32_t i = 0; i < COUNT; i++) {
-        if (!heap_check_pattern(ptrs[i], SIZE, (uint8_t)i))
-            return;
-    }
-
-    TEST_LOG_OK("All small blocks verified\n");
-
-    TEST_LOG_STEP("Freeing all small blocks\n");
-
-    for (uint32_t i = 0; i < COUNT; i++) {
-        kfree(ptrs[i]);
-    }
-
-    TEST_LOG_OK("All small blocks freed\n");
-
-    TEST_LOG_TEST("PASS - Heap many-small-allocs test succeeded\n");
+#include "tests/test_log.h"
+#include "kernel/timer.h"
+#include "mm/kheap.h"
+#include "mm/paging.h"
+#include "multitasking/lock.h"
+#include "multitasking/process.h"
+#include "multitasking/scheduler.h"
+#include "utils/utils.h"
+
+static int heap_check_pattern(uint8_t *buf, size_t size, uint8_t value)
+{
+    for (size_t i = 0; i < size; i++) {
+        if (buf[i] != value) {
+            TEST_LOG_ERR("Pattern mismatch at byte %u expected=0x%x got=0x%x\n",
+                         i, value, buf[i]);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+void heap_test_basic(void)
+{
+    TEST_LOG_TEST("Heap basic test start\n");
+
+    TEST_LOG_STEP("Allocating 64 bytes\n");
+    uint8_t *a = (uint8_t *)kalloc(64);
+    if (!a) {
+        TEST_LOG_ERR("kalloc(64) returned NULL\n");
+        return;
+    }
+    TEST_LOG_OK("Allocated block A=%x\n", a);
+
+    TEST_LOG_STEP("Allocating 128 bytes\n");
+    uint8_t *b = (uint8_t *)kalloc(128);
+    if (!b) {
+        TEST_LOG_ERR("kalloc(128) returned NULL\n");
+        kfree(a);
+        return;
+    }
+    TEST_LOG_OK("Allocated block B=%x\n", b);
+
+    TEST_LOG_STEP("Allocating 256 bytes\n");
+    uint8_t *c = (uint8_t *)kalloc(256);
+    if (!c) {
+        TEST_LOG_ERR("kalloc(256) returned NULL\n");
+        kfree(b);
+        kfree(a);
+        return;
+    }
+    TEST_LOG_OK("Allocated block C=%x\n", c);
+
+    TEST_LOG_STEP("Writing patterns\n");
+    memset(a, 0xAA, 64);
+    memset(b, 0xBB, 128);
+    memset(c, 0xCC, 256);
+
+    TEST_LOG_STEP("Verifying patterns\n");
+    if (!heap_check_pattern(a, 64, 0xAA)) return;
+    if (!heap_check_pattern(b, 128, 0xBB)) return;
+    if (!heap_check_pattern(c, 256, 0xCC)) return;
+    TEST_LOG_OK("Patterns verified\n");
+
+    TEST_LOG_STEP("Freeing middle block B\n");
+    kfree(b);
+    TEST_LOG_OK("Freed block B\n");
+
+    TEST_LOG_STEP("Allocating 100 bytes, should reuse/split freed space if supported\n");
+    uint8_t *d = (uint8_t *)kalloc(100);
+    if (!d) {
+        TEST_LOG_ERR("kalloc(100) returned NULL\n");
+        kfree(c);
+        kfree(a);
+        return;
+    }
+    TEST_LOG_OK("Allocated block D=%x\n", d);
+
+    TEST_LOG_STEP("Writing and verifying block D\n");
+    memset(d, 0xDD, 100);
+    if (!heap_check_pattern(d, 100, 0xDD)) return;
+    TEST_LOG_OK("Block D verified\n");
+
+    TEST_LOG_STEP("Ensuring old blocks A and C were not corrupted\n");
+    if (!heap_check_pattern(a, 64, 0xAA)) return;
+    if (!heap_check_pattern(c, 256, 0xCC)) return;
+    TEST_LOG_OK("A and C still valid\n");
+
+    TEST_LOG_STEP("Freeing all blocks\n");
+    kfree(d);
+    kfree(c);
+    kfree(a);
+    TEST_LOG_OK("All blocks freed\n");
+
+    TEST_LOG_TEST("PASS - Heap basic test succeeded\n");
+}
+
+void heap_test_many_small_allocs(void)
+{
+    enum { COUNT = 64, SIZE = 32 };
+
+    uint8_t *ptrs[COUNT];
+
+    TEST_LOG_TEST("Heap many-small-allocs test start\n");
+
+    memset(ptrs, 0, sizeof(ptrs));
+
+    TEST_LOG_STEP("Allocating %u blocks of %u bytes\n", COUNT, SIZE);
+
+    for (uint32_t i = 0; i < COUNT; i++) {
+        ptrs[i] = (uint8_t *)kalloc(SIZE);
+        if (!ptrs[i]) {
+            TEST_LOG_ERR("kalloc failed at index=%u\n", i);
+            return;
+        }
+
+        memset(ptrs[i], (uint8_t)i, SIZE);
+    }
+
+    TEST_LOG_OK("All small blocks allocated\n");
+
+    TEST_LOG_STEP("Verifying all small blocks\n");
+
+    for (uint32_t i = 0; i < COUNT; i++) {
+        if (!heap_check_pattern(ptrs[i], SIZE, (uint8_t)i))
+            return;
+    }
+
+    TEST_LOG_OK("All small blocks verified\n");
+
+    TEST_LOG_STEP("Freeing all small blocks\n");
+
+    for (uint32_t i = 0; i < COUNT; i++) {
+        kfree(ptrs[i]);
+    }
+
+    TEST_LOG_OK("All small blocks freed\n");
+
+    TEST_LOG_TEST("PASS - Heap many-small-allocs test succeeded\n");
+}
+
+/*
+ * Reference first-fit allocator, the kalloc/kfree that walked the whole chunk
+ * list from the first chunk on every allocation. It runs on a private arena and
+ * is only kept here so the churn benchmark has something to compare against.
+ */
+typedef struct ff_chunk_struct {
+    uint8_t is_used;
+    size_t size;
+    struct ff_chunk_struct * previous;
+    struct ff_chunk_struct * next;
+} ff_chunk_t;
+
+static ff_chunk_t * ff_first;
+
+static void ff_init(void *arena, size_t size)
+{
+    ff_first = (ff_chunk_t *)arena;
+    ff_first->is_used = 0;
+    ff_first->size = size - sizeof(ff_chunk_t);
+    ff_first->previous = NULL;
+    ff_first->next = NULL;
+}
+
+static void *ff_alloc(size_t size)
+{
+    for (ff_chunk_t *current = ff_first; current != NULL; current = current->next) {
+        if (current->is_used || current->size <= size + sizeof(ff_chunk_t))
+            continue;
+
+        ff_chunk_t *new_chunk = (ff_chunk_t *)((uint8_t *)current + current->size - size);
+
+        if (current->next != NULL)
+            current->next->previous = new_chunk;
+
+        new_chunk->next = current->next;
+        new_chunk->previous = current;
+        current->next = new_chunk;
+
+        new_chunk->is_used = 1;
+        new_chunk->size = size;
+        current->size -= size + sizeof(ff_chunk_t);
+
+        return (uint8_t *)new_chunk + sizeof(ff_chunk_t);
+    }
+
+    return NULL;
+}
+
+static void ff_free(void *user_pointer)
+{
+    ff_chunk_t *chunk = (ff_chunk_t *)((uint8_t *)user_pointer - sizeof(ff_chunk_t));
+    chunk->is_used = 0;
+
+    if (chunk->previous != NULL && !chunk->previous->is_used) {
+        chunk->previous->next = chunk->next;
+        if (chunk->next != NULL)
+            chunk->next->previous = chunk->previous;
+        chunk->previous->size += sizeof(ff_chunk_t) + chunk->size;
+        chunk = chunk->previous;
+    }
+
+    if (chunk->next != NULL && !chunk->next->is_used) {
+        ff_chunk_t *next = chunk->next;
+        chunk->next = next->next;
+        if (next->next != NULL)
+            next->next->previous = chunk;
+        chunk->size += sizeof(ff_chunk_t) + next->size;
+    }
+}
+
+typedef void *(*bench_alloc_fn)(size_t size);
+typedef void (*bench_free_fn)(void *ptr);
+
+/*
+ * Churn workload: keep BENCH_LIVE objects of 16..527 bytes alive and replace a
+ * pseudo random one on every operation, on top of BENCH_PINNED small objects that
+ * stay allocated (like the many-small-allocs test) and make the chunk list long.
+ * Returns the average cycles of one free + alloc pair.
+ */
+#define BENCH_PINNED 1024
+#define BENCH_LIVE   256
+#define BENCH_OPS    4096
+
+static uint32_t heap_bench_churn_run(bench_alloc_fn alloc_fn, bench_free_fn free_fn)
+{
+    static void *pinned[BENCH_PINNED];
+    static void *live[BENCH_LIVE];
+    uint32_t seed = 12345;
+
+    for (uint32_t i = 0; i < BENCH_PINNED; i++)
+        pinned[i] = alloc_fn(32);
+
+    for (uint32_t i = 0; i < BENCH_LIVE; i++) {
+        seed = seed * 1103515245 + 12345;
+        live[i] = alloc_fn(16 + ((seed >> 16) % 512));
+    }
+
+    uint32_t start = (uint32_t)timer_read_tsc();
+
+    for (uint32_t op = 0; op < BENCH_OPS; op++) {
+        seed = seed * 1103515245 + 12345;
+        uint32_t slot = (seed >> 16) % BENCH_LIVE;
+
+        free_fn(live[slot]);
+        seed = seed * 1103515245 + 12345;
+        live[slot] = alloc_fn(16 + ((seed >> 16) % 512));
+    }
+
+    uint32_t cycles = (uint32_t)timer_read_tsc() - start;
+
+    for (uint32_t i = 0; i < BENCH_LIVE; i++)
+        free_fn(live[i]);
+    for (uint32_t i = 0; i < BENCH_PINNED; i++)
+        free_fn(pinned[i]);
+
+    return cycles / BENCH_OPS;
+}
+
+void heap_test_bench_churn(void)
+{
+    enum { ARENA_SIZE = 0x100000 };
+
+    TEST_LOG_TEST("Heap churn benchmark start\n");
+
+    void *arena = kalloc(ARENA_SIZE);
+    if (!arena) {
+        TEST_LOG_ERR("kalloc of the first-fit arena failed\n");
+        return;
+    }
+
+    TEST_LOG_STEP("Running churn on the reference first-fit walker\n");
+    ff_init(arena, ARENA_SIZE);
+    uint32_t first_fit_cycles = heap_bench_churn_run(ff_alloc, ff_free);
+
+    TEST_LOG_STEP("Running churn on kalloc/kfree\n");
+    uint32_t kalloc_cycles = heap_bench_churn_run(kalloc, kfree);
+
+    kfree(arena);
+
+    TEST_LOG_INFO("first-fit: %u cycles/op, kalloc: %u cycles/op\n", first_fit_cycles, kalloc_cycles);
+    TEST_LOG_TEST("PASS - Heap churn benchmark finished\n");
+}
+
+void heap_test_expand_and_trim(void)
+{
+    enum { BIG_SIZE = 0x200000 };
+
+    TEST_LOG_TEST("Heap expand/trim test start\n");
+
+    size_t committed_before = kheap_committed_size();
+    TEST_LOG_INFO("Committed before: %u KiB\n", committed_before / 1024);
+
+    TEST_LOG_STEP("Allocating %u KiB, the heap has to grow\n", BIG_SIZE / 1024);
+    uint8_t *big = (uint8_t *)kalloc_heap(BIG_SIZE);
+    if (!big) {
+        TEST_LOG_ERR("kalloc_heap(%u) returned NULL\n", BIG_SIZE);
+        return;
+    }
+
+    size_t committed_grown = kheap_committed_size();
+    if (committed_grown < committed_before + BIG_SIZE) {
+        TEST_LOG_ERR("Heap did not grow enough: %u KiB committed\n", committed_grown / 1024);
+        kfree(big);
+        return;
+    }
+    TEST_LOG_OK("Heap grew to %u KiB\n", committed_grown / 1024);
+
+    TEST_LOG_STEP("Touching every byte of the new memory\n");
+    memset(big, 0x5A, BIG_SIZE);
+    if (!heap_check_pattern(big, BIG_SIZE, 0x5A)) {
+        kfree(big);
+        return;
+    }
+    TEST_LOG_OK("New memory is usable\n");
+
+    TEST_LOG_STEP("Freeing the block, the free tail should go back to the pmm\n");
+    kfree(big);
+
+    size_t committed_after = kheap_committed_size();
+    if (committed_after > committed_before) {
+        TEST_LOG_ERR("Heap was not trimmed: %u KiB committed\n", committed_after / 1024);
+        return;
+    }
+    TEST_LOG_OK("Heap trimmed back to %u KiB\n", committed_after / 1024);
+
+    TEST_LOG_TEST("PASS - Heap expand/trim test succeeded\n");
+}
+
+void heap_test_telemetry(void)
+{
+    enum { ALLOC_COUNT = 16, ALLOC_SIZE = 200 };
+    uint8_t *blocks[ALLOC_COUNT];
+    kheap_stats_t before, during, after;
+
+    TEST_LOG_TEST("Heap telemetry test start\n");
+
+    /* chunks parked in the thread's magazine are in no bin, start and end without any so the free counters compare too */
+    kheap_magazine_flush(kheap_current_magazine());
+    kheap_get_stats(&before);
+    kheap_set_callsite_tracking(1);
+
+    TEST_LOG_STEP("Allocating %u blocks of %u bytes from one callsite\n", ALLOC_COUNT, ALLOC_SIZE);
+    for (int i = 0; i < ALLOC_COUNT; i++) {
+        blocks[i] = (uint8_t *)kalloc(ALLOC_SIZE);
+        if (!blocks[i]) {
+            TEST_LOG_ERR("kalloc(%u) #%d returned NULL\n", ALLOC_SIZE, i);
+            for (int j = 0; j < i; j++)
+                kfree(blocks[j]);
+            kheap_set_callsite_tracking(0);
+            return;
+        }
+    }
+
+    kheap_get_stats(&during);
+    if (during.chunks_in_use != before.chunks_in_use + ALLOC_COUNT ||
+        during.bytes_in_use < before.bytes_in_use + ALLOC_COUNT * ALLOC_SIZE ||
+        during.peak_bytes_in_use < during.bytes_in_use) {
+        TEST_LOG_ERR("Counters off: %u chunks, 0x%x bytes in use, peak 0x%x\n",
+                     during.chunks_in_use, during.bytes_in_use, during.peak_bytes_in_use);
+    } else {
+        TEST_LOG_OK("%u chunks, 0x%x bytes in use, peak 0x%x\n",
+                    during.chunks_in_use, during.bytes_in_use, during.peak_bytes_in_use);
+    }
+
+    static kheap_callsite_t callsites[KHEAP_CALLSITES_MAX];
+    uint32_t callsite_count = kheap_get_callsites(callsites, KHEAP_CALLSITES_MAX);
+    uint32_t busiest = 0;
+    for (uint32_t i = 0; i < callsite_count; i++)
+        if (callsites[i].live_chunks > busiest)
+            busiest = callsites[i].live_chunks;
+
+    if (busiest < ALLOC_COUNT) {
+        TEST_LOG_ERR("No callsite holds the %u live chunks (best %u)\n", ALLOC_COUNT, busiest);
+    } else {
+        TEST_LOG_OK("%u callsites tracked, busiest holds %u chunks\n", callsite_count, busiest);
+    }
+
+    TEST_LOG_STEP("Freeing every other block to fragment the heap\n");
+    for (int i = 0; i < ALLOC_COUNT; i += 2) {
+        kfree(blocks[i]);
+        blocks[i] = NULL;
+    }
+
+    kheap_get_stats(&during);
+    if (during.free_chunks == 0 || during.largest_free > during.free_bytes || during.fragmentation > 100) {
+        TEST_LOG_ERR("Free counters inconsistent: %u free chunks, largest 0x%x of 0x%x\n",
+                     during.free_chunks, during.largest_free, during.free_bytes);
+    } else {
+        TEST_LOG_OK("%u free chunks, largest 0x%x of 0x%x, fragmentation %u%%\n",
+                    during.free_chunks, during.largest_free, during.free_bytes, during.fragmentation);
+    }
+
+    kheap_dump_stats();
+
+    for (int i = 1; i < ALLOC_COUNT; i += 2)
+        kfree(blocks[i]);
+
+    kheap_set_callsite_tracking(0);
+    kheap_magazine_flush(kheap_current_magazine());
+
+    kheap_get_stats(&after);
+    if (after.chunks_in_use != before.chunks_in_use || after.bytes_in_use != before.bytes_in_use) {
+        TEST_LOG_ERR("Counters did not return: %u chunks, 0x%x bytes in use\n", after.chunks_in_use, after.bytes_in_use);
+        return;
+    }
+    TEST_LOG_OK("Counters back to %u chunks, 0x%x bytes in use\n", after.chunks_in_use, after.bytes_in_use);
+
+    TEST_LOG_TEST("PASS - Heap telemetry test succeeded\n");
+}
+
+void heap_test_aligned(void)
+{
+    static const size_t aligns[] = { 16, 64, 256, PAGE_SIZE };
+    enum { ALIGN_COUNT = sizeof(aligns) / sizeof(aligns[0]), BLOCK_SIZE = 100 };
+    uint8_t *blocks[ALIGN_COUNT];
+    kheap_stats_t before, during, after;
+
+    TEST_LOG_TEST("Heap aligned allocation test start\n");
+
+    kheap_magazine_flush(kheap_current_magazine());
+    kheap_get_stats(&before);
+
+    for (int i = 0; i < ALIGN_COUNT; i++) {
+        TEST_LOG_STEP("kalloc_aligned(%u, 0x%x)\n", BLOCK_SIZE, aligns[i]);
+        blocks[i] = (uint8_t *)kalloc_aligned(BLOCK_SIZE, aligns[i]);
+
+        if (!blocks[i] || ((uint32_t)blocks[i] & (aligns[i] - 1))) {
+            TEST_LOG_ERR("Bad block %x for alignment 0x%x\n", blocks[i], aligns[i]);
+            for (int j = 0; j <= i; j++)
+                kfree(blocks[j]);
+            return;
+        }
+
+        memset(blocks[i], 0x30 + i, BLOCK_SIZE);
+    }
+    TEST_LOG_OK("Every block is aligned\n");
+
+    /* the unaligned head of each chunk went back to the bins, only the blocks themselves are in use */
+    kheap_get_stats(&during);
+    size_t overhead = during.bytes_in_use - before.bytes_in_use - ALIGN_COUNT * ((BLOCK_SIZE + HEAP_ALIGNMENT - 1) & ~(HEAP_ALIGNMENT - 1));
+    if (overhead >= ALIGN_COUNT * (HEAP_CHUNK_HEADER_SIZE + HEAP_MIN_CHUNK_SIZE)) {
+        TEST_LOG_ERR("Aligned blocks hold 0x%x bytes more than asked\n", overhead);
+    } else {
+        TEST_LOG_OK("Aligned blocks hold %u bytes more than asked\n", overhead);
+    }
+
+    for (int i = 0; i < ALIGN_COUNT; i++) {
+        if (!heap_check_pattern(blocks[i], BLOCK_SIZE, 0x30 + i)) {
+            TEST_LOG_ERR("Block %d was overwritten\n", i);
+            return;
+        }
+        kfree(blocks[i]);
+    }
+    kheap_magazine_flush(kheap_current_magazine());
+
+    TEST_LOG_STEP("kalloc_phys of a 512 byte descriptor ring\n");
+    uint32_t phys = 0;
+    uint8_t *ring = (uint8_t *)kalloc_phys(512, 16, &phys);
+    if (!ring) {
+        TEST_LOG_ERR("kalloc_phys returned NULL\n");
+        return;
+    }
+
+    uint32_t expected = (uint32_t)paging_get_mapping(ring + 511) | ((uint32_t)(ring + 511) & (PAGE_SIZE - 1));
+    if (phys + 511 != expected || (phys & 15)) {
+        TEST_LOG_ERR("Physical address %x does not match the mapping (%x at the end)\n", phys, expected);
+        kfree(ring);
+        return;
+    }
+    TEST_LOG_OK("Ring at %x is physically contiguous at %x\n", ring, phys);
+    kfree(ring);
+
+    kheap_get_stats(&after);
+    if (after.bytes_in_use != before.bytes_in_use) {
+        TEST_LOG_ERR("0x%x bytes leaked\n", after.bytes_in_use - before.bytes_in_use);
+        return;
+    }
+
+    TEST_LOG_TEST("PASS - Heap aligned allocation test succeeded\n");
+}
+/*
+ * Multithreaded stress: a few kernel threads allocate and free random small
+ * blocks, check their contents, and report their magazine hit rate.
+ */
+#define STRESS_THREADS 4
+#define STRESS_ROUNDS  4000
+#define STRESS_SLOTS   32
+
+static volatile uint32_t stress_done;
+static volatile uint32_t stress_errors;
+static volatile uint32_t stress_hits;
+static volatile uint32_t stress_misses;
+
+static void heap_stress_worker(void)
+{
+    uint8_t *slots[STRESS_SLOTS];
+    size_t sizes[STRESS_SLOTS];
+    uint32_t errors = 0;
+    uint32_t seed = (uint32_t)slots;  /* every thread has its own stack, so its own sequence */
+
+    memset(slots, 0, sizeof(slots));
+
+    for (uint32_t round = 0; round < STRESS_ROUNDS; round++) {
+        seed = seed * 1103515245 + 12345;
+        uint32_t i = (seed >> 16) % STRESS_SLOTS;
+        uint8_t tag = (uint8_t)(i * 7 + (uint32_t)slots);
+
+        if (slots[i] != NULL) {
+            for (size_t b = 0; b < sizes[i]; b++)
+                if (slots[i][b] != tag) {
+                    errors++;
+                    break;
+                }
+
+            kfree(slots[i]);
+            slots[i] = NULL;
+            continue;
+        }
+
+        sizes[i] = 8 + (seed >> 8) % 250;
+        slots[i] = (uint8_t *)kalloc(sizes[i]);
+        if (slots[i] == NULL) {
+            errors++;
+            continue;
+        }
+        memset(slots[i], tag, sizes[i]);
+    }
+
+    for (uint32_t i = 0; i < STRESS_SLOTS; i++)
+        kfree(slots[i]);
+
+    kheap_magazine_t *magazine = kheap_current_magazine();
+
+    uint32_t eflags = irq_save();
+    stress_errors += errors;
+    stress_hits += magazine->hits;
+    stress_misses += magazine->misses;
+    stress_done++;
+    irq_restore(eflags);
+}
+
+void heap_test_bench_threads(void)
+{
+    process_t *threads[STRESS_THREADS];
+    kheap_stats_t before, after;
+
+    TEST_LOG_TEST("Heap multithreaded stress benchmark start\n");
+
+    stress_done = 0;
+    stress_errors = 0;
+    stress_hits = 0;
+    stress_misses = 0;
+
+    kheap_magazine_flush(kheap_current_magazine());
+    kheap_get_stats(&before);
+
+    TEST_LOG_STEP("Creating %u threads, %u rounds each\n", STRESS_THREADS, STRESS_ROUNDS);
+    for (int i = 0; i < STRESS_THREADS; i++) {
+        threads[i] = process_create(PROCESS_KERNEL, heap_stress_worker, 0x4000);
+        if (!threads[i]) {
+            TEST_LOG_ERR("process_create #%d returned NULL\n", i);
+            for (int j = 0; j < i; j++)
+                process_destroy(threads[j]);
+            return;
+        }
+    }
+
+    uint64_t start = timer_read_tsc();
+
+    for (int i = 0; i < STRESS_THREADS; i++)
+        scheduler_add_process_to_ready_queue(threads[i]);
+    scheduler_set_on();
+
+    while (stress_done < STRESS_THREADS)
+        __asm__ __volatile__("hlt");
+
+    uint64_t cycles = timer_read_tsc() - start;
+
+    if (stress_errors != 0) {
+        TEST_LOG_ERR("%u corrupted or failed allocations\n", stress_errors);
+        return;
+    }
+    TEST_LOG_OK("All threads finished without corruption\n");
+
+    /* the dead threads' magazines go back to the heap once the scheduler reaps them */
+    uint32_t deadline = timer_time_ms() + 3000;
+    do {
+        kheap_get_stats(&after);
+        if (after.chunks_in_use == before.chunks_in_use)
+            break;
+        __asm__ __volatile__("hlt");
+    } while (timer_time_ms() < deadline);
+
+    if (after.chunks_in_use != before.chunks_in_use) {
+        TEST_LOG_ERR("%u chunks still in use after the threads died\n", after.chunks_in_use - before.chunks_in_use);
+        return;
+    }
+
+    uint32_t ops = STRESS_THREADS * STRESS_ROUNDS;
+    uint32_t small_allocs = stress_hits + stress_misses;
+    TEST_LOG_INFO("%u Kcycles for %u ops (includes waiting for the first time slice)\n", (uint32_t)(cycles >> 10), ops);
+    TEST_LOG_INFO("magazine hits: %u of %u small allocations\n", stress_hits, small_allocs);
+    TEST_LOG_TEST("PASS - Heap multithreaded stress benchmark finished\n");
 }
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include "tests/mmap_test.h"
+#include "tests/test_log.h"
+#include "kernel/syscall.h"
+#include "mm/kheap.h"
+#include "mm/page.h"
+#include "mm/paging.h"
+#include "mm/pmm.h"
+#include "mm/vm_region.h"
+#include "utils/utils.h"
+
+void mmap_test_demand_zero(void)
+{
+    enum { MAP_SIZE = 0x4000000, TOUCHED = 16 };  /* 64 MiB, only a few pages are ever written */
+
+    TEST_LOG_TEST("mmap demand-zero test start\n");
+
+    /* warm up, the first region may pull a slab page into the region cache */
+    munmap(mmap(NULL, PAGE_SIZE, PPROT_READ), PAGE_SIZE);
+
+    uint32_t free_before = pmm_get_free_frames_count();
+
+    TEST_LOG_STEP("Reserving %u MiB\n", MAP_SIZE / 0x100000);
+    uint8_t *map = (uint8_t *)mmap(NULL, MAP_SIZE, PPROT_READ | PPROT_WRITE);
+    if (!map) {
+        TEST_LOG_ERR("mmap returned NULL\n");
+        return;
+    }
+    if (pmm_get_free_frames_count() != free_before) {
+        TEST_LOG_ERR("mmap committed %u frames up front\n", free_before - pmm_get_free_frames_count());
+        munmap(map, MAP_SIZE);
+        return;
+    }
+    TEST_LOG_OK("Reserved at %p without committing frames\n", map);
+
+    TEST_LOG_STEP("Reading untouched pages\n");
+    for (uint32_t i = 0; i < TOUCHED; i++) {
+        if (map[i * (MAP_SIZE / TOUCHED)] != 0) {
+            TEST_LOG_ERR("Untouched page %u is not zero\n", i);
+            munmap(map, MAP_SIZE);
+            return;
+        }
+    }
+    if ((uint32_t)paging_get_mapping(map) != vm_region_zero_page()) {
+        TEST_LOG_ERR("Read did not map the shared zero page\n");
+        munmap(map, MAP_SIZE);
+        return;
+    }
+    TEST_LOG_OK("Reads see the shared zero page\n");
+
+    TEST_LOG_STEP("Writing %u scattered pages\n", TOUCHED);
+    for (uint32_t i = 0; i < TOUCHED; i++)
+        map[i * (MAP_SIZE / TOUCHED) + 7] = (uint8_t)(i + 1);
+
+    for (uint32_t i = 0; i < TOUCHED; i++) {
+        uint8_t *page = map + i * (MAP_SIZE / TOUCHED);
+        if (page[7] != (uint8_t)(i + 1) || page[0] != 0) {
+            TEST_LOG_ERR("Page %u has wrong contents\n", i);
+            munmap(map, MAP_SIZE);
+            return;
+        }
+    }
+    TEST_LOG_OK("Written pages keep their data, the rest stays zero\n");
+
+    TEST_LOG_STEP("Unmapping\n");
+    if (munmap(map, MAP_SIZE) != 0) {
+        TEST_LOG_ERR("munmap failed\n");
+        return;
+    }
+    if (pmm_get_free_frames_count() != free_before) {
+        TEST_LOG_ERR("%u frames leaked\n", free_before - pmm_get_free_frames_count());
+        return;
+    }
+    TEST_LOG_OK("All frames and page tables returned\n");
+
+    TEST_LOG_TEST("PASS - mmap demand-zero test succeeded\n");
+}
+
+void mmap_test_file_backed(ata_drive_t *drive)
+{
+    enum { FILE_SIZE = 5 * 0x1000 + 100, SECTORS_PER_BLOCK = 8 };  /* 6 pages, the last one mostly past the end of file */
+
+    flatfs_t fs;
+    flatfs_err_t err;
+    uint32_t inode_idx;
+    uint32_t bytes;
+
+    TEST_LOG_TEST("mmap file-backed test start\n");
+
+    memset(&fs, 0, sizeof(fs));
+
+    TEST_LOG_STEP("Preparing a %u byte file\n", FILE_SIZE);
+    uint8_t *data = kalloc(FILE_SIZE);
+    if (!data) {
+        TEST_LOG_ERR("No memory for the test buffer\n");
+        return;
+    }
+    for (uint32_t i = 0; i < FILE_SIZE; i++)
+        data[i] = (uint8_t)(i * 13 + 5);
+
+    if ((err = flatfs_format(drive, 16, SECTORS_PER_BLOCK)) != FLATFS_OK ||
+        (err = flatfs_mount(&fs, drive)) != FLATFS_OK ||
+        (err = flatfs_create(&fs, "map.bin", FLATFS_PERMISSION_R | FLATFS_PERMISSION_W, &inode_idx)) != FLATFS_OK ||
+        (err = flatfs_write(&fs, "map.bin", 0, data, FILE_SIZE, &bytes)) != FLATFS_OK) {
+        TEST_LOG_ERR("Setting up the file failed err=%d\n", err);
+        kfree(data);
+        return;
+    }
+    TEST_LOG_OK("File written\n");
+
+    /* warm up, the first mapping may pull heap and slab pages in */
+    uint8_t *warm = flatfs_mmap(&fs, "map.bin", NULL, PAGE_SIZE, 0, PPROT_READ);
+    if (warm)
+        munmap(warm, PAGE_SIZE);
+
+    uint32_t free_before = pmm_get_free_frames_count();
+
+    TEST_LOG_STEP("Mapping the file twice\n");
+    uint8_t *first = flatfs_mmap(&fs, "map.bin", NULL, FILE_SIZE, 0, PPROT_READ | PPROT_WRITE);
+    uint8_t *second = flatfs_mmap(&fs, "map.bin", NULL, FILE_SIZE, 0, PPROT_READ);
+    if (!first || !second) {
+        TEST_LOG_ERR("flatfs_mmap returned NULL\n");
+        goto out;
+    }
+    if (flatfs_mmap(&fs, "map.bin", NULL, FILE_SIZE + PAGE_SIZE, 0, PPROT_READ) != NULL) {
+        TEST_LOG_ERR("A mapping past the end of file was accepted\n");
+        goto out;
+    }
+    if (pmm_get_free_frames_count() != free_before) {
+        TEST_LOG_ERR("flatfs_mmap read pages up front\n");
+        goto out;
+    }
+    TEST_LOG_OK("Mapped at %p and %p without reading\n", first, second);
+
+    TEST_LOG_STEP("Reading through the mappings\n");
+    for (uint32_t i = 0; i < FILE_SIZE; i++) {
+        if (first[i] != data[i] || second[i] != data[i]) {
+            TEST_LOG_ERR("Mismatch at byte %u expected=0x%x got=0x%x/0x%x\n", i, data[i], first[i], second[i]);
+            goto out;
+        }
+    }
+    for (uint32_t i = FILE_SIZE; i < 6 * PAGE_SIZE; i++) {
+        if (first[i] != 0) {
+            TEST_LOG_ERR("Byte %u past the end of file is not zero\n", i);
+            goto out;
+        }
+    }
+    TEST_LOG_OK("Both mappings see the file\n");
+
+    TEST_LOG_STEP("Checking the clean pages are shared\n");
+    for (uint32_t p = 0; p < 6; p++) {
+        uint32_t frame = (uint32_t)paging_get_mapping(first + p * PAGE_SIZE);
+        page_t *page = page_from_frame(frame);
+
+        if (frame == 0 || frame != (uint32_t)paging_get_mapping(second + p * PAGE_SIZE)) {
+            TEST_LOG_ERR("Page %u is not shared\n", p);
+            goto out;
+        }
+        if (page && page->refcount != 3) {
+            TEST_LOG_ERR("Page %u has %u references, expected 3\n", p, page->refcount);
+            goto out;
+        }
+    }
+    TEST_LOG_OK("6 frames back 12 mapped pages\n");
+
+    TEST_LOG_STEP("Writing through the mapping and syncing\n");
+    for (uint32_t p = 0; p < 6; p++)
+        first[p * PAGE_SIZE + 17] = (uint8_t)(0xA0 + p);
+    data[17] = 0xA0;
+    data[3 * PAGE_SIZE + 17] = 0xA3;
+
+    if (second[3 * PAGE_SIZE + 17] != 0xA3) {
+        TEST_LOG_ERR("The other mapping does not see the write\n");
+        goto out;
+    }
+    if (msync(first, FILE_SIZE) != 0) {
+        TEST_LOG_ERR("msync failed\n");
+        goto out;
+    }
+
+    uint8_t check[32];
+    if (flatfs_read(&fs, "map.bin", 3 * PAGE_SIZE, check, sizeof(check), &bytes) != FLATFS_OK || check[17] != 0xA3) {
+        TEST_LOG_ERR("msync did not reach the file\n");
+        goto out;
+    }
+    if (flatfs_write(&fs, "map.bin", 0, check, 1, &bytes) != FLATFS_ERR_BUSY) {
+        TEST_LOG_ERR("flatfs_write to a mapped file was not refused\n");
+        goto out;
+    }
+    TEST_LOG_OK("Written pages reached their blocks\n");
+
+    TEST_LOG_STEP("Writing again and unmapping\n");
+    first[PAGE_SIZE + 40] = 0x5A;
+    data[PAGE_SIZE + 17] = 0xA1;
+    data[2 * PAGE_SIZE + 17] = 0xA2;
+    data[4 * PAGE_SIZE + 17] = 0xA4;
+    data[5 * PAGE_SIZE + 17] = 0xA5;
+    data[PAGE_SIZE + 40] = 0x5A;
+
+    munmap(second, FILE_SIZE);
+    munmap(first, FILE_SIZE);
+    second = first = NULL;
+
+    if (pmm_get_free_frames_count() != free_before) {
+        TEST_LOG_ERR("%u frames leaked\n", free_before - pmm_get_free_frames_count());
+        goto out;
+    }
+
+    uint8_t *copy = kalloc(FILE_SIZE);
+    if (!copy) {
+        TEST_LOG_ERR("No memory for the read back buffer\n");
+        goto out;
+    }
+    err = flatfs_read(&fs, "map.bin", 0, copy, FILE_SIZE, &bytes);
+    for (uint32_t i = 0; err == FLATFS_OK && i < FILE_SIZE; i++) {
+        if (copy[i] != data[i]) {
+            TEST_LOG_ERR("File byte %u expected=0x%x got=0x%x\n", i, data[i], copy[i]);
+            err = FLATFS_ERR_CORRUPT;
+        }
+    }
+    kfree(copy);
+    if (err != FLATFS_OK) {
+        TEST_LOG_ERR("Read back failed err=%d\n", err);
+        goto out;
+    }
+    TEST_LOG_OK("munmap wrote the last change back and released every frame\n");
+
+    TEST_LOG_TEST("PASS - mmap file-backed test succeeded\n");
+
+out:
+    if (second)
+        munmap(second, FILE_SIZE);
+    if (first)
+        munmap(first, FILE_SIZE);
+    flatfs_unmount(&fs);
+    kfree(data);
+}
\ No newline at end of file
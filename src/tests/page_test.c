@@ -0,0 +1,58 @@
+#include "tests/test_log.h"
+#include "mm/page.h"
+#include "mm/paging.h"
+#include "mm/pmm.h"
+
+#define TEST_VADDR 0xE0000000  /* unused kernel range */
+
+void page_test_refcount(void)
+{
+    TEST_LOG_TEST("Page descriptor test start\n");
+
+    TEST_LOG_STEP("Allocating a frame\n");
+    uint32_t frame = (uint32_t)pmm_alloc_frame();
+    page_t *page = page_from_frame(frame);
+    if (!frame || !page) {
+        TEST_LOG_ERR("No frame or no descriptor (frame=%x)\n", frame);
+        return;
+    }
+    if (page->refcount != 1) {
+        TEST_LOG_ERR("Fresh frame has refcount %u\n", page->refcount);
+        pmm_free_frame((void *)frame);
+        return;
+    }
+    TEST_LOG_OK("Frame %x has refcount 1\n", frame);
+
+    TEST_LOG_STEP("Mapping it, writing and unmapping\n");
+    paging_map_page((void *)TEST_VADDR, (void *)frame, PG_PRESENT | PG_WRITABLE);
+    if (page->owner != paging_get_current_directory()) {
+        TEST_LOG_ERR("Owner was not set by paging_map_page\n");
+        paging_unmap_page((void *)TEST_VADDR);
+        pmm_free_frame((void *)frame);
+        return;
+    }
+    *(volatile uint32_t *)TEST_VADDR = 0xC0FFEE;
+    paging_unmap_page((void *)TEST_VADDR);
+    if (!(page->flags & PAGE_DIRTY) || page->owner != NULL) {
+        TEST_LOG_ERR("Unmap did not record the dirty bit or clear the owner (flags=%x)\n", page->flags);
+        pmm_free_frame((void *)frame);
+        return;
+    }
+    TEST_LOG_OK("Dirty bit carried to the descriptor\n");
+
+    TEST_LOG_STEP("Sharing the frame and dropping both references\n");
+    page_get(frame);
+    pmm_free_frame((void *)frame);
+    if (!pmm_is_frame_used(frame) || page->refcount != 1) {
+        TEST_LOG_ERR("Shared frame was freed too early (refcount %u)\n", page->refcount);
+        return;
+    }
+    pmm_free_frame((void *)frame);
+    if (pmm_is_frame_used(frame) || page->refcount != 0) {
+        TEST_LOG_ERR("Frame still used after the last reference (refcount %u)\n", page->refcount);
+        return;
+    }
+    TEST_LOG_OK("Frame freed with the last reference\n");
+
+    TEST_LOG_TEST("PASS - Page descriptor test succeeded\n");
+}
\ No newline at end of file
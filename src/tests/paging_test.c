@@ -0,0 +1,261 @@
+#include "tests/test_log.h"
+#include "kernel/syscall.h"
+#include "kernel/timer.h"
+#include "mm/buddy.h"
+#include "mm/kheap.h"
+#include "mm/paging.h"
+#include "mm/pmm.h"
+#include "mm/tlb.h"
+
+#define BENCH_VADDR         0xE0000000  /* unused kernel range */
+#define BENCH_PAGES         256
+#define BENCH_SWITCHES      1000
+#define BENCH_TOUCH_PAGES   64
+#define SWEEP_PASSES        16
+#define SWEEP_HEAP_SIZE     0x800000
+#define COW_PAGES           1024  /* 4 MiB of written data in the parent */
+
+static page_directory_t bench_directory;
+
+static void bench_map_all(void *frame)
+{
+    for (uint32_t i = 0; i < BENCH_PAGES; i++)
+        paging_map_page((void *)(BENCH_VADDR + i * PAGE_SIZE), frame, PG_PRESENT | PG_WRITABLE);
+}
+
+/* switch to the other address space and back, reading one byte of every touched page after each switch */
+static uint32_t bench_switch_run(volatile uint8_t *touch)
+{
+    page_directory_t *home = paging_get_current_directory();
+    uint32_t sum = 0;
+
+    uint64_t start = timer_read_tsc();
+    for (uint32_t i = 0; i < BENCH_SWITCHES; i++) {
+        switch_page_directory(&bench_directory);
+        for (uint32_t p = 0; p < BENCH_TOUCH_PAGES; p++)
+            sum += touch[p * PAGE_SIZE];
+
+        switch_page_directory(home);
+        for (uint32_t p = 0; p < BENCH_TOUCH_PAGES; p++)
+            sum += touch[p * PAGE_SIZE];
+    }
+    uint32_t cycles = (uint32_t)(timer_read_tsc() - start);
+
+    (void)sum;
+    return cycles / BENCH_SWITCHES;
+}
+
+void paging_test_bench_tlb(void)
+{
+    TEST_LOG_TEST("TLB benchmark start (global pages %s)\n", tlb_global_pages_enabled() ? "on" : "off");
+
+    void *frame = pmm_alloc_frame();
+    if (!frame) {
+        TEST_LOG_ERR("pmm_alloc_frame returned NULL\n");
+        return;
+    }
+
+    TEST_LOG_STEP("Mapping and unmapping %u pages one invlpg at a time\n", BENCH_PAGES);
+    uint64_t start = timer_read_tsc();
+    bench_map_all(frame);
+    for (uint32_t i = 0; i < BENCH_PAGES; i++)
+        paging_unmap_page((void *)(BENCH_VADDR + i * PAGE_SIZE));
+    uint32_t single_cycles = (uint32_t)(timer_read_tsc() - start);
+
+    TEST_LOG_STEP("Mapping and unmapping %u pages with a range flush\n", BENCH_PAGES);
+    start = timer_read_tsc();
+    bench_map_all(frame);
+    paging_unmap_range((void *)BENCH_VADDR, BENCH_PAGES * PAGE_SIZE);
+    uint32_t range_cycles = (uint32_t)(timer_read_tsc() - start);
+
+    if (paging_get_mapping((void *)BENCH_VADDR) != NULL) {
+        TEST_LOG_ERR("Bench range is still mapped after unmapping\n");
+        pmm_free_frame(frame);
+        return;
+    }
+    pmm_free_frame(frame);
+    TEST_LOG_INFO("map+unmap: %u cycles/page with invlpg, %u cycles/page with a range flush\n",
+                  single_cycles / BENCH_PAGES, range_cycles / BENCH_PAGES);
+
+    TEST_LOG_STEP("Switching between two address spaces, touching %u kernel pages each time\n", BENCH_TOUCH_PAGES);
+    uint8_t *touch = (uint8_t *)kalloc(BENCH_TOUCH_PAGES * PAGE_SIZE);
+    if (!touch) {
+        TEST_LOG_ERR("kalloc of the touched buffer failed\n");
+        return;
+    }
+    paging_init_directory(&bench_directory);
+
+    uint8_t global_was_on = tlb_global_pages_enabled();
+    tlb_set_global_pages(1);
+    uint32_t global_cycles = bench_switch_run(touch);
+    tlb_set_global_pages(0);
+    uint32_t plain_cycles = bench_switch_run(touch);
+    tlb_set_global_pages(global_was_on);
+
+    paging_unlink_directory(&bench_directory);
+    kfree(touch);
+
+    TEST_LOG_INFO("switch round trip: %u cycles with global kernel pages, %u cycles without\n", global_cycles, plain_cycles);
+    TEST_LOG_TEST("PASS - TLB benchmark finished\n");
+}
+/* read one byte of every page of [base, base + size), SWEEP_PASSES times, returns cycles per read */
+static uint32_t sweep_run(volatile uint8_t *base, uint32_t size)
+{
+    uint32_t pages = size / PAGE_SIZE;
+    uint32_t sum = 0;
+
+    uint64_t start = timer_read_tsc();
+    for (uint32_t pass = 0; pass < SWEEP_PASSES; pass++)
+        for (uint32_t p = 0; p < pages; p++)
+            sum += base[p * PAGE_SIZE + (pass * 64) % PAGE_SIZE];
+    uint32_t cycles = (uint32_t)(timer_read_tsc() - start);
+
+    (void)sum;
+    return cycles / (pages * SWEEP_PASSES);
+}
+
+void paging_test_bench_large_pages(void)
+{
+    TEST_LOG_TEST("Large page sweep benchmark start\n");
+
+    if (!paging_large_pages_enabled()) {
+        TEST_LOG_WARN("CR4.PSE is off, skipping\n");
+        return;
+    }
+
+    TEST_LOG_STEP("Mapping 4 MiB with one large page and 4 MiB with 1024 small pages\n");
+    void *block = buddy_alloc(BUDDY_MAX_ORDER);
+    if (!block) {
+        TEST_LOG_ERR("buddy_alloc of a 4 MiB block failed\n");
+        return;
+    }
+    if (paging_map_large_page((void *)BENCH_VADDR, block, PG_PRESENT | PG_WRITABLE) != 0) {
+        TEST_LOG_ERR("paging_map_large_page failed\n");
+        buddy_free(block, BUDDY_MAX_ORDER);
+        return;
+    }
+
+    uint32_t small_base = BENCH_VADDR + LARGE_PAGE_SIZE;
+    uint32_t mapped = 0;
+    for (; mapped < LARGE_PAGE_SIZE / PAGE_SIZE; mapped++) {
+        void *frame = pmm_alloc_frame();
+        if (!frame)
+            break;
+        paging_map_page((void *)(small_base + mapped * PAGE_SIZE), frame, PG_PRESENT | PG_WRITABLE);
+    }
+
+    uint32_t large_cycles = sweep_run((volatile uint8_t *)BENCH_VADDR, LARGE_PAGE_SIZE);
+    uint32_t small_cycles = mapped ? sweep_run((volatile uint8_t *)small_base, mapped * PAGE_SIZE) : 0;
+
+    for (uint32_t i = 0; i < mapped; i++)
+        pmm_free_frame(paging_get_mapping((void *)(small_base + i * PAGE_SIZE)));
+    paging_unmap_range((void *)small_base, mapped * PAGE_SIZE);
+    paging_unmap_large_page((void *)BENCH_VADDR);
+    buddy_free(block, BUDDY_MAX_ORDER);
+
+    TEST_LOG_INFO("page-strided read: %u cycles with a 4 MiB page, %u cycles with 4 KiB pages\n", large_cycles, small_cycles);
+
+    TEST_LOG_STEP("Sweeping a %u KiB heap buffer\n", SWEEP_HEAP_SIZE / 1024);
+    uint8_t *buffer = (uint8_t *)kalloc_heap(SWEEP_HEAP_SIZE);
+    if (!buffer) {
+        TEST_LOG_ERR("kalloc_heap(%u) returned NULL\n", SWEEP_HEAP_SIZE);
+        return;
+    }
+
+    uint32_t large_bytes = 0;
+    for (uint32_t offset = 0; offset < SWEEP_HEAP_SIZE; offset += PAGE_SIZE)
+        if (paging_is_large_page(buffer + offset))
+            large_bytes += PAGE_SIZE;
+
+    uint32_t heap_cycles = sweep_run(buffer, SWEEP_HEAP_SIZE);
+    kfree(buffer);
+
+    TEST_LOG_INFO("heap sweep: %u KiB of %u KiB in large pages, %u cycles per read\n",
+                  large_bytes / 1024, SWEEP_HEAP_SIZE / 1024, heap_cycles);
+    TEST_LOG_TEST("PASS - Large page sweep benchmark finished\n");
+}
+/* the value every page of the cow test starts with */
+#define COW_PATTERN(page) ((uint8_t)((page) * 7 + 1))
+
+static uint8_t cow_check(volatile uint8_t *map, uint32_t pages)
+{
+    for (uint32_t i = 0; i < pages; i++)
+        if (map[i * PAGE_SIZE] != COW_PATTERN(i))
+            return 0;
+
+    return 1;
+}
+
+void paging_test_cow_clone(void)
+{
+    TEST_LOG_TEST("Copy-on-write clone test start\n");
+
+    /* warm up the caches the clone allocates from */
+    page_directory_t *warm = paging_clone_directory();
+    if (!warm) {
+        TEST_LOG_ERR("paging_clone_directory returned NULL\n");
+        return;
+    }
+    paging_destroy_directory(warm);
+
+    volatile uint8_t *map = (volatile uint8_t *)mmap(NULL, COW_PAGES * PAGE_SIZE, PPROT_READ | PPROT_WRITE);
+    if (!map) {
+        TEST_LOG_ERR("mmap returned NULL\n");
+        return;
+    }
+    for (uint32_t i = 0; i < COW_PAGES; i++)
+        map[i * PAGE_SIZE] = COW_PATTERN(i);
+
+    TEST_LOG_STEP("Cloning an address space with %u KiB of data\n", COW_PAGES * PAGE_SIZE / 1024);
+    page_directory_t *home = paging_get_current_directory();
+    uint32_t free_before = pmm_get_free_frames_count();
+
+    uint64_t start = timer_read_tsc();
+    page_directory_t *clone = paging_clone_directory();
+    uint32_t clone_cycles = (uint32_t)(timer_read_tsc() - start);
+
+    if (!clone) {
+        TEST_LOG_ERR("paging_clone_directory returned NULL\n");
+        munmap((void *)map, COW_PAGES * PAGE_SIZE);
+        return;
+    }
+    uint32_t clone_frames = free_before - pmm_get_free_frames_count();
+    if (clone_frames > COW_PAGES / PAGING_ENTRIES_SIZE + 1) {
+        TEST_LOG_ERR("Clone took %u frames, more than the page tables\n", clone_frames);
+    }
+    TEST_LOG_INFO("clone: %u cycles, %u frames\n", clone_cycles, clone_frames);
+
+    TEST_LOG_STEP("Reading and writing in the clone\n");
+    switch_page_directory(clone);
+    uint8_t clone_ok = cow_check(map, COW_PAGES);
+    uint32_t free_shared = pmm_get_free_frames_count();
+    map[0] = 0xAA;
+    uint8_t copied = pmm_get_free_frames_count() == free_shared - 1 && map[0] == 0xAA && map[PAGE_SIZE] == COW_PATTERN(1);
+    switch_page_directory(home);
+
+    if (!clone_ok || !copied) {
+        TEST_LOG_ERR("Clone sees wrong data or the write was not copied (read %u, copy %u)\n", clone_ok, copied);
+    } else if (map[0] != COW_PATTERN(0)) {
+        TEST_LOG_ERR("Write in the clone leaked into the parent\n");
+    } else {
+        TEST_LOG_OK("Clone got its own copy of the written page only\n");
+    }
+
+    TEST_LOG_STEP("Destroying the clone and writing in the parent\n");
+    paging_destroy_directory(clone);
+    uint32_t free_after_destroy = pmm_get_free_frames_count();
+    map[PAGE_SIZE] = 0x55;
+    if (pmm_get_free_frames_count() != free_after_destroy || map[PAGE_SIZE] != 0x55) {
+        TEST_LOG_ERR("A page no longer shared was copied on write\n");
+    } else {
+        TEST_LOG_OK("Unshared page was made writable in place\n");
+    }
+
+    munmap((void *)map, COW_PAGES * PAGE_SIZE);
+    if (pmm_get_free_frames_count() < free_before + COW_PAGES) {
+        TEST_LOG_ERR("%u frames leaked\n", free_before + COW_PAGES - pmm_get_free_frames_count());
+        return;
+    }
+
+    TEST_LOG_TEST("PASS - Copy-on-write clone test finished\n");
+}
\ No newline at end of file
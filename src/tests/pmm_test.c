@@ -0,0 +1,258 @@
+#include "tests/test_log.h"
+#include "kernel/timer.h"
+#include "mm/kheap.h"
+#include "mm/paging.h"
+#include "mm/pmm.h"
+#include "multitasking/lock.h"
+#include "multitasking/process.h"
+#include "multitasking/scheduler.h"
+#include "multitasking/sleep.h"
+#include "utils/bitmap_util.h"
+#include "utils/utils.h"
+
+/* allocate every free frame, then free all of them, and time both passes */
+void pmm_test_bench_alloc_all(void)
+{
+    TEST_LOG_TEST("PMM alloc-all benchmark start\n");
+
+    /* remember which frames the benchmark took, so exactly those are given back */
+    uint32_t frames_count = pmm_get_frames_count();
+    uint8_t *taken = (uint8_t *)kalloc(frames_count / 8);
+    if (!taken) {
+        TEST_LOG_ERR("kalloc of the taken frames bitmap failed\n");
+        return;
+    }
+    memset(taken, 0, frames_count / 8);
+
+    uint32_t free_before = pmm_get_free_frames_count();
+    TEST_LOG_INFO("%u free frames before the benchmark\n", free_before);
+
+    TEST_LOG_STEP("Allocating every free frame\n");
+    uint32_t count = 0;
+    uint64_t start = timer_read_tsc();
+    for (void *frame = pmm_alloc_frame(); frame != NULL; frame = pmm_alloc_frame()) {
+        bitmap_set(taken, (uint32_t)frame / FRAME_SIZE);
+        count++;
+    }
+    uint64_t alloc_cycles = timer_read_tsc() - start;
+
+    if (count != free_before || pmm_get_free_frames_count() != 0) {
+        TEST_LOG_ERR("Allocated %u frames, expected %u\n", count, free_before);
+    } else {
+        TEST_LOG_OK("Allocated %u frames\n", count);
+    }
+
+    TEST_LOG_STEP("Freeing them again\n");
+    start = timer_read_tsc();
+    for (uint32_t i = 0; i < frames_count; i++)
+        if (bitmap_get(taken, i))
+            pmm_free_frame((void *)(i * FRAME_SIZE));
+    uint64_t free_cycles = timer_read_tsc() - start;
+
+    kfree(taken);
+
+    if (pmm_get_free_frames_count() != free_before) {
+        TEST_LOG_ERR("%u free frames after the benchmark, expected %u\n", pmm_get_free_frames_count(), free_before);
+        return;
+    }
+
+    /* no 64 bit division in the kernel, so report in units of 1024 cycles */
+    uint32_t per_kframes = count / 1024 ? count / 1024 : 1;
+    TEST_LOG_INFO("alloc: %u Kcycles total, ~%u cycles/frame\n", (uint32_t)(alloc_cycles >> 10), (uint32_t)(alloc_cycles >> 10) / per_kframes);
+    TEST_LOG_INFO("free: %u Kcycles total, ~%u cycles/frame\n", (uint32_t)(free_cycles >> 10), (uint32_t)(free_cycles >> 10) / per_kframes);
+    TEST_LOG_TEST("PASS - PMM alloc-all benchmark finished\n");
+}
+
+#define ZEROED_MISSES 64
+#define ZEROED_CHECK_VADDR 0xE0000000  /* unused kernel range */
+
+static void *zeroed_frames[PMM_ZEROED_POOL_TARGET + ZEROED_MISSES];
+
+/* fill the zeroed pool the way the idle process does, then time frames taken from it against frames zeroed on demand */
+void pmm_test_bench_zeroed_pool(void)
+{
+    TEST_LOG_TEST("PMM zeroed pool benchmark start\n");
+
+    uint32_t free_before = pmm_get_free_frames_count();
+
+    TEST_LOG_STEP("Filling the pool\n");
+    while (pmm_zeroed_pool_refill())
+        ;
+    uint32_t pooled = pmm_get_zeroed_frames_count();
+    if (pooled == 0) {
+        TEST_LOG_ERR("The pool stayed empty\n");
+        return;
+    }
+    if (pmm_get_free_frames_count() != free_before) {
+        TEST_LOG_ERR("Pooled frames are not counted as free\n");
+    }
+    TEST_LOG_OK("%u frames zeroed ahead of time\n", pooled);
+
+    TEST_LOG_STEP("Taking %u pooled frames and %u frames zeroed on demand\n", pooled, ZEROED_MISSES);
+    uint64_t start = timer_read_tsc();
+    for (uint32_t i = 0; i < pooled; i++)
+        zeroed_frames[i] = pmm_alloc_zeroed_frame();
+    uint32_t hit_cycles = (uint32_t)(timer_read_tsc() - start);
+
+    start = timer_read_tsc();
+    for (uint32_t i = pooled; i < pooled + ZEROED_MISSES; i++)
+        zeroed_frames[i] = pmm_alloc_zeroed_frame();
+    uint32_t miss_cycles = (uint32_t)(timer_read_tsc() - start);
+
+    uint8_t all_zero = 1;
+    for (uint32_t i = 0; i < pooled + ZEROED_MISSES && all_zero; i++) {
+        if (!zeroed_frames[i]) {
+            all_zero = 0;
+            break;
+        }
+
+        paging_map_page((void *)ZEROED_CHECK_VADDR, zeroed_frames[i], PG_PRESENT);
+        uint32_t *words = (uint32_t *)ZEROED_CHECK_VADDR;
+        for (uint32_t w = 0; w < FRAME_SIZE / sizeof(uint32_t); w++)
+            if (words[w] != 0)
+                all_zero = 0;
+        paging_unmap_page((void *)ZEROED_CHECK_VADDR);
+    }
+
+    for (uint32_t i = 0; i < pooled + ZEROED_MISSES; i++)
+        pmm_free_frame(zeroed_frames[i]);
+
+    if (!all_zero) {
+        TEST_LOG_ERR("A frame from pmm_alloc_zeroed_frame is missing or not zero\n");
+        return;
+    }
+    if (pmm_get_free_frames_count() != free_before) {
+        TEST_LOG_ERR("%u free frames after the benchmark, expected %u\n", pmm_get_free_frames_count(), free_before);
+        return;
+    }
+
+    TEST_LOG_INFO("zeroed frame: ~%u cycles from the pool, ~%u cycles zeroed on demand\n",
+                  hit_cycles / pooled, miss_cycles / ZEROED_MISSES);
+    TEST_LOG_TEST("PASS - PMM zeroed pool benchmark finished\n");
+}
+
+/* reserve and release a free window of whole and partial bitmap words, and check the zone accounting */
+void pmm_test_ranges_and_zones(void)
+{
+    enum { WINDOW_FRAMES = 100, WINDOW_OFFSET = 5 };
+
+    TEST_LOG_TEST("PMM ranges and zones test start\n");
+
+    uint32_t zones_free = 0;
+    for (uint32_t z = 0; z < PMM_ZONES_COUNT; z++) {
+        const pmm_zone_t *zone = pmm_get_zone(z);
+        TEST_LOG_INFO("zone %s: frames [0x%x, 0x%x), %u free\n", zone->name, zone->start_frame, zone->end_frame, zone->free_frames);
+        zones_free += zone->free_frames;
+    }
+
+    uint32_t eflags = irq_save();  // keep the idle process from taking frames out of the window
+
+    if (zones_free + pmm_get_zeroed_frames_count() != pmm_get_free_frames_count()) {
+        irq_restore(eflags);
+        TEST_LOG_ERR("Zones hold %u free frames, the pmm reports %u\n", zones_free, pmm_get_free_frames_count());
+        return;
+    }
+
+    /* find a free window in the normal zone, starting off a word boundary so both edge words are partial */
+    const pmm_zone_t *normal = pmm_get_zone(PMM_ZONE_NORMAL);
+    uint32_t window = 0;
+    for (uint32_t start = (normal->start_frame + 31) & ~31u; start + 32 + WINDOW_FRAMES <= normal->end_frame && window == 0; start += 32) {
+        uint32_t i = 0;
+        while (i < WINDOW_FRAMES && !pmm_is_frame_used((start + WINDOW_OFFSET + i) * FRAME_SIZE))
+            i++;
+
+        if (i == WINDOW_FRAMES)
+            window = start + WINDOW_OFFSET;
+    }
+
+    if (window == 0) {
+        irq_restore(eflags);
+        TEST_LOG_WARN("No free window of %u frames, skipping\n", WINDOW_FRAMES);
+        return;
+    }
+
+    uint32_t free_before = pmm_get_free_frames_count();
+    uint8_t neighbour_used = pmm_is_frame_used((window + WINDOW_FRAMES) * FRAME_SIZE);
+
+    TEST_LOG_STEP("Reserving frames [0x%x, 0x%x)\n", window, window + WINDOW_FRAMES);
+    pmm_reserve_range(window * FRAME_SIZE, WINDOW_FRAMES * FRAME_SIZE);
+
+    uint8_t reserved = pmm_get_free_frames_count() == free_before - WINDOW_FRAMES &&
+                       pmm_is_frame_used(window * FRAME_SIZE) && pmm_is_frame_used((window + WINDOW_FRAMES - 1) * FRAME_SIZE) &&
+                       pmm_is_frame_used((window + WINDOW_FRAMES) * FRAME_SIZE) == neighbour_used;
+
+    pmm_release_range(window * FRAME_SIZE, WINDOW_FRAMES * FRAME_SIZE);
+    uint32_t free_after = pmm_get_free_frames_count();
+    uint8_t released = free_after == free_before && !pmm_is_frame_used((window + WINDOW_FRAMES / 2) * FRAME_SIZE);
+
+    irq_restore(eflags);
+
+    if (!reserved || !released) {
+        TEST_LOG_ERR("Range operations off: %u free before, %u after\n", free_before, free_after);
+        return;
+    }
+    TEST_LOG_OK("Window reserved and released, %u free frames\n", free_after);
+
+    TEST_LOG_STEP("Allocating from the dma zone\n");
+    void *dma = pmm_alloc_frame_zone(PMM_ZONE_DMA);
+    if (dma != NULL && (uint32_t)dma >= PMM_ZONE_DMA_END) {
+        TEST_LOG_ERR("DMA frame %x is above 16 MiB\n", dma);
+        pmm_free_frame(dma);
+        return;
+    }
+    if (dma == NULL) {
+        TEST_LOG_WARN("The dma zone is empty\n");
+    } else {
+        TEST_LOG_OK("DMA frame at %x\n", dma);
+        pmm_free_frame(dma);
+    }
+
+    TEST_LOG_TEST("PASS - PMM ranges and zones test succeeded\n");
+}
+
+#define IDLE_REFILL_TIMEOUT_MS 2000
+
+static void idle_refill_checker_main(void)
+{
+    uint32_t start = timer_time_ms();
+
+    while (pmm_get_zeroed_frames_count() < PMM_ZEROED_POOL_TARGET && timer_time_ms() - start < IDLE_REFILL_TIMEOUT_MS)
+        ksleep_ms(10);
+
+    uint32_t pooled = pmm_get_zeroed_frames_count();
+    if (pooled < PMM_ZEROED_POOL_TARGET) {
+        TEST_LOG_ERR("The idle loop zeroed only %u of %u frames in %u ms\n", pooled, PMM_ZEROED_POOL_TARGET, IDLE_REFILL_TIMEOUT_MS);
+        return;
+    }
+
+    TEST_LOG_OK("The idle loop filled the pool in %u ms\n", timer_time_ms() - start);
+    TEST_LOG_TEST("PASS - PMM idle refill test succeeded\n");
+}
+
+/* empty the pool and leave the refill to the idle loop, kernel_main has to enter it right after this call */
+void pmm_test_idle_refill(void)
+{
+    TEST_LOG_TEST("PMM idle refill test start\n");
+
+    TEST_LOG_STEP("Emptying the pool\n");
+    uint32_t taken = 0;
+    while (pmm_get_zeroed_frames_count() > 0 && taken < PMM_ZEROED_POOL_TARGET)
+        zeroed_frames[taken++] = pmm_alloc_zeroed_frame();
+    for (uint32_t i = 0; i < taken; i++)
+        pmm_free_frame(zeroed_frames[i]);
+
+    if (pmm_get_zeroed_frames_count() != 0) {
+        TEST_LOG_ERR("%u frames left in the pool\n", pmm_get_zeroed_frames_count());
+        return;
+    }
+
+    process_t *checker = process_create(PROCESS_KERNEL, idle_refill_checker_main, 0x2000);
+    if (!checker) {
+        TEST_LOG_ERR("process_create failed\n");
+        return;
+    }
+
+    TEST_LOG_STEP("Waiting up to %u ms for the idle loop to fill it\n", IDLE_REFILL_TIMEOUT_MS);
+    scheduler_add_process_to_ready_queue(checker);
+    scheduler_set_on();
+}
\ No newline at end of file
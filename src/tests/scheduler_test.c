@@ -0,0 +1,383 @@
+#include "tests/scheduler_test.h"
+#include "tests/test_log.h"
+#include "kernel/timer.h"
+#include "mm/kheap.h"
+#include "multitasking/lock.h"
+#include "multitasking/run_queue.h"
+#include "multitasking/scheduler.h"
+#include "multitasking/sleep.h"
+#include "utils/utils.h"
+
+#define BENCH_THREADS 4096
+
+#define LATENCY_HOGS         3
+#define LATENCY_ROUNDS       100
+#define LATENCY_WAKE_EVERY   3  /* ms between two wakeups */
+
+#define SLEEPERS             2048
+#define SLEEP_BASE_MS        300   /* every thread is asleep before the first one wakes */
+#define SLEEP_SPREAD         97    /* distinct durations, SLEEP_STEP_MS apart, so several levels of the wheel are used */
+#define SLEEP_STEP_MS        13
+
+#define SWITCH_ROUNDS        20000  /* yields per thread */
+
+/* the enqueue the scheduler had before the run queues: walk the whole list to find its tail */
+static void walk_to_tail_push(process_t **head, process_t *process)
+{
+    if (*head == NULL) {
+        *head = process;
+        return;
+    }
+
+    process_t *last = *head;
+    while (last->next != NULL)
+        last = last->next;
+
+    last->next = process;
+}
+
+void scheduler_test_bench_run_queue(void)
+{
+    TEST_LOG_TEST("Run queue benchmark start (%u threads)\n", BENCH_THREADS);
+
+    /* only the queue links and the priority are used, the rest of the descriptors stays zero */
+    process_t *threads = kalloc(BENCH_THREADS * sizeof(process_t));
+    if (!threads) {
+        TEST_LOG_ERR("No memory for the thread descriptors\n");
+        return;
+    }
+    memset(threads, 0, BENCH_THREADS * sizeof(process_t));
+
+    for (uint32_t i = 0; i < BENCH_THREADS; i++) {
+        threads[i].pid = i;
+        threads[i].priority = (i * 7) % PROCESS_PRIORITIES;
+    }
+
+    run_queue_t queue;
+    run_queue_init(&queue);
+
+    TEST_LOG_STEP("Enqueueing and dequeueing every thread\n");
+    uint64_t start = timer_read_tsc();
+    for (uint32_t i = 0; i < BENCH_THREADS; i++)
+        run_queue_push(&queue, &threads[i]);
+    uint32_t push_cycles = (uint32_t)(timer_read_tsc() - start);
+
+    process_t *order[PROCESS_PRIORITIES] = { 0 };  /* the last thread popped of every priority */
+    uint8_t last_priority = 0;
+    uint8_t ok = queue.count == BENCH_THREADS;
+
+    start = timer_read_tsc();
+    for (uint32_t i = 0; i < BENCH_THREADS; i++) {
+        process_t *p = run_queue_pop(&queue);
+
+        /* priorities come out best first, FIFO inside a priority */
+        if (p == NULL || p->priority < last_priority ||
+            (order[p->priority] && order[p->priority]->pid > p->pid)) {
+            ok = 0;
+            break;
+        }
+
+        last_priority = p->priority;
+        order[p->priority] = p;
+    }
+    uint32_t pop_cycles = (uint32_t)(timer_read_tsc() - start);
+
+    if (!ok || run_queue_pop(&queue) != NULL || queue.bitmap != 0) {
+        TEST_LOG_ERR("Threads came out in the wrong order\n");
+        kfree(threads);
+        return;
+    }
+    TEST_LOG_OK("Enqueue %u cycles, dequeue %u cycles per thread\n",
+                push_cycles / BENCH_THREADS, pop_cycles / BENCH_THREADS);
+
+    TEST_LOG_STEP("Removing every other thread from the middle of the queue\n");
+    for (uint32_t i = 0; i < BENCH_THREADS; i++)
+        run_queue_push(&queue, &threads[i]);
+
+    start = timer_read_tsc();
+    for (uint32_t i = 0; i < BENCH_THREADS; i += 2)
+        run_queue_remove(&queue, &threads[i]);
+    uint32_t remove_cycles = (uint32_t)(timer_read_tsc() - start);
+
+    uint32_t left = 0;
+    for (process_t *p = run_queue_pop(&queue); p != NULL; p = run_queue_pop(&queue)) {
+        if (p->pid % 2 == 0) {
+            TEST_LOG_ERR("Removed thread %u is still queued\n", p->pid);
+            kfree(threads);
+            return;
+        }
+        left++;
+    }
+    if (left != BENCH_THREADS / 2) {
+        TEST_LOG_ERR("%u threads left, expected %u\n", left, BENCH_THREADS / 2);
+        kfree(threads);
+        return;
+    }
+    TEST_LOG_OK("Remove %u cycles per thread\n", remove_cycles / (BENCH_THREADS / 2));
+
+    TEST_LOG_STEP("Enqueueing with the old tail walk for comparison\n");
+    process_t *head = NULL;
+    start = timer_read_tsc();
+    for (uint32_t i = 0; i < BENCH_THREADS; i++)
+        walk_to_tail_push(&head, &threads[i]);
+    uint32_t walk_cycles = (uint32_t)(timer_read_tsc() - start);
+
+    for (uint32_t i = 0; i < BENCH_THREADS; i++)
+        threads[i].next = NULL;
+    TEST_LOG_INFO("Tail walk enqueue %u cycles per thread\n", walk_cycles / BENCH_THREADS);
+
+    kfree(threads);
+    TEST_LOG_TEST("PASS - run queue benchmark finished\n");
+}
+
+static process_t *volatile latency_sleeper;
+static process_t *volatile latency_waker;
+static volatile uint64_t latency_woken_tsc;
+static volatile uint32_t latency_woken_ms;
+static volatile uint8_t latency_stop;
+static volatile uint32_t latency_done;
+static uint32_t latency_max_cycles;
+static uint32_t latency_max_ms;
+static uint64_t latency_total_cycles;
+
+/* cpu bound, one of them also wakes the sleeper every few ms from inside its busy loop */
+static void latency_hog_main(void)
+{
+    uint32_t next_wake = timer_time_ms() + LATENCY_WAKE_EVERY;
+
+    while (!latency_stop) {
+        if (scheduler_get_current_process() != latency_waker || timer_time_ms() < next_wake)
+            continue;
+
+        uint32_t eflags = irq_save();
+        if (latency_sleeper->status == PROCESS_BLOCKED) {
+            latency_woken_ms = timer_time_ms();
+            latency_woken_tsc = timer_read_tsc();
+            scheduler_wake(latency_sleeper);
+        }
+        irq_restore(eflags);
+
+        next_wake = timer_time_ms() + LATENCY_WAKE_EVERY;
+    }
+
+    uint32_t eflags = irq_save();
+    latency_done++;
+    irq_restore(eflags);
+}
+
+static void latency_sleeper_main(void)
+{
+    for (uint32_t round = 0; round < LATENCY_ROUNDS; round++) {
+        scheduler_block();
+
+        uint32_t cycles = (uint32_t)(timer_read_tsc() - latency_woken_tsc);
+        uint32_t ms = timer_time_ms() - latency_woken_ms;
+
+        latency_total_cycles += cycles;
+        if (cycles > latency_max_cycles)
+            latency_max_cycles = cycles;
+        if (ms > latency_max_ms)
+            latency_max_ms = ms;
+    }
+
+    latency_stop = 1;
+
+    uint32_t eflags = irq_save();
+    latency_done++;
+    irq_restore(eflags);
+}
+
+void scheduler_test_wakeup_latency(void)
+{
+    process_t *threads[LATENCY_HOGS + 1];
+
+    TEST_LOG_TEST("Wakeup latency test start (%u ms quantum)\n", scheduler_get_quantum_ms());
+
+    latency_stop = 0;
+    latency_done = 0;
+    latency_max_cycles = 0;
+    latency_max_ms = 0;
+    latency_total_cycles = 0;
+
+    TEST_LOG_STEP("Creating a sleeper and %u cpu bound threads\n", LATENCY_HOGS);
+    for (uint32_t i = 0; i <= LATENCY_HOGS; i++) {
+        threads[i] = process_create(PROCESS_KERNEL, i == 0 ? latency_sleeper_main : latency_hog_main, 0x2000);
+        if (!threads[i]) {
+            TEST_LOG_ERR("process_create failed\n");
+            while (i-- > 0)
+                process_destroy(threads[i]);
+            return;
+        }
+    }
+    latency_sleeper = threads[0];
+    latency_waker = threads[1];
+
+    for (uint32_t i = 0; i <= LATENCY_HOGS; i++)
+        scheduler_add_process_to_ready_queue(threads[i]);
+    scheduler_set_on();
+
+    /* the idle thread only runs again once every test thread is gone */
+    while (latency_done < LATENCY_HOGS + 1)
+        __asm__ __volatile__("hlt");
+
+    uint32_t average = (uint32_t)latency_total_cycles / LATENCY_ROUNDS;
+    TEST_LOG_INFO("Wakeup to run: average %u cycles, worst %u cycles (%u ms)\n",
+                  average, latency_max_cycles, latency_max_ms);
+
+    /* a woken thread outranks the demoted hogs, right after a boost it waits at most one slice */
+    if (latency_max_ms > scheduler_get_quantum_ms() + 1) {
+        TEST_LOG_ERR("Worst wakeup latency %u ms is longer than a slice\n", latency_max_ms);
+        return;
+    }
+    TEST_LOG_OK("Wakeups are served within a slice under load\n");
+
+    TEST_LOG_TEST("PASS - wakeup latency test succeeded\n");
+}
+
+static volatile uint32_t sleep_asleep;
+static volatile uint32_t sleep_done;
+static volatile uint32_t sleep_early;
+static volatile uint32_t sleep_max_late;
+static uint32_t sleep_start_ms;
+
+static void sleeper_main(void)
+{
+    process_t *self = scheduler_get_current_process();
+    uint32_t deadline = sleep_start_ms + SLEEP_BASE_MS + (self->pid % SLEEP_SPREAD) * SLEEP_STEP_MS;
+
+    uint32_t eflags = irq_save();
+    sleep_asleep++;
+    irq_restore(eflags);
+
+    ksleep_until(deadline);
+
+    uint32_t now = timer_time_ms();
+
+    eflags = irq_save();
+    if ((int32_t)(now - deadline) < 0)
+        sleep_early++;
+    else if (now - deadline > sleep_max_late)
+        sleep_max_late = now - deadline;
+    sleep_done++;
+    irq_restore(eflags);
+}
+
+void scheduler_test_sleepers(void)
+{
+    TEST_LOG_TEST("Sleep queue test start (%u sleepers)\n", SLEEPERS);
+
+    sleep_asleep = 0;
+    sleep_done = 0;
+    sleep_early = 0;
+    sleep_max_late = 0;
+    sleep_start_ms = timer_time_ms();
+
+    TEST_LOG_STEP("Creating the sleepers\n");
+    for (uint32_t i = 0; i < SLEEPERS; i++) {
+        process_t *p = process_create(PROCESS_KERNEL, sleeper_main, 0x1000);
+        if (!p) {
+            TEST_LOG_ERR("process_create failed after %u threads\n", i);
+            return;
+        }
+        scheduler_add_process_to_ready_queue(p);
+    }
+    scheduler_set_on();
+
+    /* the idle thread only runs with nothing ready, so getting here with everyone asleep means sleepers take no cpu */
+    while (sleep_asleep < SLEEPERS || sleep_queue_count() < SLEEPERS - sleep_done)
+        __asm__ __volatile__("hlt");
+
+    if (sleep_done != 0)
+        TEST_LOG_WARN("%u sleepers woke before the idle thread ran\n", sleep_done);
+    else
+        TEST_LOG_OK("All %u threads asleep after %u ms, the cpu is idle\n",
+                    sleep_queue_count(), timer_time_ms() - sleep_start_ms);
+
+    while (sleep_done < SLEEPERS)
+        __asm__ __volatile__("hlt");
+
+    if (sleep_early != 0) {
+        TEST_LOG_ERR("%u sleepers woke before their deadline\n", sleep_early);
+        return;
+    }
+    if (sleep_queue_count() != 0) {
+        TEST_LOG_ERR("%u sleepers left in the wheel\n", sleep_queue_count());
+        return;
+    }
+    TEST_LOG_OK("Every sleeper woke on time, at most %u ms late\n", sleep_max_late);
+
+    TEST_LOG_TEST("PASS - sleep queue test succeeded\n");
+}
+static volatile uint32_t switch_last;     /* pid of the thread that yielded last */
+static volatile uint32_t switch_misses;   /* yields that came back without the other thread running */
+static volatile uint32_t switch_done;
+static uint64_t switch_start_tsc;
+static uint64_t switch_end_tsc;
+
+/* two of these at the same priority hand the cpu to each other on every yield */
+static void switch_yielder_main(void)
+{
+    uint32_t self = scheduler_get_current_process()->pid;
+
+    if (switch_start_tsc == 0)
+        switch_start_tsc = timer_read_tsc();
+
+    for (uint32_t i = 0; i < SWITCH_ROUNDS; i++) {
+        switch_last = self;
+        scheduler_schedule();
+
+        if (switch_last == self)
+            switch_misses++;
+    }
+
+    uint32_t eflags = irq_save();
+    if (++switch_done == 2)
+        switch_end_tsc = timer_read_tsc();
+    irq_restore(eflags);
+}
+
+void scheduler_test_bench_switch(void)
+{
+    TEST_LOG_TEST("Context switch benchmark start (%u yields per thread)\n", SWITCH_ROUNDS);
+
+    switch_last = 0;
+    switch_misses = 0;
+    switch_done = 0;
+    switch_start_tsc = 0;
+    switch_end_tsc = 0;
+
+    /* a long slice so neither thread sinks a level mid run and starts keeping the cpu on its yields */
+    uint32_t quantum_ms = scheduler_get_quantum_ms();
+    scheduler_set_quantum_ms(SCHEDULER_BOOST_MS);
+
+    TEST_LOG_STEP("Two threads yielding to each other\n");
+    for (uint32_t i = 0; i < 2; i++) {
+        process_t *p = process_create(PROCESS_KERNEL, switch_yielder_main, 0x2000);
+        if (!p) {
+            TEST_LOG_ERR("process_create failed\n");
+            scheduler_set_quantum_ms(quantum_ms);
+            return;
+        }
+        scheduler_add_process_to_ready_queue(p);
+    }
+    scheduler_set_on();
+
+    while (switch_done < 2)
+        __asm__ __volatile__("hlt");
+
+    scheduler_set_quantum_ms(quantum_ms);
+
+    uint32_t switches = 2 * SWITCH_ROUNDS - switch_misses;
+    if (switches < SWITCH_ROUNDS) {
+        TEST_LOG_ERR("Only %u of %u yields switched threads\n", switches, 2 * SWITCH_ROUNDS);
+        return;
+    }
+
+    /* every switch is a full round trip: int, frame save, pick, frame restore, iret */
+    uint32_t cycles = (uint32_t)(switch_end_tsc - switch_start_tsc);
+    TEST_LOG_OK("%u switches, %u cycles per yield and switch\n", switches, cycles / switches);
+    if (switch_misses != 0)
+        TEST_LOG_INFO("%u yields kept the cpu (the other thread was done)\n", switch_misses);
+
+    TEST_LOG_TEST("PASS - context switch benchmark finished\n");
+}
\ No newline at end of file
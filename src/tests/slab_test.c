@@ -0,0 +1,70 @@
+#include "tests/test_log.h"
+#include "mm/slab.h"
+#include "utils/utils.h"
+
+void slab_test_basic(void)
+{
+    enum { COUNT = 100, SIZE = 72 };
+
+    uint8_t *ptrs[COUNT];
+
+    TEST_LOG_TEST("Slab basic test start\n");
+
+    TEST_LOG_STEP("Creating a cache of %u byte objects\n", SIZE);
+    kmem_cache_t *cache = kmem_cache_create("slab test", SIZE);
+    if (!cache) {
+        TEST_LOG_ERR("kmem_cache_create returned NULL\n");
+        return;
+    }
+    TEST_LOG_OK("Cache created, %u objects per slab\n", cache->objects_per_slab);
+
+    TEST_LOG_STEP("Allocating %u objects (more than one slab)\n", COUNT);
+    for (uint32_t i = 0; i < COUNT; i++) {
+        ptrs[i] = (uint8_t *)kmem_cache_alloc(cache);
+        if (!ptrs[i]) {
+            TEST_LOG_ERR("kmem_cache_alloc failed at index=%u\n", i);
+            return;
+        }
+
+        memset(ptrs[i], (uint8_t)i, SIZE);
+    }
+    TEST_LOG_OK("All objects allocated\n");
+
+    TEST_LOG_STEP("Verifying objects do not overlap\n");
+    for (uint32_t i = 0; i < COUNT; i++) {
+        for (uint32_t b = 0; b < SIZE; b++) {
+            if (ptrs[i][b] != (uint8_t)i) {
+                TEST_LOG_ERR("Object %u corrupted at byte %u\n", i, b);
+                return;
+            }
+        }
+    }
+    TEST_LOG_OK("All objects verified\n");
+
+    TEST_LOG_STEP("Freeing every other object and reallocating\n");
+    for (uint32_t i = 0; i < COUNT; i += 2)
+        kmem_cache_free(cache, ptrs[i]);
+
+    for (uint32_t i = 0; i < COUNT; i += 2) {
+        ptrs[i] = (uint8_t *)kmem_cache_alloc(cache);
+        if (!ptrs[i]) {
+            TEST_LOG_ERR("kmem_cache_alloc failed on reuse at index=%u\n", i);
+            return;
+        }
+    }
+
+    if (cache->objects_in_use != COUNT) {
+        TEST_LOG_ERR("Wrong objects_in_use=%u expected=%u\n", cache->objects_in_use, COUNT);
+        return;
+    }
+    TEST_LOG_OK("Freed objects reused\n");
+
+    TEST_LOG_STEP("Freeing all objects and destroying the cache\n");
+    for (uint32_t i = 0; i < COUNT; i++)
+        kmem_cache_free(cache, ptrs[i]);
+
+    kmem_cache_destroy(cache);
+    TEST_LOG_OK("Cache destroyed\n");
+
+    TEST_LOG_TEST("PASS - Slab basic test succeeded\n");
+}
\ No newline at end of file
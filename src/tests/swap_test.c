@@ -0,0 +1,191 @@
+#include "tests/test_log.h"
+#include "kernel/syscall.h"
+#include "kernel/timer.h"
+#include "mm/paging.h"
+#include "mm/pmm.h"
+#include "mm/swap.h"
+#include "multitasking/lock.h"
+#include "multitasking/scheduler.h"
+
+#define SWAP_TEST_PAGES 64
+#define SWAP_BUSY_SECTORS 8
+
+#define SWAP_PATTERN(page, word) ((page) * 0x01010101u ^ (word))
+
+void swap_test_roundtrip(void)
+{
+    TEST_LOG_TEST("Swap round trip test start\n");
+
+    if (!swap_enabled()) {
+        TEST_LOG_WARN("No swap area, skipping\n");
+        return;
+    }
+
+    uint32_t *map = (uint32_t *)mmap(NULL, SWAP_TEST_PAGES * PAGE_SIZE, PPROT_READ | PPROT_WRITE);
+    if (!map) {
+        TEST_LOG_ERR("mmap returned NULL\n");
+        return;
+    }
+
+    TEST_LOG_STEP("Writing %u anonymous pages\n", SWAP_TEST_PAGES);
+    for (uint32_t p = 0; p < SWAP_TEST_PAGES; p++)
+        for (uint32_t w = 0; w < PAGE_SIZE / sizeof(uint32_t); w += 64)
+            map[p * PAGE_SIZE / sizeof(uint32_t) + w] = SWAP_PATTERN(p, w);
+
+    TEST_LOG_STEP("Pushing them out to the swap area\n");
+    uint32_t free_before = pmm_get_free_frames_count();
+    uint32_t slots_before = swap_used_slots();
+    uint32_t ram_before = swap_used_ram_slots();
+
+    uint64_t start = timer_read_tsc();
+    uint32_t reclaimed = swap_reclaim(SWAP_TEST_PAGES);
+    uint32_t out_cycles = (uint32_t)(timer_read_tsc() - start);
+
+    if (reclaimed != SWAP_TEST_PAGES || swap_used_slots() - slots_before != SWAP_TEST_PAGES ||
+        pmm_get_free_frames_count() - free_before != SWAP_TEST_PAGES) {
+        TEST_LOG_ERR("Reclaimed %u pages, %u slots used, %u frames freed\n", reclaimed,
+                     swap_used_slots() - slots_before, pmm_get_free_frames_count() - free_before);
+        munmap(map, SWAP_TEST_PAGES * PAGE_SIZE);
+        return;
+    }
+    if (paging_get_mapping(map) != NULL) {
+        TEST_LOG_ERR("A swapped out page is still mapped\n");
+        munmap(map, SWAP_TEST_PAGES * PAGE_SIZE);
+        return;
+    }
+    TEST_LOG_OK("%u pages swapped out\n", reclaimed);
+
+    /* high memory is the first tier, the disk only takes what does not fit */
+    uint32_t ram_free = swap_ram_slots() - ram_before;
+    uint32_t ram_expected = ram_free < SWAP_TEST_PAGES ? ram_free : SWAP_TEST_PAGES;
+    if (swap_used_ram_slots() - ram_before != ram_expected) {
+        TEST_LOG_ERR("%u pages went to high memory, expected %u\n", swap_used_ram_slots() - ram_before, ram_expected);
+        munmap(map, SWAP_TEST_PAGES * PAGE_SIZE);
+        return;
+    }
+    TEST_LOG_INFO("%u pages in high memory, %u on disk\n", ram_expected, SWAP_TEST_PAGES - ram_expected);
+
+    TEST_LOG_STEP("Faulting them back in\n");
+    uint8_t intact = 1;
+    start = timer_read_tsc();
+    for (uint32_t p = 0; p < SWAP_TEST_PAGES; p++)
+        for (uint32_t w = 0; w < PAGE_SIZE / sizeof(uint32_t); w += 64)
+            if (map[p * PAGE_SIZE / sizeof(uint32_t) + w] != SWAP_PATTERN(p, w))
+                intact = 0;
+    uint32_t in_cycles = (uint32_t)(timer_read_tsc() - start);
+
+    if (!intact || swap_used_slots() != slots_before) {
+        TEST_LOG_ERR("Pages came back corrupted or slots were not released (%u used)\n", swap_used_slots());
+        munmap(map, SWAP_TEST_PAGES * PAGE_SIZE);
+        return;
+    }
+    TEST_LOG_OK("Every page came back intact\n");
+
+    TEST_LOG_STEP("Unmapping a range with swapped out pages\n");
+    swap_reclaim(SWAP_TEST_PAGES);
+    munmap(map, SWAP_TEST_PAGES * PAGE_SIZE);
+    if (swap_used_slots() != slots_before) {
+        TEST_LOG_ERR("%u slots leaked by munmap\n", swap_used_slots() - slots_before);
+        return;
+    }
+    TEST_LOG_OK("munmap released the slots\n");
+
+    TEST_LOG_INFO("swap out: ~%u cycles/page, swap in: ~%u cycles/page\n",
+                  out_cycles / SWAP_TEST_PAGES, in_cycles / SWAP_TEST_PAGES);
+    TEST_LOG_TEST("PASS - Swap round trip test succeeded\n");
+}
+
+static ata_drive_t *busy_drive;
+static uint8_t busy_buffer[SWAP_BUSY_SECTORS * ATA_SECTOR_SIZE];
+static volatile uint8_t busy_stop;
+static volatile uint8_t busy_running;
+static volatile uint32_t busy_requests;
+static volatile uint32_t busy_errors;
+
+/* keep the drive (and its lock) busy until told to stop */
+static void busy_reader_main(void)
+{
+    busy_running = 1;
+
+    while (!busy_stop) {
+        if (ata_read28_request(busy_drive, (busy_requests % 16) * SWAP_BUSY_SECTORS, SWAP_BUSY_SECTORS, busy_buffer) != ATA_OK)
+            busy_errors++;
+        busy_requests++;
+    }
+
+    busy_running = 0;
+}
+
+/* fault disk swapped pages in while another thread holds the drive, the fault has to wait for it with interrupts on */
+void swap_test_fault_during_drive_io(ata_drive_t *drive)
+{
+    TEST_LOG_TEST("Swap fault during drive I/O test start\n");
+
+    if (!swap_enabled() || !drive || !drive->exists) {
+        TEST_LOG_WARN("No swap area or drive, skipping\n");
+        return;
+    }
+
+    uint32_t *map = (uint32_t *)mmap(NULL, SWAP_TEST_PAGES * PAGE_SIZE, PPROT_READ | PPROT_WRITE);
+    if (!map) {
+        TEST_LOG_ERR("mmap returned NULL\n");
+        return;
+    }
+
+    for (uint32_t p = 0; p < SWAP_TEST_PAGES; p++)
+        for (uint32_t w = 0; w < PAGE_SIZE / sizeof(uint32_t); w += 64)
+            map[p * PAGE_SIZE / sizeof(uint32_t) + w] = SWAP_PATTERN(p, w);
+
+    uint32_t ram_before = swap_used_ram_slots();
+    uint32_t slots_before = swap_used_slots();
+    uint32_t reclaimed = swap_reclaim(SWAP_TEST_PAGES);
+    uint32_t on_disk = reclaimed - (swap_used_ram_slots() - ram_before);
+
+    if (on_disk == 0) {
+        TEST_LOG_WARN("Every page went to high memory, skipping\n");
+        munmap(map, SWAP_TEST_PAGES * PAGE_SIZE);
+        return;
+    }
+
+    TEST_LOG_STEP("Faulting %u disk swapped pages in while a thread keeps the drive busy\n", on_disk);
+    busy_drive = drive;
+    busy_stop = 0;
+    busy_requests = 0;
+    busy_errors = 0;
+
+    process_t *reader = process_create(PROCESS_KERNEL, busy_reader_main, 0x2000);
+    if (!reader) {
+        TEST_LOG_ERR("process_create failed\n");
+        munmap(map, SWAP_TEST_PAGES * PAGE_SIZE);
+        return;
+    }
+    scheduler_add_process_to_ready_queue(reader);
+    scheduler_set_on();
+
+    while (!busy_running)
+        __asm__ __volatile__("hlt");
+
+    uint32_t contentions = drive->lock.contentions;
+    uint8_t intact = 1;
+    for (uint32_t p = 0; p < SWAP_TEST_PAGES; p++)
+        for (uint32_t w = 0; w < PAGE_SIZE / sizeof(uint32_t); w += 64)
+            if (map[p * PAGE_SIZE / sizeof(uint32_t) + w] != SWAP_PATTERN(p, w))
+                intact = 0;
+    contentions = drive->lock.contentions - contentions;
+
+    busy_stop = 1;
+    while (busy_running)
+        __asm__ __volatile__("hlt");
+
+    munmap(map, SWAP_TEST_PAGES * PAGE_SIZE);
+
+    if (!intact || busy_errors != 0 || swap_used_slots() != slots_before) {
+        TEST_LOG_ERR("Pages intact: %u, %u reader errors, %u slots leaked\n", intact, busy_errors,
+                     swap_used_slots() - slots_before);
+        return;
+    }
+    TEST_LOG_OK("Every page came back intact, the drive was contended %u times\n", contentions);
+
+    TEST_LOG_INFO("%u reader requests went through meanwhile\n", busy_requests);
+    TEST_LOG_TEST("PASS - Swap fault during drive I/O test succeeded\n");
+}
\ No newline at end of file
@@ -0,0 +1,306 @@
+#include "tests/sync_test.h"
+#include "tests/test_log.h"
+#include "kernel/timer.h"
+#include "multitasking/lock.h"
+#include "multitasking/scheduler.h"
+#include "multitasking/sleep.h"
+#include "multitasking/sync.h"
+
+#define MUTEX_THREADS        4
+#define MUTEX_ROUNDS         2000
+#define MUTEX_HOLD_SPINS     2000  /* work done while holding the mutex, long enough for ticks to land inside */
+
+#define RING_SLOTS           8
+#define RING_VALUES          1000
+
+#define GATE_WAITERS         8
+
+#define CONTENTION_READERS   4
+#define CONTENTION_REQUESTS  64
+#define CONTENTION_SECTORS   8
+
+static void busy(uint32_t spins)
+{
+    for (volatile uint32_t i = 0; i < spins; i++)
+        ;
+}
+
+/* create and queue a kernel thread, 0 - process_create failed */
+static uint8_t spawn(void (*entry)(void))
+{
+    process_t *p = process_create(PROCESS_KERNEL, entry, 0x2000);
+    if (!p)
+        return 0;
+
+    scheduler_add_process_to_ready_queue(p);
+    return 1;
+}
+
+static volatile uint32_t threads_done;
+
+static void thread_done(void)
+{
+    uint32_t eflags = irq_save();
+    threads_done++;
+    irq_restore(eflags);
+}
+
+static mutex_t counter_mutex;
+static volatile uint32_t counter;
+
+/* a read-modify-write that loses updates unless the mutex excludes the other threads */
+static void counter_main(void)
+{
+    for (uint32_t i = 0; i < MUTEX_ROUNDS; i++) {
+        mutex_lock(&counter_mutex);
+        uint32_t value = counter;
+        busy(MUTEX_HOLD_SPINS);
+        counter = value + 1;
+        mutex_unlock(&counter_mutex);
+    }
+
+    thread_done();
+}
+
+static mutex_t ring_mutex;
+static semaphore_t ring_free;
+static semaphore_t ring_used;
+static uint32_t ring[RING_SLOTS];
+static uint32_t ring_head;
+static uint32_t ring_tail;
+static uint32_t ring_sum;
+
+static void producer_main(void)
+{
+    for (uint32_t value = 1; value <= RING_VALUES; value++) {
+        semaphore_down(&ring_free);
+        mutex_lock(&ring_mutex);
+        ring[ring_tail++ % RING_SLOTS] = value;
+        mutex_unlock(&ring_mutex);
+        semaphore_up(&ring_used);
+    }
+
+    thread_done();
+}
+
+static void consumer_main(void)
+{
+    for (uint32_t i = 0; i < RING_VALUES; i++) {
+        semaphore_down(&ring_used);
+        mutex_lock(&ring_mutex);
+        ring_sum += ring[ring_head++ % RING_SLOTS];
+        mutex_unlock(&ring_mutex);
+        semaphore_up(&ring_free);
+    }
+
+    thread_done();
+}
+
+static mutex_t gate_mutex;
+static condvar_t gate_opened;
+static uint8_t gate_open;
+static uint32_t gate_waiting;
+static uint32_t gate_passed;
+
+static void gate_waiter_main(void)
+{
+    mutex_lock(&gate_mutex);
+    gate_waiting++;
+    while (!gate_open)
+        condvar_wait(&gate_opened, &gate_mutex);
+    gate_passed++;
+    mutex_unlock(&gate_mutex);
+
+    thread_done();
+}
+
+static void gate_opener_main(void)
+{
+    /* open only once every waiter is asleep on the condvar */
+    for (;;) {
+        mutex_lock(&gate_mutex);
+        if (gate_waiting == GATE_WAITERS)
+            break;
+        mutex_unlock(&gate_mutex);
+        ksleep_ms(1);
+    }
+
+    gate_open = 1;
+    condvar_broadcast(&gate_opened);
+    mutex_unlock(&gate_mutex);
+
+    thread_done();
+}
+
+void sync_test_primitives(void)
+{
+    uint32_t threads = MUTEX_THREADS + 2 + GATE_WAITERS + 1;
+
+    TEST_LOG_TEST("Sync primitives test start\n");
+
+    threads_done = 0;
+    counter = 0;
+    ring_head = ring_tail = ring_sum = 0;
+    gate_open = 0;
+    gate_waiting = gate_passed = 0;
+
+    mutex_init(&counter_mutex);
+    mutex_init(&ring_mutex);
+    semaphore_init(&ring_free, RING_SLOTS);
+    semaphore_init(&ring_used, 0);
+    mutex_init(&gate_mutex);
+    condvar_init(&gate_opened);
+
+    TEST_LOG_STEP("Running %u mutex, 2 semaphore and %u condvar threads\n", MUTEX_THREADS, GATE_WAITERS + 1);
+    for (uint32_t i = 0; i < MUTEX_THREADS; i++)
+        if (!spawn(counter_main))
+            goto create_failed;
+    if (!spawn(producer_main) || !spawn(consumer_main))
+        goto create_failed;
+    for (uint32_t i = 0; i < GATE_WAITERS; i++)
+        if (!spawn(gate_waiter_main))
+            goto create_failed;
+    if (!spawn(gate_opener_main))
+        goto create_failed;
+    scheduler_set_on();
+
+    while (threads_done < threads)
+        __asm__ __volatile__("hlt");
+
+    if (counter != MUTEX_THREADS * MUTEX_ROUNDS) {
+        TEST_LOG_ERR("Counter is %u, expected %u\n", counter, MUTEX_THREADS * MUTEX_ROUNDS);
+        return;
+    }
+    TEST_LOG_OK("No update lost, %u contended locks, %u of them slept\n",
+                counter_mutex.contentions, counter_mutex.sleeps);
+
+    if (ring_sum != RING_VALUES * (RING_VALUES + 1) / 2 || ring_free.count != RING_SLOTS || ring_used.count != 0) {
+        TEST_LOG_ERR("Ring sum %u, expected %u\n", ring_sum, RING_VALUES * (RING_VALUES + 1) / 2);
+        return;
+    }
+    TEST_LOG_OK("Every value went through the bounded buffer once\n");
+
+    if (gate_passed != GATE_WAITERS) {
+        TEST_LOG_ERR("%u of %u waiters passed the gate\n", gate_passed, GATE_WAITERS);
+        return;
+    }
+    TEST_LOG_OK("Broadcast woke all %u waiters\n", GATE_WAITERS);
+
+    TEST_LOG_TEST("PASS - sync primitives test succeeded\n");
+    return;
+
+create_failed:
+    TEST_LOG_ERR("process_create failed\n");
+}
+
+static ata_drive_t *contention_drive;
+static uint8_t contention_buffers[CONTENTION_READERS][CONTENTION_SECTORS * ATA_SECTOR_SIZE];
+static volatile uint32_t contention_next_reader;
+static volatile uint32_t contention_readers_done;
+static volatile uint32_t contention_errors;
+static volatile uint32_t contention_work;
+
+static void contention_reader_main(void)
+{
+    uint32_t eflags = irq_save();
+    uint32_t reader = contention_next_reader++;
+    irq_restore(eflags);
+
+    for (uint32_t i = 0; i < CONTENTION_REQUESTS; i++) {
+        uint32_t sector = ((reader + i) % 16) * CONTENTION_SECTORS;
+
+        if (ata_read28_request(contention_drive, sector, CONTENTION_SECTORS, contention_buffers[reader]) != ATA_OK)
+            contention_errors++;
+    }
+
+    eflags = irq_save();
+    contention_readers_done++;
+    irq_restore(eflags);
+
+    thread_done();
+}
+
+/* cpu bound, measures how much of the cpu the readers leave to the rest of the system */
+static void contention_worker_main(void)
+{
+    while (contention_readers_done < CONTENTION_READERS) {
+        busy(64);
+        contention_work++;
+    }
+
+    thread_done();
+}
+
+/* returns the worker iterations per ms, 0 on failure */
+static uint32_t contention_run(const char *name, mutex_mode_e mode)
+{
+    mutex_t *lock = &contention_drive->lock;
+
+    mutex_set_mode(lock, mode);
+    uint32_t contentions = lock->contentions;
+    uint32_t sleeps = lock->sleeps;
+
+    threads_done = 0;
+    contention_next_reader = 0;
+    contention_readers_done = 0;
+    contention_errors = 0;
+    contention_work = 0;
+
+    uint32_t start = timer_time_ms();
+
+    for (uint32_t i = 0; i < CONTENTION_READERS; i++)
+        if (!spawn(contention_reader_main))
+            return 0;
+    if (!spawn(contention_worker_main))
+        return 0;
+    scheduler_set_on();
+
+    while (threads_done < CONTENTION_READERS + 1)
+        __asm__ __volatile__("hlt");
+
+    uint32_t elapsed = timer_time_ms() - start;
+    if (elapsed == 0)
+        elapsed = 1;
+
+    if (contention_errors != 0) {
+        TEST_LOG_ERR("%s: %u requests failed\n", name, contention_errors);
+        return 0;
+    }
+
+    TEST_LOG_INFO("%s: %u ms, worker %u iterations/ms, %u contended, %u slept\n", name, elapsed,
+                  contention_work / elapsed, lock->contentions - contentions, lock->sleeps - sleeps);
+
+    return contention_work / elapsed == 0 ? 1 : contention_work / elapsed;
+}
+
+void sync_test_bench_contention(ata_drive_t *drive)
+{
+    TEST_LOG_TEST("Drive lock contention benchmark start (%u readers, %u x %u sectors each)\n",
+                  CONTENTION_READERS, CONTENTION_REQUESTS, CONTENTION_SECTORS);
+
+    if (!drive || !drive->exists) {
+        TEST_LOG_WARN("No drive, skipping\n");
+        return;
+    }
+    contention_drive = drive;
+
+    TEST_LOG_STEP("Readers plus a cpu bound worker with every lock mode\n");
+    uint32_t spin = contention_run("spin", MUTEX_SPIN);
+    uint32_t sleep = spin ? contention_run("sleep", MUTEX_SLEEP) : 0;
+    uint32_t adaptive = sleep ? contention_run("adaptive", MUTEX_ADAPTIVE) : 0;
+
+    mutex_set_mode(&drive->lock, MUTEX_SLEEP);
+
+    if (!adaptive) {
+        TEST_LOG_ERR("A benchmark run failed\n");
+        return;
+    }
+
+    /* spinning readers burn their slices waiting for a preempted owner, sleeping ones leave the cpu to the worker */
+    if (sleep < spin)
+        TEST_LOG_WARN("The worker got less cpu with sleeping waiters than with spinning ones\n");
+    else
+        TEST_LOG_OK("Sleeping waiters left the worker %u%% of its spin mode share\n", sleep * 100 / spin);
+
+    TEST_LOG_TEST("PASS - drive lock contention benchmark finished\n");
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "tests/test_log.h"
+#include "kernel/timer.h"
+#include "mm/kheap.h"
+#include "mm/paging.h"
+#include "mm/pmm.h"
+#include "mm/vmalloc.h"
+#include "utils/utils.h"
+
+#define BIG_SIZE     0x40000  /* 256 KiB, well above KHEAP_VMALLOC_THRESHOLD */
+#define ROUNDS       32
+
+void vmalloc_test_basic(void)
+{
+    TEST_LOG_TEST("vmalloc test start\n");
+
+    size_t used_before = vmalloc_used_size();  /* process stacks live there too */
+    size_t committed_before = kheap_committed_size();
+
+    TEST_LOG_STEP("kalloc of %u KiB goes to vmalloc\n", BIG_SIZE / 1024);
+    uint8_t *big = (uint8_t *)kalloc(BIG_SIZE);
+    if (!big) {
+        TEST_LOG_ERR("kalloc(%u) returned NULL\n", BIG_SIZE);
+        return;
+    }
+    if (!is_vmalloc_addr(big) || ((uint32_t)big & (PAGE_SIZE - 1)) || kheap_committed_size() != committed_before) {
+        TEST_LOG_ERR("Large kalloc was not routed to vmalloc (%p)\n", big);
+        kfree(big);
+        return;
+    }
+    memset(big, 0xA5, BIG_SIZE);
+    for (uint32_t i = 0; i < BIG_SIZE; i += PAGE_SIZE) {
+        if (big[i] != 0xA5 || big[i + PAGE_SIZE - 1] != 0xA5) {
+            TEST_LOG_ERR("Page %u of the buffer lost its data\n", i / PAGE_SIZE);
+            kfree(big);
+            return;
+        }
+    }
+    kfree(big);
+    TEST_LOG_OK("Routed to %p and freed through kfree\n", big);
+
+    TEST_LOG_STEP("Guard pages around an area\n");
+    uint8_t *guarded = (uint8_t *)vmalloc_flags(3 * PAGE_SIZE, VMALLOC_GUARD);
+    if (!guarded) {
+        TEST_LOG_ERR("vmalloc_flags returned NULL\n");
+        return;
+    }
+    if (paging_get_mapping(guarded - PAGE_SIZE) != NULL || paging_get_mapping(guarded + 3 * PAGE_SIZE) != NULL ||
+        paging_get_mapping(guarded) == NULL) {
+        TEST_LOG_ERR("Guard pages are mapped or the area is not\n");
+        vfree(guarded);
+        return;
+    }
+    vfree(guarded);
+    TEST_LOG_OK("Both neighbours of the area are unmapped\n");
+
+    TEST_LOG_STEP("Timing %u large allocations through the heap and through vmalloc\n", ROUNDS);
+    uint64_t start = timer_read_tsc();
+    for (uint32_t i = 0; i < ROUNDS; i++)
+        kfree(kalloc_heap(BIG_SIZE));
+    uint32_t heap_cycles = (uint32_t)(timer_read_tsc() - start);
+
+    uint32_t free_before = pmm_get_free_frames_count();
+    start = timer_read_tsc();
+    for (uint32_t i = 0; i < ROUNDS; i++)
+        vfree(vmalloc(BIG_SIZE));
+    uint32_t vmalloc_cycles = (uint32_t)(timer_read_tsc() - start);
+
+    if (vmalloc_used_size() != used_before || pmm_get_free_frames_count() != free_before) {
+        TEST_LOG_ERR("%u bytes still in vmalloc, %u frames leaked\n",
+                     vmalloc_used_size() - used_before, free_before - pmm_get_free_frames_count());
+        return;
+    }
+
+    TEST_LOG_INFO("%u KiB alloc+free: %u cycles from the heap, %u cycles from vmalloc\n",
+                  BIG_SIZE / 1024, heap_cycles / ROUNDS, vmalloc_cycles / ROUNDS);
+    TEST_LOG_TEST("PASS - vmalloc test succeeded\n");
+}
\ No newline at end of file